@@ -0,0 +1,321 @@
+#include <bits/stdc++.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+using namespace std;
+
+// hash_open_addressing_test_ans.cpp 의 개방 주소법을 템플릿 클래스로 만든 버전
+// 1. 상태(status) 배열 대신 1바이트 제어(ctrl) 배열을 따로 둠
+//    EMPTY / DELETED(=DUMMY) 는 최상위 비트가 1, 사용 중인 칸은 해시 하위 7비트(h2)를 저장
+//    → 칸 16개의 ctrl 을 SSE2 로 한 번에 비교해서 h2 가 같은 칸만 실제 키를 비교함
+// 2. (원소 + 묘비) 수가 용량의 7/8 을 넘으면 재해시. 원소가 적으면 같은 크기로, 많으면 2배로
+// 3. 재해시 때는 살아 있는 원소만 옮기므로 묘비(DELETED)가 전부 사라짐
+//    (원래 코드는 M 이 고정이라 erase 를 많이 하면 find 가 DUMMY 를 계속 지나가야 함)
+
+const int8_t CTRL_EMPTY = -128;  // 0b10000000
+const int8_t CTRL_DELETED = -2;  // 0b11111110
+const int GROUP = 16;
+
+template<class K, class V, class Hash = hash<K>>
+class flat_hash_map{
+public:
+  flat_hash_map(){ rehash(GROUP); }
+
+  size_t size() const { return sz; }
+  size_t capacity() const { return cap; }
+
+  // k 에 대응되는 값의 주소를 반환, 만약 k가 존재하지 않을 경우 nullptr 을 반환
+  V* find(const K& k){
+    int idx = find_index(k, hash_of(k));
+    return idx == -1 ? nullptr : &val[idx];
+  }
+
+  void insert(const K& k, const V& v){
+    size_t h = hash_of(k);
+    int idx = find_index(k, h);
+    if(idx != -1){
+      val[idx] = v;
+      return;
+    }
+    if((sz + tomb + 1) * 8 > cap * 7){
+      // 묘비를 치우는 것만으로 충분하면 크기 유지
+      rehash(sz * 16 < cap * 7 ? cap : cap * 2);
+    }
+    idx = find_free(h);
+    if(ctrl[idx] == CTRL_DELETED) tomb--;
+    set_ctrl(idx, h2(h));
+    key[idx] = k;
+    val[idx] = v;
+    sz++;
+  }
+
+  bool erase(const K& k){
+    int idx = find_index(k, hash_of(k));
+    if(idx == -1) return false;
+    set_ctrl(idx, CTRL_DELETED);
+    key[idx] = K();
+    val[idx] = V();
+    sz--;
+    tomb++;
+    return true;
+  }
+
+private:
+  // ctrl 은 cap + GROUP 바이트. 뒤쪽 GROUP 바이트는 앞쪽 GROUP 바이트의 복사본이라
+  // 어느 위치에서 시작해도 16바이트를 끊김 없이 읽을 수 있음
+  vector<int8_t> ctrl;
+  vector<K> key;
+  vector<V> val;
+  size_t cap = 0, mask = 0;
+  size_t sz = 0, tomb = 0;
+
+  size_t hash_of(const K& k) const {
+    // std::hash<int> 처럼 항등 함수인 경우가 있어서 한 번 섞음
+    unsigned long long h = Hash()(k);
+    h ^= h >> 32;
+    h *= 0x9E3779B97F4A7C15ULL;
+    return h ^ (h >> 29);
+  }
+  static int8_t h2(size_t h){ return h & 0x7F; }
+
+  void set_ctrl(size_t i, int8_t c){
+    ctrl[i] = c;
+    if(i < GROUP) ctrl[cap + i] = c;
+  }
+
+  // pos 부터 16칸 중 ctrl == c 인 칸들의 비트마스크
+  unsigned match(size_t pos, int8_t c) const {
+#ifdef __SSE2__
+    __m128i g = _mm_loadu_si128((const __m128i*)&ctrl[pos]);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8(c)));
+#else
+    unsigned m = 0;
+    for(int i = 0; i < GROUP; i++) if(ctrl[pos + i] == c) m |= 1u << i;
+    return m;
+#endif
+  }
+  // EMPTY 또는 DELETED (최상위 비트가 1인 칸)
+  unsigned match_free(size_t pos) const {
+#ifdef __SSE2__
+    return _mm_movemask_epi8(_mm_loadu_si128((const __m128i*)&ctrl[pos]));
+#else
+    unsigned m = 0;
+    for(int i = 0; i < GROUP; i++) if(ctrl[pos + i] < 0) m |= 1u << i;
+    return m;
+#endif
+  }
+
+  // 16칸씩 건너뛰는 간격을 16, 32, 48, ... 로 늘림 (삼각수 탐사)
+  // cap 이 2의 거듭제곱이라 모든 칸을 한 번씩 보게 됨
+  int find_index(const K& k, size_t h) const {
+    size_t pos = (h >> 7) & mask;
+    for(size_t step = GROUP; ; step += GROUP){
+      for(unsigned m = match(pos, h2(h)); m; m &= m - 1){
+        size_t idx = (pos + __builtin_ctz(m)) & mask;
+        if(key[idx] == k) return idx;
+      }
+      if(match(pos, CTRL_EMPTY)) return -1;
+      pos = (pos + step) & mask;
+    }
+  }
+
+  int find_free(size_t h) const {
+    size_t pos = (h >> 7) & mask;
+    for(size_t step = GROUP; ; step += GROUP){
+      unsigned m = match_free(pos);
+      if(m) return (pos + __builtin_ctz(m)) & mask;
+      pos = (pos + step) & mask;
+    }
+  }
+
+  void rehash(size_t ncap){
+    vector<int8_t> octrl(ncap + GROUP, CTRL_EMPTY);
+    vector<K> okey(ncap);
+    vector<V> oval(ncap);
+    swap(ctrl, octrl); swap(key, okey); swap(val, oval);
+    size_t ocap = cap;
+    cap = ncap; mask = ncap - 1;
+    tomb = 0;
+    for(size_t i = 0; i < ocap; i++){
+      if(octrl[i] < 0) continue;  // EMPTY, DELETED 는 버림
+      size_t h = hash_of(okey[i]);
+      int idx = find_free(h);
+      set_ctrl(idx, h2(h));
+      key[idx] = move(okey[i]);
+      val[idx] = move(oval[i]);
+    }
+  }
+};
+
+void test(){
+  flat_hash_map<string, int> m;
+  m.insert("orange", 724); // ("orange", 724)
+  m.insert("melon", 20); // ("orange", 724), ("melon", 20)
+  assert(*m.find("melon") == 20);
+  m.insert("banana", 52); // ("orange", 724), ("melon", 20), ("banana", 52)
+  m.insert("cherry", 27); // ("orange", 724), ("melon", 20), ("banana", 52), ("cherry", 27)
+  m.insert("orange", 100); // ("orange", 100), ("melon", 20), ("banana", 52), ("cherry", 27)
+  assert(*m.find("banana") == 52);
+  assert(*m.find("orange") == 100);
+  m.erase("wrong_fruit"); // ("orange", 100), ("melon", 20), ("banana", 52), ("cherry", 27)
+  m.erase("orange"); // ("melon", 20), ("banana", 52), ("cherry", 27)
+  assert(m.find("orange") == nullptr);
+  m.erase("orange"); // ("melon", 20), ("banana", 52), ("cherry", 27)
+  m.insert("orange", 15); // ("melon", 20), ("banana", 52), ("cherry", 27), ("orange", 15)
+  assert(*m.find("orange") == 15);
+  m.insert("apple", 36); // ("melon", 20), ("banana", 52), ("cherry", 27), ("orange", 15), ("apple", 36)
+  m.insert("lemon", 6); // ("melon", 20), ("banana", 52), ("cherry", 27), ("orange", 15), ("apple", 36), ("lemon", 6)
+  m.insert("orange", 701);  // ("melon", 20), ("banana", 52), ("cherry", 27), ("orange", 701), ("apple", 36), ("lemon", 6)
+  assert(*m.find("cherry") == 27);
+  m.erase("xxxxxxx");
+  assert(m.find("xxxxxxx") == nullptr);
+  assert(*m.find("apple") == 36);
+  assert(*m.find("melon") == 20);
+  assert(*m.find("banana") == 52);
+  assert(*m.find("cherry") == 27);
+  assert(*m.find("orange") == 701);
+  assert(*m.find("lemon") == 6);
+  assert(m.size() == 6);
+
+  // 정수 키, 여러 번 커지고 묘비가 쌓였다가 치워지는 경우를 std::map 과 비교
+  flat_hash_map<int, int> mi;
+  map<int, int> ref;
+  mt19937 rng(1);
+  for(int i = 0; i < 200000; i++){
+    int k = rng() % 5000, op = rng() % 3;
+    if(op == 0){ mi.insert(k, i); ref[k] = i; }
+    else if(op == 1){ assert(mi.erase(k) == (ref.erase(k) == 1)); }
+    else{
+      int* p = mi.find(k);
+      auto it = ref.find(k);
+      assert((p == nullptr) == (it == ref.end()));
+      if(p) assert(*p == it->second);
+    }
+  }
+  assert(mi.size() == ref.size());
+  cout << "good!\n";
+}
+
+// 벤치마크: test() 와 같은 비율로 연산을 섞음
+// (삽입 9 : 조회 13 : 삭제 4, 조회 13번 중 2번은 없는 키, 삭제 4번 중 2번은 없는 키)
+struct Op{ char type; int key; };
+
+vector<Op> make_ops(int n, int keys, unsigned seed){
+  mt19937 rng(seed);
+  vector<Op> ops(n);
+  for(auto& op : ops){
+    int r = rng() % 26;
+    op.key = rng() % keys;
+    if(r < 9) op.type = 'i';
+    else if(r < 22) op.type = r < 20 ? 'f' : 'F';  // F: 없는 키 조회
+    else op.type = r < 24 ? 'e' : 'E';             // E: 없는 키 삭제
+  }
+  return ops;
+}
+
+// 길이 5~10 의 서로 다른 소문자 문자열 n개
+vector<string> make_keys(int n, unsigned seed){
+  mt19937 rng(seed);
+  vector<string> keys;
+  set<string> seen;
+  while((int)keys.size() < n){
+    string s;
+    int len = 5 + rng() % 6;
+    for(int i = 0; i < len; i++) s += 'a' + rng() % 26;
+    if(seen.insert(s).second) keys.push_back(s);
+  }
+  return keys;
+}
+
+template<class F>
+double run_ms(F f){
+  auto t0 = chrono::steady_clock::now();
+  f();
+  return chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+}
+
+void bench(int n, int nkeys, int rounds){
+  vector<string> keys = make_keys(nkeys, 7);
+  vector<string> missing = make_keys(nkeys, 8);
+  for(auto& s : missing) s += '!';  // keys 와 절대 겹치지 않음
+  vector<Op> ops = make_ops(n, nkeys, 9);
+
+  // 결과가 같은지 보려고 조회한 값과 erase 성공 수를 모두 더함
+  long long sum_flat = 0, sum_std = 0;
+  double t_flat = run_ms([&]{
+    for(int r = 0; r < rounds; r++){
+      flat_hash_map<string, int> m;
+      for(int i = 0; i < n; i++){
+        const Op& op = ops[i];
+        if(op.type == 'i') m.insert(keys[op.key], i);
+        else if(op.type == 'f'){ int* p = m.find(keys[op.key]); sum_flat += p ? *p : -1; }
+        else if(op.type == 'F'){ sum_flat += m.find(missing[op.key]) ? 1 : 0; }
+        else if(op.type == 'e') sum_flat += m.erase(keys[op.key]);
+        else sum_flat += m.erase(missing[op.key]);
+      }
+    }
+  });
+  double t_std = run_ms([&]{
+    for(int r = 0; r < rounds; r++){
+      unordered_map<string, int> m;
+      for(int i = 0; i < n; i++){
+        const Op& op = ops[i];
+        if(op.type == 'i') m[keys[op.key]] = i;
+        else if(op.type == 'f'){ auto it = m.find(keys[op.key]); sum_std += it != m.end() ? it->second : -1; }
+        else if(op.type == 'F'){ sum_std += m.find(missing[op.key]) != m.end() ? 1 : 0; }
+        else if(op.type == 'e') sum_std += m.erase(keys[op.key]);
+        else sum_std += m.erase(missing[op.key]);
+      }
+    }
+  });
+  assert(sum_flat == sum_std);
+  double per = 1e6 / ((double)n * rounds);
+  cout << fixed << setprecision(1);
+  cout << "연산 " << n << "개, 키 " << nkeys << "개 x " << rounds << "회: flat_hash_map " << t_flat * per
+       << " ns/연산, unordered_map " << t_std * per << " ns/연산 (" << setprecision(2) << t_std / t_flat << "배)\n";
+}
+
+// 살아 있는 키 nkeys 개를 둔 채로 다른 키 삽입 → 삭제를 반복해서 묘비를 잔뜩 만든 뒤 조회
+// 원래 코드(M 고정)는 find 가 묘비를 전부 지나가야 하지만 여기서는 재해시 때 치워지므로
+// 같은 원소로 새로 만든 표와 조회 시간이 거의 같아야 함
+void bench_tombstone(int nkeys, int cycles){
+  vector<string> live = make_keys(nkeys, 11);
+  vector<string> churn = make_keys(nkeys * cycles, 12);
+  for(auto& s : churn) s += '#';
+  flat_hash_map<string, int> m, fresh;
+  unordered_map<string, int> s;
+  for(int i = 0; i < nkeys; i++){ m.insert(live[i], i); fresh.insert(live[i], i); s[live[i]] = i; }
+  double t_churn = run_ms([&]{
+    for(int c = 0; c < cycles; c++){
+      for(int i = 0; i < nkeys; i++) m.insert(churn[c * nkeys + i], i);
+      for(int i = 0; i < nkeys; i++) m.erase(churn[c * nkeys + i]);
+    }
+  });
+  double t_churn_std = run_ms([&]{
+    for(int c = 0; c < cycles; c++){
+      for(int i = 0; i < nkeys; i++) s[churn[c * nkeys + i]] = i;
+      for(int i = 0; i < nkeys; i++) s.erase(churn[c * nkeys + i]);
+    }
+  });
+  long long hit = 0;
+  auto lookup = [&](flat_hash_map<string, int>& t){
+    return run_ms([&]{
+      for(auto& k : live) hit += *t.find(k);
+      for(auto& k : churn) hit += t.find(k) != nullptr;
+    });
+  };
+  double t_find = lookup(m), t_fresh = lookup(fresh);
+  assert(hit == 2LL * nkeys * (nkeys - 1) / 2 && m.size() == (size_t)nkeys);
+  double per_op = 1e6 / (2.0 * churn.size()), per_find = 1e6 / (live.size() + churn.size());
+  cout << fixed << setprecision(1);
+  cout << "키 " << nkeys << "개 유지 + 삽입/삭제 " << cycles << "회 반복: flat " << t_churn * per_op << " / std "
+       << t_churn_std * per_op << " ns/연산, 이후 조회 " << t_find * per_find << " ns (새로 만든 표 "
+       << t_fresh * per_find << " ns), 용량 " << m.capacity() << " / " << fresh.capacity() << "\n";
+}
+
+int main(){
+  test();
+  bench(2000000, 1000, 5);     // 캐시에 다 들어가는 크기
+  bench(2000000, 200000, 2);   // 캐시보다 큰 크기
+  bench_tombstone(100000, 10);
+}
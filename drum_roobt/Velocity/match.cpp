@@ -1,4 +1,5 @@
 #include <bits/stdc++.h>
+#include "../common/text_reader.hpp"
 using namespace std;
 
 struct Seg {
@@ -11,65 +12,36 @@ struct Seg {
 
 // 세기 파일 로드 (헤더 허용, 공백/탭/콤마 혼용)
 bool loadSegments(const string& intensityFile, vector<Seg>& segs) {
-    ifstream fin(intensityFile);
-    if (!fin) return false;
+    TextReader fin(intensityFile);   // BOM/CRLF 는 리더에서 처리
+    if (!fin.is_open()) return false;
 
-    string line;
+    string_view line, toks[4];
     bool headerDone = false;
 
-    while (getline(fin, line)) {
+    while (fin.nextLine(line)) {
         // 1) 라인 트림
-        auto trim = [](const string& s) -> string {
-            auto issp = [](unsigned char c){ return std::isspace(c); };
-            auto b = find_if_not(s.begin(), s.end(), issp);
-            auto e = find_if_not(s.rbegin(), s.rend(), issp).base();
-            return (b >= e) ? string() : string(b, e);
-        };
-        line = trim(line);
+        line = trimView(line);
         if (line.empty()) continue;
 
-        // 2) 콤마→공백 치환 + 공백 파싱 (토큰화)
-        vector<string> toks;
-        {
-            string tmp = line;
-            for (char& c : tmp) if (c == ',') c = ' ';
-            istringstream iss(tmp);
-            string tok;
-            while (iss >> tok) toks.push_back(trim(tok)); // 토큰도 트림
-        }
-        if (toks.size() < 4) continue;
-
-        // 3) BOM 제거(첫 토큰에만 필요 시)
-        if (!toks[0].empty()
-            && (unsigned char)toks[0][0] == 0xEF
-            && toks[0].size() >= 3
-            && (unsigned char)toks[0][1] == 0xBB
-            && (unsigned char)toks[0][2] == 0xBF) {
-            toks[0].erase(0, 3);
-        }
+        // 2) 공백/탭/콤마 혼용 토큰화
+        if (splitFields(line, toks, 4) < 4) continue;
 
-        // 4) 헤더 스킵: 앞 두 칼럼이 숫자가 아니면 헤더로 간주
-        auto looksNumber = [](const string& s) {
-            if (s.empty()) return false;
-            char* endp = nullptr;
-            (void)strtod(s.c_str(), &endp);
-            return endp != s.c_str(); // 앞에서 숫자를 하나라도 읽었는지
-        };
+        // 3) 헤더 스킵: 앞 두 칼럼이 숫자가 아니면 헤더로 간주 (처음 한 번만)
         if (!headerDone && (!looksNumber(toks[0]) || !looksNumber(toks[1]))) {
             headerDone = true;
             continue;
         }
 
-        // 5) 파싱 + 반올림(세기 0~3 가정)
+        // 4) 파싱 + 반올림(세기 0~3 가정)
         Seg s{};
-        s.start      = stod(toks[0]);
-        s.end        = stod(toks[1]);
-        s.drum_avg   = (int)lround(stod(toks[2]));
-        s.cymbal_avg = (int)lround(stod(toks[3]));
+        double drum, cym;
+        if (!toDouble(toks[0], s.start) || !toDouble(toks[1], s.end) ||
+            !toDouble(toks[2], drum) || !toDouble(toks[3], cym)) continue;
+        s.drum_avg   = (int)lround(drum);
+        s.cymbal_avg = (int)lround(cym);
         segs.push_back(s);
         headerDone = true;
     }
-    fin.close();
 
     // 6) 구간 정렬
     sort(segs.begin(), segs.end(), [](const Seg& a, const Seg& b){
@@ -86,18 +58,12 @@ bool applyIntensityToScore(const vector<Seg>& segs,
     const string& scoreOut,
     bool mapTo357 = true)
 {
-    ifstream sin(scoreIn);
-    if (!sin) return false;
+    TextReader sin(scoreIn);
+    if (!sin.is_open()) return false;
     ofstream sout(scoreOut);
     if (!sout) return false;
 
     // ---- 로컬 유틸(전부 이 함수 안에) ----
-        auto trim = [](const string& s) -> string {
-        auto issp = [](unsigned char c){ return std::isspace(c); };
-        auto b = find_if_not(s.begin(), s.end(), issp);
-        auto e = find_if_not(s.rbegin(), s.rend(), issp).base();
-        return (b >= e) ? string() : string(b, e);
-    };
     size_t cursor = 0; // 전진 포인터
     auto findSeg = [&](double t) -> const Seg* {
     while (cursor < segs.size()) {
@@ -126,39 +92,32 @@ bool applyIntensityToScore(const vector<Seg>& segs,
     // --------------------------------------
 
     double accumTime = 0.0;
-    string line;
+    string_view line;
+    vector<string_view> toks(16);   // 줄마다 새로 만들지 않고 재사용
 
-    while (getline(sin, line)) {
-        string raw = trim(line);
+    while (sin.nextLine(line)) {
+        string_view raw = trimView(line);
         if (raw.empty()) { sout << "\n"; continue; }
 
-        // 콤마 → 공백 치환 + 공백/탭 파싱
-        vector<string> toks;
-        {
-            string tmp = raw;
-            for (char& c : tmp) if (c == ',') c = ' ';
-            istringstream iss(tmp);
-            string tok;
-            while (iss >> tok) toks.push_back(tok);
+        // 공백/탭/콤마 혼용 토큰화 (칸이 모자라면 늘려서 다시 나눔)
+        int n = splitFields(raw, toks.data(), (int)toks.size());
+        if (n > (int)toks.size()) {
+            toks.resize(n);
+            splitFields(raw, toks.data(), n);
         }
 
         // 최소 5컬럼(time R_inst L_inst R_vel L_vel) 아니면 원본 그대로 출력
-        if (toks.size() < 5) { sout << raw << "\n"; continue; }
+        if (n < 5) { sout << raw << "\n"; continue; }
 
         // time은 Δt로 가정(절대시간이면 아래 한 줄을 accumTime = dt; 로 변경)
         double dt;
-        try { dt = stod(toks[0]); }
-        catch(...) { sout << raw << "\n"; continue; }
+        if (!toDouble(toks[0], dt)) { sout << raw << "\n"; continue; }
         accumTime += dt; // ← 절대시간이면: accumTime = dt;
 
         // 필드 파싱
         int R_inst, L_inst, R_vel, L_vel;
-        try {
-        R_inst = stoi(toks[1]);
-        L_inst = stoi(toks[2]);
-        R_vel  = stoi(toks[3]);
-        L_vel  = stoi(toks[4]);
-        } catch(...) { sout << raw << "\n"; continue; }
+        if (!toInt(toks[1], R_inst) || !toInt(toks[2], L_inst) ||
+            !toInt(toks[3], R_vel) || !toInt(toks[4], L_vel)) { sout << raw << "\n"; continue; }
 
         // 구간 찾고 세기 적용
         if (!segs.empty()) {
@@ -175,11 +134,11 @@ bool applyIntensityToScore(const vector<Seg>& segs,
         }
 
         // 갱신 후 탭 구분으로 출력(추가 컬럼 보존)
-        toks[3] = to_string(R_vel);
-        toks[4] = to_string(L_vel);
-        for (size_t i = 0; i < toks.size(); ++i) {
+        for (int i = 0; i < n; ++i) {
             if (i) sout << "\t";
-            sout << toks[i];
+            if (i == 3) sout << R_vel;
+            else if (i == 4) sout << L_vel;
+            else sout << toks[i];
         }
         sout << "\n";
     }
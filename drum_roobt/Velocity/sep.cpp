@@ -4,6 +4,8 @@
 #include <string>
 #include <iomanip>
 
+#include "../common/text_reader.hpp"
+
 static inline bool isDrum(int inst) {
     // 1~4: 드럼, 10: 베이스(드럼)
     return (inst >= 1 && inst <= 4) || inst == 10;
@@ -27,7 +29,7 @@ int main() {
     if (dot != std::string::npos) outPath = inPath.substr(0, dot) + "_cd" + inPath.substr(dot);
     else outPath = inPath + "_cd.txt";
 
-    std::ifstream in(inPath);
+    TextReader in(inPath);
     if (!in.is_open()) {
         std::cerr << "[ERROR] 입력 파일 열기 실패: " << inPath << "\n";
         return 1;
@@ -41,17 +43,15 @@ int main() {
     // 헤더
     out << "time\tcymbal_vel\tdrum_vel\n";
 
-    std::string line;
+    std::string_view line, f[3];
     double t; int inst, vel;
 
-    while (std::getline(in, line)) {
+    while (in.nextLine(line)) {
         if (line.empty()) continue;
 
-        // 콤마 → 공백 변환(혼용 지원)
-        for (char &c : line) if (c == ',') c = ' ';
-
-        std::stringstream ss(line);
-        if (!(ss >> t >> inst >> vel)) continue; // 형식 불량 스킵
+        // 콤마/공백 혼용 지원
+        if (splitFields(line, f, 3) < 3) continue;
+        if (!toDouble(f[0], t) || !toInt(f[1], inst) || !toInt(f[2], vel)) continue; // 형식 불량 스킵
         if (t == -1) break;                      // 종료 신호
 
         int cym = 0, drum = 0;
@@ -0,0 +1,32 @@
+#pragma once
+
+// 드럼 키트 기하 정보 (midi_final, 검증/시뮬레이션 도구 공용)
+// 악기 번호: 1 스네어, 2 플로어탐, 3 미드탐, 4 하이탐, 5 하이햇, 6 라이드벨, 7 오른 크래시(라이드), 8 왼 크래시
+//           0 은 "악기 없음" (스틱 기본 위치)
+
+#include <cmath>
+
+struct Coord {
+    double x, y, z;
+};
+
+const int NUM_INST = 9;
+
+inline Coord drumXYZ[NUM_INST] = {
+    {0.0, 0.0, 0.0},
+    {-0.13, 0.52, 0.61}, {0.25, 0.50, 0.62}, {0.21, 0.67, 0.87},
+    {-0.05, 0.69, 0.83}, {-0.28, 0.60, 0.88}, {0.32, 0.71, 1.06},
+    {0.47, 0.52, 0.88}, {-0.06, 0.73, 1.06}
+};
+
+inline double dist(const Coord& a, const Coord& b) {
+    return std::sqrt(
+        (a.x - b.x)*(a.x - b.x) +
+        (a.y - b.y)*(a.y - b.y) +
+        (a.z - b.z)*(a.z - b.z)
+    );
+}
+
+inline bool isCrash(int inst) {
+    return inst == 7 || inst == 8;
+}
@@ -0,0 +1,496 @@
+#pragma once
+
+// 규칙 기반 손 배정 (midi_final.cpp 의 assignHandsToEvents 핵심부)
+//  - 한 이벤트의 배정은 HandState(직전 배정/마지막 타격 악기/손별 누적 시간)에만 의존
+//  - assignEvent() 한 번 = 원래 루프 한 바퀴
+//  - 긴 곡은 assignHandsParallel() 로 구간을 나눠 동시에 배정하고 경계 상태를 이어 붙임
+//    (결과는 직렬 실행과 비트 단위로 같음)
+
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <utility>
+
+#include "drum_kit.hpp"
+
+enum Hand { LEFT, RIGHT, SAME };
+
+struct FullEvent {
+    double time;
+    int inst1 = 0, inst2 = 0, bassHit = 0, hihat = 1;
+    int rightHand = 0, leftHand = 0;
+};
+
+struct HandState {
+    //직전 라인에 할당된 악기 0 포함
+    int prevRight = 1, prevLeft = 1;
+    //실제 마지막으로 친 악기
+    int prevRightNote = 1, prevLeftNote = 1;
+    double prevRightHit = 0, prevLeftHit = 0;
+};
+
+// 손별 누적 시간은 getPreferredHandByDistance 에서 0.6 으로 잘려서만 쓰이므로
+// 둘 다 0.6 이상이면 값이 달라도 이후 배정 결과는 같음
+const double HAND_TIME_CAP = 0.6;
+
+inline bool sameEffect(const HandState& a, const HandState& b) {
+    return a.prevRight == b.prevRight && a.prevLeft == b.prevLeft &&
+           a.prevRightNote == b.prevRightNote && a.prevLeftNote == b.prevLeftNote &&
+           std::min(a.prevRightHit, HAND_TIME_CAP) == std::min(b.prevRightHit, HAND_TIME_CAP) &&
+           std::min(a.prevLeftHit, HAND_TIME_CAP) == std::min(b.prevLeftHit, HAND_TIME_CAP);
+}
+
+// 디버깅 출력. 병렬 작업 스레드에서는 꺼둠 (출력이 섞이지 않도록)
+inline thread_local bool handLogEnabled = true;
+
+inline std::ostream& handLog() {
+    static thread_local std::ostream nullOut(nullptr);
+    return handLogEnabled ? std::cout : nullOut;
+}
+
+// 거리 판단에 쓰는 키트 좌표. 기본은 drumXYZ, 배치 최적화(kit_opt)는 스레드마다 후보 키트로 바꿔 끼움
+inline thread_local const Coord* activeKit = drumXYZ;
+
+inline Hand getPreferredHandByDistance(int instCurrent, int prevRightNote, int prevLeftNote, double prevRightHit, double prevLeftHit) {
+
+    Coord curr = activeKit[instCurrent];
+    Coord right = activeKit[prevRightNote];
+    Coord left = activeKit[prevLeftNote];
+
+    double dMax = 0.754;
+    double dRight = dist(curr, right);
+    double dLeft = dist(curr, left);
+    // 시간의 max값 0.6으로 고정
+    double real_tRight = std::min(prevRightHit, 0.6);
+    double real_tLeft  = std::min(prevLeftHit, 0.6);
+    double normRight = std::min(dRight / dMax, 1.0)*2;
+    double normLeft = std::min(dLeft / dMax, 1.0)*2;
+
+    double rScore = (real_tRight / 0.6) * (2 - normRight);
+    double lScore = (real_tLeft  / 0.6) * (2 - normLeft);
+
+    // 디버깅용 프린트문
+    handLog() << "\n[Hand 선택 판단]\n";
+    handLog() << " - instCurrent: " << instCurrent << "\n";
+    handLog() << " - prevRightNote: " << prevRightNote << ", prevLeftNote: " << prevLeftNote << "\n";
+    handLog() << " - 거리: right = " << dRight << ", left = " << dLeft << "\n";
+    handLog() << " - 시간누적: right = " << prevRightHit << ", left = " << prevLeftHit << "\n";
+    handLog() << " - 사용시간: right = " << real_tRight << ", left = " << real_tLeft << "\n";
+    handLog() << " - 정규화 거리: right = " << normRight << ", left = " << normLeft << "\n";
+    handLog() << " - 점수: rScore = " << rScore << ", lScore = " << lScore << "\n";
+
+    if (std::abs(rScore - lScore) < 1e-6) {
+        handLog() << " → 결과: SAME (유사한 점수)\n";
+        return SAME;
+    }
+
+    Hand chosen = (lScore <= rScore) ? RIGHT : LEFT;
+    handLog() << " → 선택된 손: " << (chosen == RIGHT ? "RIGHT" : "LEFT") << "\n";
+    return chosen;
+}
+
+inline std::pair<int, int> assignHandsByPosition(int inst1, int inst2) {
+    auto getSection = [](int inst) {
+        if (inst == 5) return 1;
+        if (inst == 1 || inst == 4 || inst == 8) return 2;
+        if (inst == 2 || inst == 3 || inst == 6) return 3;
+        if (inst == 7) return 4;
+        return 0; // unknown
+    };
+
+    auto getSectionOrder = [](int inst) {
+        // 낮을수록 왼쪽
+        if (inst == 8) return 1;
+        if (inst == 1) return 2;
+        if (inst == 4) return 3;
+        if (inst == 3) return 1;
+        if (inst == 2) return 2;
+        if (inst == 6) return 3;
+        return 0;
+    };
+
+    int sec1 = getSection(inst1);
+    int sec2 = getSection(inst2);
+
+    handLog() << "[섹션 손 분배 판단]\n";
+    handLog() << " - inst1: " << inst1 << " (섹션 " << sec1 << "), inst2: " << inst2 << " (섹션 " << sec2 << ")\n";
+
+    if (sec1 < sec2) {
+        handLog() << " → 서로 다른 섹션: inst1이 더 왼쪽 → 왼손 = " << inst1 << ", 오른손 = " << inst2 << "\n";
+        return {inst1, inst2};
+    } else if (sec2 < sec1) {
+        handLog() << " → 서로 다른 섹션: inst2가 더 왼쪽 → 왼손 = " << inst2 << ", 오른손 = " << inst1 << "\n";
+        return {inst2, inst1};
+    } else {
+        int order1 = getSectionOrder(inst1);
+        int order2 = getSectionOrder(inst2);
+        handLog() << " → 같은 섹션 내 비교: order1 = " << order1 << ", order2 = " << order2 << "\n";
+        if (order1 < order2) {
+            handLog() << "   → inst1이 더 왼쪽 → 왼손 = " << inst1 << ", 오른손 = " << inst2 << "\n";
+            return {inst1, inst2};
+        } else {
+            handLog() << "   → inst2가 더 왼쪽 → 왼손 = " << inst2 << ", 오른손 = " << inst1 << "\n";
+            return {inst2, inst1};
+        }
+    }
+}
+
+inline int zoneOf(int inst) {
+    if (inst == 0) return 0;          // 비어있음
+    if (inst == 5) return 1;          // 하이햇
+    if (inst == 8 || inst == 4 || inst == 1) return 2; // 크래시(8), 하이탐(4), 스네어(1)
+    if (inst == 2 || inst == 3 || inst == 6) return 3; // 플로어(2), 미드탐(3), 라이드벨(6)
+    if (inst == 7) return 4;          // 라이드(7)
+    return 3; // 정의 밖은 기본적으로 중앙-우측 계열로 가정
+}
+
+inline bool isCrossed(int rightInst, int leftInst) {
+    if (rightInst == 0 || leftInst == 0) return false;          // 한 손 비어있으면 꼬임 아님
+    if (rightInst == 5 && leftInst == 1) return false;          // 예외 허용(오른손 하이햇, 왼손 스네어)
+    int zr = zoneOf(rightInst);
+    int zl = zoneOf(leftInst);
+    return (zl > zr);
+}
+
+// 손 크로스 방지 함수
+inline void checkCross(int& rightHand, int& leftHand,
+                int prevRightNote, int prevLeftNote) {
+    handLog() << "    [CrossCheck] In RH=" << rightHand << " LH=" << leftHand
+              << " | lastR=" << prevRightNote << " lastL=" << prevLeftNote << "\n";
+
+    // 1) 양손 동시타 → 현재 프레임 내에서 교차 검사
+    if (rightHand && leftHand) {
+        int zr = zoneOf(rightHand), zl = zoneOf(leftHand);
+        handLog() << "    [Both] zone(LH)=" << zl << ", zone(RH)=" << zr << "\n";
+        if (isCrossed(rightHand, leftHand)) {
+            handLog() << "    [Both→Swap] LH(" << leftHand << ',' << zl
+                      << ") > RH(" << rightHand << ',' << zr << ") → Swap\n";
+            std::swap(rightHand, leftHand);
+            handLog() << "    [Both→After] RH=" << rightHand
+                      << " LH=" << leftHand << "\n";
+        }
+        return;
+    }
+
+    // 2) 단일타: RH만 있음 → 이전 왼손과 비교
+    if (rightHand && !leftHand) {
+        if (prevLeftNote && isCrossed(rightHand, prevLeftNote)) {
+            int zr = zoneOf(rightHand), zl = zoneOf(prevLeftNote);
+            handLog() << "    [Single RH] RH(" << rightHand << ',' << zr
+                      << ") vs lastL(" << prevLeftNote << ',' << zl << ") → LH 재배정\n";
+            leftHand = rightHand;
+            rightHand = 0;
+            handLog() << "    [Single RH→After] RH=" << rightHand
+                      << " LH=" << leftHand << "\n";
+        }
+        return;
+    }
+
+    // 3) 단일타: LH만 있음 → 이전 오른손과 비교
+    if (leftHand && !rightHand) {
+        if (prevRightNote && isCrossed(prevRightNote, leftHand)) {
+            int zr = zoneOf(prevRightNote), zl = zoneOf(leftHand);
+            handLog() << "    [Single LH] lastR(" << prevRightNote << ',' << zr
+                      << ") vs LH(" << leftHand << ',' << zl << ") → RH 재배정\n";
+            rightHand = leftHand;
+            leftHand = 0;
+            handLog() << "    [Single LH→After] RH=" << rightHand
+                      << " LH=" << leftHand << "\n";
+        }
+        return;
+    }
+
+    handLog() << "    [None] RH=0, LH=0 → skip\n";
+}
+
+// 이벤트 하나 배정 (e.inst1/inst2/time 입력 → e.rightHand/leftHand 출력), 상태 갱신
+inline void assignEvent(FullEvent& e, HandState& s) {
+    int &prevRight = s.prevRight, &prevLeft = s.prevLeft;
+    int &prevRightNote = s.prevRightNote, &prevLeftNote = s.prevLeftNote;
+    double &prevRightHit = s.prevRightHit, &prevLeftHit = s.prevLeftHit;
+
+    e.rightHand = 0;
+    e.leftHand = 0;
+
+    int inst1 = e.inst1, inst2 = e.inst2;
+    prevRightHit += e.time;
+    prevLeftHit += e.time;
+
+    handLog() << "[Time: " << e.time << "] inst1: " << inst1 << ", inst2: " << inst2
+              << " | PrevR: " << prevRight << ", PrevL: " << prevLeft
+              << " | RHit: " << prevRightHit << ", LHit: " << prevLeftHit << "\n";
+    
+    // //step 1 크러시가 있는지 확인 크러쉬가 있다면 
+    // if (inst1 == 8 || inst2 == 8) {
+    //     handLog() << "→ 크러시 처리 진입\n";
+    //     if(prevLeft == 2 || prevLeft == 3 || prevLeft == 6) {
+    //         e.rightHand = 7;
+    //         e.leftHand = (inst1 == 8) ? inst2 : inst1;
+    //     } else {
+    //         if (inst1 == 2 || inst1 == 3 || inst1 == 6 || inst2 == 2 || inst2 == 3 || inst2 == 6) {
+    //             e.rightHand = 7;
+    //             e.leftHand = (inst1 == 8) ? inst2 : inst1;
+    //         } else {
+    //             e.rightHand = 8;
+    //             e.leftHand = (inst1 == 8) ? inst2 : inst1;
+    //         }
+    //     }
+    // }
+    // //step 1-1 크러시가 있는지 확인 크러쉬가 있다면 
+    if(inst1 == 7 || inst1 == 8 || inst2 == 7 || inst2 == 8)
+    {
+        handLog() << "→ 크러시 처리 진입 1-1\n";
+        //양손연주라면
+        if (inst1 != 0 && inst2 != 0)
+            {
+                // 두 손 모두 크래시를 치는 경우 → 규칙적으로 inst1=7(오른 크래시), inst2=8(왼 크래시)로 고정
+                bool bothCrash = ((inst1 == 7 || inst1 == 8) && (inst2 == 7 || inst2 == 8));
+                if (bothCrash) {
+                    e.rightHand = 7; 
+                    e.leftHand  = 8;
+                }
+                else {
+                    // 두 손이 동시에 치지만 "둘 다 크래시가 아님" → 기존 위치 기반 손 배분 사용
+                    auto [left, right] = assignHandsByPosition(inst1, inst2);
+                    e.leftHand  = left;
+                    e.rightHand = right;
+                }
+            }
+            //한손 연주 라면
+            else
+            {
+                // 마지막으로 왼손으로 친게 3,2,7,6 중에 하나면 오른손으로 오른쪽 크러시 치기
+                if (prevLeftNote == 3 || prevLeftNote == 2 || prevLeftNote == 7 || prevLeftNote == 6) {
+                    e.leftHand  = 0;
+                    e.rightHand = 7;
+                } 
+                //아니라면 왼쪽 크러시를 사용할 예정
+                else {
+                    if (prevRightNote == 3 || prevRightNote == 2 || prevRightNote == 7 || prevRightNote == 6)
+                    {
+                        e.rightHand = 0;
+                        e.leftHand  = 8;
+                    }
+                    else
+                    {
+                        e.rightHand = 8;
+                        e.leftHand  = 0;
+                    }
+
+                }
+                // //이건 전에 친 악/기 섹션 비고 하는거 위에 방법을 쓰던 밑에 섹션비교방법을쓰던 하나만쓰기
+                // auto [left, right] = assignHandsByPosition(prevRightNote, prevLeftNote);
+                // // leftInstOfPair가 prevLeftNote라면 '왼손 위치가 더 왼쪽'이라는 뜻
+                // bool chooseLeft = (left == prevLeftNote);
+
+
+                // // 실제 출력 반영: 어느 슬롯이 비어있든 상관없이 8을 선택 손에 할당
+                // if (chooseLeft) {
+                //     e.leftHand  = 8;
+                //     e.rightHand = 0;
+                // } else {
+                //     e.rightHand = 8;
+                //     e.leftHand  = 0;
+                // }
+            }
+    }
+    // step 2 양손 연주인지 한손인지 구분 
+    else if (inst1 != 0 && inst2 != 0) {
+        handLog() << "→ 양손 처리 진입\n";
+        // 1번 S와 5번 H-H 을 같이 치는 경우 오른손으로 H-H 왼손으로 S 치도록 설정
+        if ((inst1 == 5 && inst2 == 1) || (inst1 == 1 && inst2 == 5)) 
+        {
+            e.leftHand = (inst1 == 5) ? inst2 : inst1;
+            e.rightHand = (inst1 == 5) ? inst1 : inst2;
+        }
+        // 위의 경우를 제외한 모든 경우 악기 위치 기반으로 손 분배 
+        else 
+        {
+            auto [left, right] = assignHandsByPosition(inst1,inst2);
+            e.leftHand = left;
+            e.rightHand = right;
+        }
+    }
+    // step 3 한손 연주시 처리 
+    else if (inst1 != 0) {
+        handLog() << "→ 한손 처리 진입\n";
+        // 이전에 쳤던 악기와 같은 악기가 감지된다면 짧은 시간에 타격해야 할 시 같은 손 유지 시간차이가 크다면 거리 기반 판단
+        if (inst1 == prevRight || inst1 == prevLeft) {
+            handLog() << "    - 이전 손과 같은 악기 감지\n";
+            if (e.time <= 0.1) {
+                handLog() << "    - 시간차 0.1 이하 → 같은 손 유지\n";
+                if(inst1 == prevRight)
+                {
+                    e.rightHand = inst1;
+                    e.leftHand = 0;
+                }
+                else
+                {
+                    e.rightHand = 0;
+                    e.leftHand = inst1;
+                }
+            } else {
+                handLog() << "    - 시간차 큼 → 거리 기반 판단\n";
+                Hand preferred = getPreferredHandByDistance(inst1, prevRightNote, prevLeftNote, prevRightHit, prevLeftHit);
+                if (preferred == RIGHT) {
+                    handLog() << "    → RIGHT 선택\n";
+                    e.rightHand = inst1;
+                    e.leftHand = 0;
+                } else if (preferred == LEFT) {
+                    handLog() << "    → LEFT 선택\n";
+                    e.leftHand = inst1;
+                    e.rightHand = 0;
+                }    
+                else {
+                    handLog() << "    → 점수 같고 시간 널널 오른손 우선권 선택\n";
+                    // 여기는 한손 연주이면서 전에 쳤던 악기를 치는 것이지만 시간과 거리에 대한 점수도 모두 동일함 일단 오른손에 우선권을 주겠다.
+                    e.rightHand = inst1;
+                    e.leftHand = 0;
+                }
+            }
+        } else {
+            handLog() << "    - 이전 손과 다른 악기 → 거리 기반 판단\n";
+            Hand preferred = getPreferredHandByDistance(inst1, prevRightNote, prevLeftNote, prevRightHit, prevLeftHit);
+                if (preferred == RIGHT) {
+                    handLog() << "    → RIGHT 선택\n";
+                    e.rightHand = inst1;
+                } else if (preferred == LEFT) {
+                    handLog() << "    → LEFT 선택\n";
+                    e.leftHand = inst1;
+                } 
+                //악기 위치 거리 기반으로 손 분배 이때 전에 친악기를 inst2로 사용해서 구함  
+                else {
+                    handLog() << "    → SAME 판단 → 섹션 기반 분배\n";
+                    
+                    int inst2 = (prevRightNote != 0) ? prevRightNote : prevLeftNote;
+                    auto [left, right] = assignHandsByPosition(inst1, inst2);
+                    if(left  == inst1)
+                        e.leftHand  = (left  == inst1) ? inst1 : 0;
+                    else
+                        e.rightHand = (right == inst1) ? inst1 : 0;
+                    
+                    
+                    handLog() << "      - inst1: " << inst1 << ", inst2: " << inst2
+                                << " → 왼손 = " << e.leftHand << ", 오른손 = " << e.rightHand << "\n";
+                }
+        }
+    }
+
+    handLog() << "→ 결과: RH = " << e.rightHand << ", LH = " << e.leftHand << "\n\n";
+
+    checkCross(e.rightHand, e.leftHand, prevRightNote, prevLeftNote);
+
+    prevRight = e.rightHand;
+    prevLeft = e.leftHand;
+    if (e.rightHand != 0) { prevRightNote = e.rightHand; prevRightHit = 0; }
+    if (e.leftHand != 0) { prevLeftNote = e.leftHand; prevLeftHit = 0; }
+}
+
+inline void assignHandsSerial(std::vector<FullEvent>& events, HandState& state) {
+    for (auto& e : events) assignEvent(e, state);
+}
+
+// 이보다 짧은 곡은 그냥 직렬로 배정 (디버깅 출력도 유지)
+const size_t PARALLEL_MIN_EVENTS = 20000;
+const size_t PARALLEL_MIN_SEGMENT = 4096;
+
+// 구간 병렬 배정
+//  1) 직전 타격 후 0.6초 이상 지난 지점(양손 시간 항이 모두 포화 = 자연스러운 리셋 지점)에서 곡을 나눔
+//  2) 각 구간을 추정 시작 상태로 동시에 배정하면서 이벤트마다 상태를 기록
+//  3) 앞 구간부터 실제 시작 상태와 비교. 다르면 그 구간을 실제 상태로 다시 배정하다가
+//     기록된 추정 상태와 같아지는 순간(sameEffect) 멈추고 나머지는 추정 결과를 그대로 사용
+// 배정은 상태에 대해 결정적이므로 결과는 직렬 실행과 같음
+inline void assignHandsParallel(std::vector<FullEvent>& events, HandState& state, unsigned threads = 0) {
+    const size_t n = events.size();
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t maxSegs = n / PARALLEL_MIN_SEGMENT;
+    if (n < PARALLEL_MIN_EVENTS || threads < 2 || maxSegs < 2) {
+        assignHandsSerial(events, state);
+        return;
+    }
+    size_t segs = std::min<size_t>(threads, maxSegs);
+
+    // 리셋 지점 표시: 마지막 타격 이후 누적 시간이 0.6 이상
+    std::vector<char> reset(n, 0);
+    double sinceHit = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        sinceHit += events[i].time;
+        if (sinceHit >= HAND_TIME_CAP) reset[i] = 1;
+        if (events[i].inst1 != 0) sinceHit = 0.0;
+    }
+
+    // 목표 경계 근처의 리셋 지점으로 자름 (없으면 목표 위치 그대로)
+    std::vector<size_t> bounds{0};
+    for (size_t k = 1; k < segs; ++k) {
+        size_t target = n * k / segs;
+        size_t lo = bounds.back() + 1;
+        size_t hi = std::min(n - 1, target + n / (4 * segs));
+        size_t cut = target;
+        for (size_t i = target; i >= lo && i + n / (4 * segs) >= target; --i) {
+            if (reset[i]) { cut = i; break; }
+        }
+        if (!reset[cut]) {
+            for (size_t i = target; i <= hi; ++i) {
+                if (reset[i]) { cut = i; break; }
+            }
+        }
+        if (cut > bounds.back()) bounds.push_back(cut);
+    }
+    bounds.push_back(n);
+    segs = bounds.size() - 1;
+
+    // 추정 시작 상태: 악기는 초기값, 시간 항은 포화
+    HandState guess;
+    guess.prevRightHit = guess.prevLeftHit = HAND_TIME_CAP;
+
+    std::vector<HandState> after(n);
+    std::vector<std::thread> workers;
+    // activeKit 는 thread_local 이라 새 스레드에서는 기본 drumXYZ → 호출한 스레드의 키트를 넘겨줌
+    const Coord* kit = activeKit;
+    for (size_t g = 1; g < segs; ++g) {
+        workers.emplace_back([&, g, kit] {
+            activeKit = kit;
+            handLogEnabled = false;
+            HandState st = guess;
+            for (size_t i = bounds[g]; i < bounds[g + 1]; ++i) {
+                assignEvent(events[i], st);
+                after[i] = st;
+            }
+        });
+    }
+    // 첫 구간은 실제 시작 상태를 알고 있으므로 현재 스레드에서 처리
+    {
+        bool prevLog = handLogEnabled;
+        handLogEnabled = false;
+        for (size_t i = 0; i < bounds[1]; ++i) {
+            assignEvent(events[i], state);
+            after[i] = state;
+        }
+        handLogEnabled = prevLog;
+    }
+    for (auto& w : workers) w.join();
+
+    // 경계 이어 붙이기
+    bool prevLog = handLogEnabled;
+    handLogEnabled = false;
+    HandState cur = state;
+    for (size_t g = 1; g < segs; ++g) {
+        size_t b = bounds[g], e = bounds[g + 1];
+        if (sameEffect(cur, guess)) {
+            cur = after[e - 1];
+            continue;
+        }
+        bool converged = false;
+        for (size_t i = b; i < e; ++i) {
+            assignEvent(events[i], cur);
+            if (sameEffect(cur, after[i])) {
+                converged = true;
+                break;
+            }
+        }
+        if (converged) cur = after[e - 1];
+    }
+    handLogEnabled = prevLog;
+    state = cur;
+}
@@ -0,0 +1,196 @@
+#pragma once
+
+// 손 배정 결정표 (assignEvent 의 분기를 미리 다 계산해 둔 표)
+//  - assignEvent 의 결과(오른손 악기, 왼손 악기)는 아래 값만으로 정해짐
+//      양손 줄(inst1, inst2 둘 다 있음): inst1, inst2                      → pair[9][9]
+//      한손 줄(inst2 = 0)             : inst1, 직전 배정과 같은 악기인지(없음/R/L), e.time <= 0.1,
+//                                      prevRightNote, prevLeftNote, 손별 누적 시간 (0.6 에서 자르고 0.05 단위)
+//                                                                           → single[9][3][2][9][9][13][13]
+//  - 시간은 roundDurationsToStepSet100 이후라 모두 0.05 배수 → 누적 시간도 13칸(0 ~ 0.6)으로 정확히 나뉨
+//    0.05 배수가 아닌 시간이 들어오면 그 줄만 원래 assignEvent 로 처리 (결과 같음)
+//  - 표는 키트 좌표(activeKit, 기본 drumXYZ)와 규칙 버전(HAND_TABLE_VERSION)마다 한 번 생성해 파일로 저장
+//    규칙을 고치면 HAND_TABLE_VERSION 을 올릴 것 → 예전 표는 load() 에서 거부됨
+//
+// 사용 예)
+//   HandDecisionTable table;
+//   if (!table.load("hand_table.bin")) { table.build(); table.save("hand_table.bin"); }
+//   HandState state;
+//   assignHandsTable(events, state, table);
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "hand_assign.hpp"
+
+const uint32_t HAND_TABLE_VERSION = 1;
+const double HAND_TABLE_STEP = 0.05;
+const int HAND_TABLE_TIME_BUCKETS = 13;   // 0, 0.05, ..., 0.6(이상)
+const int HAND_TABLE_INST = NUM_INST;     // 0~8
+
+// 키트 좌표 + 규칙 버전 지문 (FNV-1a)
+inline uint64_t handTableKitHash() {
+    uint64_t h = 1469598103934665603ull;
+    auto mix = [&h](const void* p, size_t n) {
+        const unsigned char* b = static_cast<const unsigned char*>(p);
+        for (size_t i = 0; i < n; ++i) { h ^= b[i]; h *= 1099511628211ull; }
+    };
+    mix(activeKit, sizeof(Coord) * NUM_INST);
+    mix(&HAND_TABLE_VERSION, sizeof(HAND_TABLE_VERSION));
+    return h;
+}
+
+class HandDecisionTable {
+public:
+    // 결과 한 칸: 하위 4비트 오른손 악기, 상위 4비트 왼손 악기
+    static uint8_t pack(int right, int left) { return static_cast<uint8_t>(right | (left << 4)); }
+
+    static size_t singleIndex(int inst1, int same, int shortGap, int rNote, int lNote, int tR, int tL) {
+        return (((((static_cast<size_t>(inst1) * 3 + same) * 2 + shortGap) * HAND_TABLE_INST + rNote)
+                 * HAND_TABLE_INST + lNote) * HAND_TABLE_TIME_BUCKETS + tR) * HAND_TABLE_TIME_BUCKETS + tL;
+    }
+    static size_t singleSize() { return singleIndex(HAND_TABLE_INST, 0, 0, 0, 0, 0, 0); }
+
+    // 표 전체를 assignEvent 로 채움 (키마다 그 키가 되는 대표 상태를 만들어 한 번씩 실행)
+    void build() {
+        bool prevLog = handLogEnabled;
+        handLogEnabled = false;
+        for (int a = 0; a < HAND_TABLE_INST; ++a) {
+            for (int b = 0; b < HAND_TABLE_INST; ++b) {
+                FullEvent e;
+                e.time = 0.15;
+                e.inst1 = a;
+                e.inst2 = b;
+                HandState s;
+                assignEvent(e, s);
+                pair_[a][b] = pack(e.rightHand, e.leftHand);
+            }
+        }
+        single_.assign(singleSize(), 0);
+        for (int i = 0; i < HAND_TABLE_INST; ++i)
+        for (int same = 0; same < 3; ++same)
+        for (int sh = 0; sh < 2; ++sh)
+        for (int rn = 0; rn < HAND_TABLE_INST; ++rn)
+        for (int ln = 0; ln < HAND_TABLE_INST; ++ln)
+        for (int tr = 0; tr < HAND_TABLE_TIME_BUCKETS; ++tr)
+        for (int tl = 0; tl < HAND_TABLE_TIME_BUCKETS; ++tl) {
+            FullEvent e;
+            e.time = sh ? 0.05 : 0.15;
+            e.inst1 = i;
+            HandState s;
+            s.prevRight = same == 1 ? i : 0;
+            s.prevLeft = same == 2 ? i : 0;
+            s.prevRightNote = rn;
+            s.prevLeftNote = ln;
+            // assignEvent 가 e.time 을 더하므로 미리 빼 둠 (도달할 수 없는 조합은 음수가 되어도 상관없음)
+            s.prevRightHit = tr * HAND_TABLE_STEP - e.time;
+            s.prevLeftHit = tl * HAND_TABLE_STEP - e.time;
+            assignEvent(e, s);
+            single_[singleIndex(i, same, sh, rn, ln, tr, tl)] = pack(e.rightHand, e.leftHand);
+        }
+        handLogEnabled = prevLog;
+        kitHash_ = handTableKitHash();
+    }
+
+    bool save(const std::string& path) const {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return false;
+        uint32_t n = static_cast<uint32_t>(single_.size());
+        out.write("DHT1", 4);
+        out.write(reinterpret_cast<const char*>(&HAND_TABLE_VERSION), sizeof(HAND_TABLE_VERSION));
+        out.write(reinterpret_cast<const char*>(&kitHash_), sizeof(kitHash_));
+        out.write(reinterpret_cast<const char*>(&n), sizeof(n));
+        out.write(reinterpret_cast<const char*>(pair_), sizeof(pair_));
+        out.write(reinterpret_cast<const char*>(single_.data()), n);
+        return static_cast<bool>(out);
+    }
+
+    // 키트/규칙 버전이 다르거나 크기가 안 맞으면 false (→ 다시 build)
+    bool load(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open()) return false;
+        char magic[4];
+        uint32_t ver = 0, n = 0;
+        uint64_t hash = 0;
+        in.read(magic, 4);
+        in.read(reinterpret_cast<char*>(&ver), sizeof(ver));
+        in.read(reinterpret_cast<char*>(&hash), sizeof(hash));
+        in.read(reinterpret_cast<char*>(&n), sizeof(n));
+        if (!in || std::memcmp(magic, "DHT1", 4) != 0 || ver != HAND_TABLE_VERSION || hash != handTableKitHash() ||
+            n != singleSize())
+            return false;
+        in.read(reinterpret_cast<char*>(pair_), sizeof(pair_));
+        single_.resize(n);
+        in.read(reinterpret_cast<char*>(single_.data()), n);
+        if (!in) {
+            single_.clear();
+            return false;
+        }
+        kitHash_ = hash;
+        return true;
+    }
+
+    bool ready() const { return !single_.empty(); }
+    size_t bytes() const { return sizeof(pair_) + single_.size(); }
+
+    // 표로 처리할 수 없는 줄(0.05 배수가 아닌 시간, 범위 밖 악기)이면 false
+    bool lookup(const FullEvent& e, const HandState& s, double rHit, double lHit, uint8_t& out) const {
+        int a = e.inst1, b = e.inst2;
+        if (a < 0 || a >= HAND_TABLE_INST || b < 0 || b >= HAND_TABLE_INST) return false;
+        if (a && b) {
+            out = pair_[a][b];
+            return true;
+        }
+        if (b) return false;   // inst1 없이 inst2 만 있는 줄은 없지만 혹시 있으면 원래 코드로
+        int tr, tl, dt;
+        if (!bucket(rHit, tr) || !bucket(lHit, tl) || !bucket(e.time, dt)) return false;
+        if (s.prevRightNote < 0 || s.prevRightNote >= HAND_TABLE_INST ||
+            s.prevLeftNote < 0 || s.prevLeftNote >= HAND_TABLE_INST) return false;
+        int same = (a == s.prevRight) ? 1 : (a == s.prevLeft) ? 2 : 0;
+        out = single_[singleIndex(a, same, dt <= 2, s.prevRightNote, s.prevLeftNote, tr, tl)];
+        return true;
+    }
+
+private:
+    // 0.6 에서 자른 시간 → 0.05 칸 번호. 0.05 배수가 아니면 false
+    static bool bucket(double t, int& k) {
+        if (t < 0) return false;
+        double q = std::min(t, HAND_TIME_CAP) / HAND_TABLE_STEP;
+        long r = std::lround(q);
+        if (std::abs(q - r) > 1e-6) return false;
+        k = static_cast<int>(r);
+        return true;
+    }
+
+    uint8_t pair_[HAND_TABLE_INST][HAND_TABLE_INST] = {};
+    std::vector<uint8_t> single_;
+    uint64_t kitHash_ = 0;
+};
+
+// assignEvent 와 같은 결과/상태 갱신, 분기 대신 표 한 칸 읽기
+inline void assignEventTable(FullEvent& e, HandState& s, const HandDecisionTable& table) {
+    uint8_t code;
+    if (!table.lookup(e, s, s.prevRightHit + e.time, s.prevLeftHit + e.time, code)) {
+        assignEvent(e, s);
+        return;
+    }
+    s.prevRightHit += e.time;
+    s.prevLeftHit += e.time;
+    e.rightHand = code & 0x0F;
+    e.leftHand = code >> 4;
+    s.prevRight = e.rightHand;
+    s.prevLeft = e.leftHand;
+    if (e.rightHand != 0) { s.prevRightNote = e.rightHand; s.prevRightHit = 0; }
+    if (e.leftHand != 0) { s.prevLeftNote = e.leftHand; s.prevLeftHit = 0; }
+}
+
+inline void assignHandsTable(std::vector<FullEvent>& events, HandState& state, const HandDecisionTable& table) {
+    bool prevLog = handLogEnabled;
+    handLogEnabled = false;   // 표에서 읽은 줄은 판단 과정이 없으므로 대체 처리 줄 로그도 끔
+    for (auto& e : events) assignEventTable(e, state, table);
+    handLogEnabled = prevLog;
+}
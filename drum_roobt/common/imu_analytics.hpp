@@ -0,0 +1,274 @@
+#pragma once
+
+// IMU 캡처 일괄 분석 (세션 뒤 파이썬으로 하던 크기/필터/타격 피크 계산)
+//  - 입력: sensor_log.bin (블록 색인 로그) 또는 예전 sensor_log.csv → 가속도/각속도(/각도) 열 배열(SensorColumns)
+//    프레임 단위로 기록된 로그는 한 샘플의 A/G/E 레코드 시각이 같으므로 보간 (1) 에서 두 센서가 정확히 겹침
+//  - 처리 순서 (모두 같은 길이의 청크로 나눠 스레드에 분배, 청크 경계는 --chunk 초로만 정해짐 → 스레드 수와 결과 무관)
+//      (1) 균일 시각 격자(rate Hz)로 선형 보간 — 가속도/각속도가 같은 격자에 놓여 줄 단위로 합쳐짐
+//      (2) 크기 |acc|, |gyro| — 분기 없는 float 루프 (motion_onset 과 같이 자동 벡터화)
+//      (3) 영위상 저역 통과 (2차 버터워스 앞뒤 두 번 = filtfilt)
+//          IIR 은 시간 방향으로 순차라 시간 축 SIMD 가 안 되므로 8채널(ax ay az gx gy gz |a| |g|)을
+//          [샘플][8] 로 섞어 두고 채널 방향으로 한 번에 계산 (8 float = SSE 2번 / AVX 1번)
+//          청크마다 앞뒤로 pad 샘플을 더 읽어 필터를 데움 (pad 는 차단 주파수의 시정수 여러 배 → 오차 무시 가능)
+//      (4) 타격 피크: 필터된 |gyro| 가 thr 이상이고 ±gap 안에서 최대인 샘플
+//          후보(이웃보다 큰 샘플)는 분기 없는 루프로 표시만 하고, 후보만 창 안 최댓값 확인
+//  - 시작 상태는 첫 샘플 값에서 정상 상태 (scipy lfilter_zi 와 같음), 패딩은 하지 않음
+//
+// 사용 예)
+//   ImuCapture cap;
+//   loadImuCapture("sensor_log.bin", cap);
+//   ImuConfig cfg;                 // 100 Hz, 차단 15 Hz, thr 200 dps
+//   ImuSeries s;
+//   std::vector<ImuStroke> strokes;
+//   analyzeImu(cap, cfg, s, strokes);
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "sensor_log.hpp"
+
+struct ImuCapture {
+    SensorColumns acc, gyro;
+    SensorColumns angle;   // 각도(0x53)를 켠 센서의 프레임 로그에만 있음
+};
+
+struct ImuConfig {
+    double rate = 100.0;      // 균일 격자 [Hz]
+    double cutoff = 15.0;     // 저역 통과 차단 주파수 [Hz]
+    float strokeThr = 200.0f; // 타격으로 볼 최소 |gyro| [deg/s]
+    double strokeGap = 0.08;  // 피크 사이 최소 간격 [s]
+    double chunkSec = 60.0;   // 병렬 처리 단위
+    unsigned threads = 0;     // 0 이면 코어 수
+};
+
+const int IMU_CHANNELS = 8;   // ax ay az gx gy gz |a| |g|
+enum ImuChannel { IMU_AX, IMU_AY, IMU_AZ, IMU_GX, IMU_GY, IMU_GZ, IMU_AMAG, IMU_GMAG };
+
+// 균일 격자 결과 (열마다 n 개)
+struct ImuSeries {
+    int64_t t0Us = 0;                        // 첫 샘플 시각 (epoch us)
+    double rate = 0.0;
+    size_t n = 0;
+    std::vector<float> raw[IMU_CHANNELS];    // 보간만 한 값 (+ 크기)
+    std::vector<float> filt[IMU_CHANNELS];   // 영위상 필터 뒤
+
+    int64_t timeUs(size_t i) const { return t0Us + static_cast<int64_t>(i * 1e6 / rate + 0.5); }
+};
+
+struct ImuStroke {
+    size_t index;        // 격자 위치
+    int64_t tUs;
+    float gyroPeak;      // 필터된 |gyro| 최댓값 [deg/s]
+    float accAtPeak;     // 같은 시각 필터된 |acc| [g]
+};
+
+struct ImuStrokeStats {
+    size_t count = 0;
+    float mean = 0, p50 = 0, p90 = 0, max = 0;
+};
+
+// 확장자가 .csv 면 예전 CSV, 아니면 블록 로그
+inline bool loadImuCapture(const std::string& path, ImuCapture& cap) {
+    cap.acc.clear();
+    cap.gyro.clear();
+    cap.angle.clear();
+    auto add = [&](const SensorRecord& r) {
+        SensorColumns* c = r.type == 'A' ? &cap.acc : r.type == 'G' ? &cap.gyro : r.type == 'E' ? &cap.angle : nullptr;
+        if (!c) return;
+        c->t.push_back(r.tUs);
+        c->x.push_back(r.x);
+        c->y.push_back(r.y);
+        c->z.push_back(r.z);
+    };
+    if (path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0) {
+        if (readSensorCsv(path, add) < 0) return false;
+    } else {
+        SensorLogReader log;
+        if (!log.open(path)) return false;
+        log.forEach(log.firstTime(), log.lastTime(), add);
+    }
+    if (cap.acc.size() < 2 || cap.gyro.size() < 2) {
+        std::cerr << "가속도/각속도 샘플이 부족함: " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+namespace imu_detail {
+
+// 청크 [0, chunks) 를 스레드에 나눠 fn(c) 호출
+template <class Fn>
+void parallelChunks(size_t chunks, unsigned threads, Fn&& fn) {
+    unsigned n = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+    n = static_cast<unsigned>(std::min<size_t>(n, chunks));
+    if (n <= 1) {
+        for (size_t c = 0; c < chunks; ++c) fn(c);
+        return;
+    }
+    std::atomic<size_t> next{0};
+    std::vector<std::thread> workers;
+    for (unsigned w = 0; w < n; ++w)
+        workers.emplace_back([&] {
+            for (size_t c; (c = next.fetch_add(1)) < chunks;) fn(c);
+        });
+    for (auto& t : workers) t.join();
+}
+
+// src 시각(us) 의 x/y/z 를 격자 [begin, end) 로 선형 보간
+inline void resampleRange(const SensorColumns& src, int64_t t0Us, double rate, size_t begin, size_t end,
+                          float* ox, float* oy, float* oz) {
+    const int64_t* t = src.t.data();
+    const size_t m = src.size();
+    auto at = [&](size_t i) { return static_cast<double>(t0Us) + i * 1e6 / rate; };
+    // 격자 시각 이하인 마지막 원본 샘플
+    size_t j = std::upper_bound(src.t.begin(), src.t.end(), static_cast<int64_t>(at(begin))) - src.t.begin();
+    j = j ? j - 1 : 0;
+    for (size_t i = begin; i < end; ++i) {
+        double ti = at(i);
+        while (j + 2 < m && static_cast<double>(t[j + 1]) <= ti) ++j;
+        double span = static_cast<double>(t[j + 1] - t[j]);
+        float f = span > 0 ? static_cast<float>(std::clamp((ti - t[j]) / span, 0.0, 1.0)) : 0.0f;
+        ox[i] = src.x[j] + (src.x[j + 1] - src.x[j]) * f;
+        oy[i] = src.y[j] + (src.y[j + 1] - src.y[j]) * f;
+        oz[i] = src.z[j] + (src.z[j + 1] - src.z[j]) * f;
+    }
+}
+
+// 2차 버터워스 저역 통과 (bilinear 변환)
+struct Biquad {
+    float b0, b1, b2, a1, a2;
+
+    Biquad(double fc, double fs) {
+        double K = std::tan(M_PI * std::min(fc, fs * 0.45) / fs);
+        double norm = 1.0 / (1.0 + M_SQRT2 * K + K * K);
+        b0 = static_cast<float>(K * K * norm);
+        b1 = 2.0f * b0;
+        b2 = b0;
+        a1 = static_cast<float>(2.0 * (K * K - 1.0) * norm);
+        a2 = static_cast<float>((1.0 - M_SQRT2 * K + K * K) * norm);
+    }
+};
+
+// buf: [len][IMU_CHANNELS] 섞인 배열. 한 방향 필터를 제자리에서 (backward 면 끝에서부터)
+inline void biquadPass(const Biquad& q, float* buf, size_t len, bool backward) {
+    if (len == 0) return;
+    float z1[IMU_CHANNELS], z2[IMU_CHANNELS];
+    const float* first = buf + (backward ? (len - 1) * IMU_CHANNELS : 0);
+    for (int c = 0; c < IMU_CHANNELS; ++c) {   // 첫 값에서 정상 상태 (직류 이득 1)
+        z1[c] = (1.0f - q.b0) * first[c];
+        z2[c] = (q.b2 - q.a2) * first[c];
+    }
+    for (size_t k = 0; k < len; ++k) {
+        float* v = buf + (backward ? len - 1 - k : k) * IMU_CHANNELS;
+        for (int c = 0; c < IMU_CHANNELS; ++c) {   // 채널 방향 (벡터화 대상)
+            float x = v[c];
+            float y = q.b0 * x + z1[c];
+            z1[c] = q.b1 * x - q.a1 * y + z2[c];
+            z2[c] = q.b2 * x - q.a2 * y;
+            v[c] = y;
+        }
+    }
+}
+
+}  // namespace imu_detail
+
+inline void analyzeImu(const ImuCapture& cap, const ImuConfig& cfg, ImuSeries& s, std::vector<ImuStroke>& strokes) {
+    using namespace imu_detail;
+
+    // 두 센서가 모두 있는 구간만
+    const int64_t t0 = std::max(cap.acc.t.front(), cap.gyro.t.front());
+    const int64_t t1 = std::min(cap.acc.t.back(), cap.gyro.t.back());
+    s = ImuSeries();
+    s.t0Us = t0;
+    s.rate = cfg.rate;
+    s.n = t1 > t0 ? static_cast<size_t>((t1 - t0) * 1e-6 * cfg.rate) + 1 : 1;
+    for (int c = 0; c < IMU_CHANNELS; ++c) {
+        s.raw[c].resize(s.n);
+        s.filt[c].resize(s.n);
+    }
+    strokes.clear();
+
+    const size_t chunk = std::max<size_t>(256, static_cast<size_t>(cfg.chunkSec * cfg.rate));
+    const size_t chunks = (s.n + chunk - 1) / chunk;
+    const size_t pad = static_cast<size_t>(std::max(64.0, 8.0 * cfg.rate / cfg.cutoff));
+    const size_t gap = std::max<size_t>(1, static_cast<size_t>(cfg.strokeGap * cfg.rate));
+    const Biquad q(cfg.cutoff, cfg.rate);
+
+    // (1)(2) 보간 + 크기
+    parallelChunks(chunks, cfg.threads, [&](size_t c) {
+        size_t b = c * chunk, e = std::min(s.n, b + chunk);
+        resampleRange(cap.acc, t0, cfg.rate, b, e, s.raw[IMU_AX].data(), s.raw[IMU_AY].data(), s.raw[IMU_AZ].data());
+        resampleRange(cap.gyro, t0, cfg.rate, b, e, s.raw[IMU_GX].data(), s.raw[IMU_GY].data(), s.raw[IMU_GZ].data());
+        for (int g = 0; g < 2; ++g) {
+            const float* x = s.raw[g * 3].data();
+            const float* y = s.raw[g * 3 + 1].data();
+            const float* z = s.raw[g * 3 + 2].data();
+            float* m = s.raw[IMU_AMAG + g].data();
+            for (size_t i = b; i < e; ++i) m[i] = std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+        }
+    });
+
+    // (3) 청크 + 앞뒤 pad 를 섞인 배열로 옮겨 앞뒤 필터, 가운데만 되돌림 (보간이 끝난 뒤라 pad 를 읽어도 됨)
+    parallelChunks(chunks, cfg.threads, [&](size_t c) {
+        size_t b = c * chunk, e = std::min(s.n, b + chunk);
+        size_t pb = b > pad ? b - pad : 0, pe = std::min(s.n, e + pad);
+        std::vector<float> buf((pe - pb) * IMU_CHANNELS);
+        for (int ch = 0; ch < IMU_CHANNELS; ++ch) {
+            const float* src = s.raw[ch].data();
+            for (size_t i = pb; i < pe; ++i) buf[(i - pb) * IMU_CHANNELS + ch] = src[i];
+        }
+        biquadPass(q, buf.data(), pe - pb, false);
+        biquadPass(q, buf.data(), pe - pb, true);
+        for (int ch = 0; ch < IMU_CHANNELS; ++ch) {
+            float* dst = s.filt[ch].data();
+            for (size_t i = b; i < e; ++i) dst[i] = buf[(i - pb) * IMU_CHANNELS + ch];
+        }
+    });
+
+    // (4) 타격 피크 (청크마다 모아서 순서대로 합침)
+    std::vector<std::vector<ImuStroke>> found(chunks);
+    parallelChunks(chunks, cfg.threads, [&](size_t c) {
+        size_t b = std::max<size_t>(c * chunk, 1), e = std::min(s.n - 1, c * chunk + chunk);
+        if (b >= e) return;
+        const float* g = s.filt[IMU_GMAG].data();
+        const float thr = cfg.strokeThr;
+        std::vector<uint8_t> cand(e - b);
+        uint8_t* pc = cand.data();
+        for (size_t i = b; i < e; ++i)   // 분기 없는 후보 표시
+            pc[i - b] = (g[i] >= thr) & (g[i] > g[i - 1]) & (g[i] >= g[i + 1]);
+        for (size_t i = b; i < e; ++i) {
+            if (!pc[i - b]) continue;
+            size_t lo = i > gap ? i - gap : 0, hi = std::min(s.n - 1, i + gap);
+            bool isMax = true;
+            for (size_t k = lo; k <= hi && isMax; ++k)   // 같은 값이면 앞쪽 샘플이 피크
+                isMax = k < i ? g[k] < g[i] : k == i || g[k] <= g[i];
+            if (isMax) found[c].push_back({i, s.timeUs(i), g[i], s.filt[IMU_AMAG][i]});
+        }
+    });
+    for (auto& f : found) strokes.insert(strokes.end(), f.begin(), f.end());
+}
+
+inline ImuStrokeStats strokeStats(const std::vector<ImuStroke>& strokes) {
+    ImuStrokeStats st;
+    st.count = strokes.size();
+    if (strokes.empty()) return st;
+    std::vector<float> v;
+    v.reserve(strokes.size());
+    double sum = 0;
+    for (const auto& s : strokes) {
+        v.push_back(s.gyroPeak);
+        sum += s.gyroPeak;
+    }
+    std::sort(v.begin(), v.end());
+    st.mean = static_cast<float>(sum / v.size());
+    st.p50 = v[v.size() / 2];
+    st.p90 = v[std::min(v.size() - 1, v.size() * 9 / 10)];
+    st.max = v.back();
+    return st;
+}
@@ -0,0 +1,198 @@
+#pragma once
+
+// WitMotion 패킷 → 한 샘플(프레임) 묶기 + 스레드 간 전달용 SPSC 링
+//  - 센서는 출력 주기마다 0x51(가속도) 0x52(각속도) 0x53(각도) 패킷을 이 순서로 보냄 (설정에 따라 일부만)
+//    예전에는 패킷마다 따로 CSV 줄(각자 시각 문자열)을 써서 쓰는 쪽마다 다시 합쳐야 했음
+//  - WitFrameAssembler: 바이트 스트림을 받아 11바이트 패킷을 자르고(체크섬 틀리면 다음 0x55 부터 다시 맞춤)
+//    같은 주기의 패킷을 ImuFrame 하나로 모음
+//      · 태그가 줄어들거나(0x53 → 0x51) 이미 받은 태그가 또 오면 새 주기 → 모으던 프레임을 내보냄
+//      · 지금까지 본 태그 조합을 기억해 두고, 그 조합이 다 모이면 다음 주기를 기다리지 않고 바로 내보냄
+//        (지연 = 마지막 패킷 도착 시점. 패킷이 빠진 주기만 다음 주기 첫 패킷까지 기다림)
+//      · 버퍼는 만드는 중인 패킷 1개 + 프레임 1개뿐
+//      · 시각은 패킷을 끝내는 바이트 기준. read() 한 번에 여러 패킷이 오면 다 같은 시각이 되므로
+//        nowUs 를 버퍼 마지막 바이트 도착 시각으로 보고, 앞 바이트는 보율(setBaud)만큼 거슬러 계산
+//        (이전 패킷보다 앞서지 않게 자름. setBaud 를 안 하면 예전처럼 버퍼 전체가 nowUs)
+//  - SpscRing: 생산자 1 / 소비자 1 고정 크기 링 (잠금 없음, 원소는 연속 배열)
+//    시리얼을 읽는 스레드가 넣고 기록/타격 감지 스레드가 꺼냄. 가득 차면 push 가 false → 호출 쪽에서 버린 수를 셈
+//  - 로그에는 프레임 하나를 같은 시각의 'A' 'G' 'E'(각도) 레코드로 씀 → 읽는 쪽은 시각이 같은 레코드를 한 샘플로 봄
+//
+// 사용 예)
+//   WitFrameAssembler asm_;
+//   asm_.setBaud(9600);
+//   SpscRing<ImuFrame, 4096> ring;
+//   asm_.feed(buf, n, sensorNowUs(), [&](const ImuFrame& f) { ring.push(f); });   // 읽는 스레드
+//   ImuFrame f;
+//   while (ring.pop(f)) appendFrame(log, f);                                        // 소비 스레드
+
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#include "sensor_log.hpp"
+
+const uint8_t IMU_HAS_ACC = 1 << 0;
+const uint8_t IMU_HAS_GYRO = 1 << 1;
+const uint8_t IMU_HAS_ANGLE = 1 << 2;
+
+struct ImuFrame {
+    int64_t tUs = 0;        // 주기 첫 패킷을 받은 시각 (그 패킷 마지막 바이트 기준)
+    uint32_t seq = 0;       // 프레임 번호 (0부터)
+    uint8_t mask = 0;       // IMU_HAS_*
+    float acc[3] = {0, 0, 0};     // g
+    float gyro[3] = {0, 0, 0};    // deg/s
+    float angle[3] = {0, 0, 0};   // deg (roll pitch yaw)
+};
+
+// 센서에 설정된 측정 범위 (원시 값 ±32768 이 이 값)
+struct WitScale {
+    float acc = 16.0f;
+    float gyro = 2000.0f;
+    float angle = 180.0f;
+};
+
+class WitFrameAssembler {
+public:
+    struct Stats {
+        long packets = 0;        // 체크섬 통과한 패킷
+        long badChecksum = 0;
+        long otherTags = 0;      // 0x51~0x53 이 아닌 패킷 (자기장, 시각 등)
+        long skippedBytes = 0;   // 동기 찾느라 버린 바이트
+        long frames = 0;
+        long partial = 0;        // 가속도나 각속도가 빠진 프레임
+    };
+
+    explicit WitFrameAssembler(const WitScale& scale = WitScale()) : scale_(scale) {}
+
+    // 시리얼 보율 (8N1 → 바이트당 10비트). 0 이면 버퍼 안 바이트를 모두 nowUs 로 봄
+    void setBaud(int baud) { byteUs_ = baud > 0 ? 10.0e6 / baud : 0.0; }
+
+    // nowUs: data[n-1] 을 받은 시각 (read() 가 돌아온 시각)
+    template <class Emit>
+    void feed(const uint8_t* data, size_t n, int64_t nowUs, Emit&& emit) {
+        for (size_t i = 0; i < n; ++i) {
+            uint8_t b = data[i];
+            if (have_ == 0 && b != 0x55) {
+                ++stats_.skippedBytes;
+                continue;
+            }
+            pkt_[have_++] = b;
+            if (have_ < 11) continue;
+
+            uint8_t sum = 0;
+            for (int k = 0; k < 10; ++k) sum += pkt_[k];
+            if (sum == pkt_[10]) {
+                int64_t tUs = nowUs - static_cast<int64_t>((n - 1 - i) * byteUs_ + 0.5);
+                if (tUs < lastPacketUs_) tUs = lastPacketUs_;
+                lastPacketUs_ = tUs;
+                onPacket(tUs, emit);
+                have_ = 0;
+                continue;
+            }
+            // 체크섬 오류: 패킷 안의 다음 0x55 부터 다시 맞춤
+            ++stats_.badChecksum;
+            int k = 1;
+            while (k < 11 && pkt_[k] != 0x55) ++k;
+            stats_.skippedBytes += k;
+            std::memmove(pkt_, pkt_ + k, 11 - k);
+            have_ = 11 - k;
+        }
+    }
+
+    // 끝에서 모으던 프레임 내보내기
+    template <class Emit>
+    void finish(Emit&& emit) {
+        if (open_) emitFrame(emit);
+    }
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    static float raw(const uint8_t* p) { return static_cast<float>(static_cast<int16_t>(p[0] | (p[1] << 8))); }
+
+    template <class Emit>
+    void emitFrame(Emit& emit) {
+        ++stats_.frames;
+        if ((cur_.mask & (IMU_HAS_ACC | IMU_HAS_GYRO)) != (IMU_HAS_ACC | IMU_HAS_GYRO)) ++stats_.partial;
+        expected_ |= cur_.mask;
+        open_ = false;
+        emit(static_cast<const ImuFrame&>(cur_));
+    }
+
+    template <class Emit>
+    void onPacket(int64_t nowUs, Emit& emit) {
+        ++stats_.packets;
+        uint8_t tag = pkt_[1];
+        if (tag < 0x51 || tag > 0x53) {
+            ++stats_.otherTags;
+            return;
+        }
+        int idx = tag - 0x51;
+        uint8_t bit = static_cast<uint8_t>(1 << idx);
+        if (open_ && ((cur_.mask & bit) || tag <= lastTag_)) emitFrame(emit);
+        if (!open_) {
+            cur_ = ImuFrame();
+            cur_.tUs = nowUs;
+            cur_.seq = seq_++;
+            open_ = true;
+        }
+        const float scale = (idx == 0 ? scale_.acc : idx == 1 ? scale_.gyro : scale_.angle) / 32768.0f;
+        float* dst = idx == 0 ? cur_.acc : idx == 1 ? cur_.gyro : cur_.angle;
+        for (int a = 0; a < 3; ++a) dst[a] = raw(pkt_ + 2 + 2 * a) * scale;
+        cur_.mask |= bit;
+        lastTag_ = tag;
+        if (cur_.mask == expected_) emitFrame(emit);   // expected_ 가 0(아직 모름)이면 다음 주기까지 기다림
+    }
+
+    WitScale scale_;
+    uint8_t pkt_[11];
+    int have_ = 0;
+    ImuFrame cur_;
+    bool open_ = false;
+    uint8_t lastTag_ = 0;
+    uint8_t expected_ = 0;      // 지금까지 본 태그 조합 (패킷이 빠져도 줄어들지 않게 합집합)
+    uint32_t seq_ = 0;
+    double byteUs_ = 0.0;       // 바이트 하나 받는 시간
+    int64_t lastPacketUs_ = INT64_MIN;
+    Stats stats_;
+};
+
+// 생산자 1 / 소비자 1. N 은 2의 거듭제곱
+template <class T, size_t N>
+class SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing 크기는 2의 거듭제곱");
+
+public:
+    SpscRing() : buf_(N) {}
+
+    bool push(const T& v) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == N) return false;
+        buf_[tail & (N - 1)] = v;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& v) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) return false;
+        v = buf_[head & (N - 1)];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t size() const { return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire); }
+
+private:
+    std::vector<T> buf_;
+    alignas(64) std::atomic<size_t> head_{0};   // 소비자만 씀
+    alignas(64) std::atomic<size_t> tail_{0};   // 생산자만 씀
+};
+
+// 프레임 → 같은 시각의 'A' 'G' 'E' 레코드
+inline void appendFrame(SensorLogWriter& log, const ImuFrame& f) {
+    if (f.mask & IMU_HAS_ACC) log.append({f.tUs, 'A', {}, f.acc[0], f.acc[1], f.acc[2]});
+    if (f.mask & IMU_HAS_GYRO) log.append({f.tUs, 'G', {}, f.gyro[0], f.gyro[1], f.gyro[2]});
+    if (f.mask & IMU_HAS_ANGLE) log.append({f.tUs, 'E', {}, f.angle[0], f.angle[1], f.angle[2]});
+}
@@ -0,0 +1,329 @@
+#pragma once
+
+// 마디 하나만 고쳤을 때 손 배정 + 최종 악보(output6) 를 고친 부분만 다시 계산
+//  - 입력은 output3_mc2c.csv 이벤트 (손 배정 전). 처음 한 번 전체를 배정/변환하면서 이벤트마다
+//      배정 후 HandState, 마디 나누기 상태(마디 번호, 마디 안 누적 시간), 그 이벤트까지의 줄 수
+//    를 체크포인트로 남겨 둠
+//  - 편집 = 이벤트 구간 [first, last) 를 새 이벤트로 바꿈
+//      first 직전 체크포인트에서 시작해 새 이벤트 → 뒤쪽 기존 이벤트 순으로 다시 배정/변환하다가
+//      손 상태(sameEffect)와 마디 누적 시간이 예전 실행의 같은 이벤트 뒤 상태와 같아지면 멈춤
+//      → 그 뒤는 예전 결과를 그대로 이어 붙임 (마디 번호가 밀렸으면 번호만 더함)
+//  - 줄 변환은 newconvertToMeasureFile 과 같은 규칙 (0.6초 쪼개기, 2.4초 마디, 시간 0 이벤트는 줄 없음)
+//    → 처음부터 다시 만든 것과 글자 단위로 같음 (score_edit --check 로 확인)
+//  - 시각은 ms 정수로 들고 있음 (파일의 시간은 모두 소수 셋째 자리까지)
+//
+// 사용 예)
+//   IncrementalScore score;
+//   score.load("output/x/output3_mc2c.csv");
+//   score.editMeasure(12, rows, &stats, err);   // rows: 12마디를 고친 output6 형식 줄
+//   score.write("output6_final_x_edit.txt");
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "text_reader.hpp"
+#include "hand_assign.hpp"
+
+// output6 한 줄
+struct ScoreRow {
+    int measure;
+    double dt;
+    int R, L, Rp, Lp, bass, hihat;
+};
+
+// newconvertToMeasureFile 과 같은 형식: 선두 줄 | rows | (lastMeasure + 1) 빈 줄 | -1 끝 줄
+inline void writeScoreText(std::ostream& out, const std::vector<ScoreRow>& rows, int lastMeasure) {
+    out << std::fixed << std::setprecision(3);
+    out << 1 << "\t " << 0.600 << "\t 0\t 0\t 0\t 0\t 0\t 0\n";
+    for (const auto& r : rows)
+        out << r.measure << "\t " << r.dt << "\t " << r.R << "\t " << r.L << "\t " << r.Rp << "\t " << r.Lp
+            << "\t " << r.bass << "\t " << r.hihat << "\n";
+    out << lastMeasure + 1 << "\t " << 0.600 << "\t 0\t 0\t 0\t 0\t 0\t 0\n";
+    out << -1 << "\t " << 0.600 << "\t 1\t 1\t 1\t 1\t 1\t 1\n";
+}
+
+class IncrementalScore {
+public:
+    struct MeasureState {
+        int measure = 1;
+        double acc = 0.0;   // 현재 마디 안 누적 시간
+    };
+
+    struct EditStats {
+        size_t firstEvent = 0;
+        size_t reassigned = 0;    // 다시 배정한 이벤트 수 (새 이벤트 포함)
+        size_t rerendered = 0;    // 다시 만든 줄 수
+        size_t renumbered = 0;    // 줄은 그대로 두고 마디 번호만 다시 매긴 이벤트 수
+        int measureShift = 0;     // 뒤쪽 마디 번호가 밀린 양
+        bool converged = false;   // 곡 끝 전에 예전 상태와 만남
+    };
+
+    // output3_mc2c.csv (손 배정 전 이벤트) 읽기
+    static bool readEvents(const std::string& path, std::vector<FullEvent>& events) {
+        TextReader in(path);
+        if (!in.is_open()) {
+            std::cerr << "입력 파일 열기 실패: " << path << "\n";
+            return false;
+        }
+        events.clear();
+        std::string_view line, f[7];
+        while (in.nextLine(line)) {
+            if (splitFields(line, f, 7) != 7) continue;
+            FullEvent e;
+            if (!toDouble(f[0], e.time) || !toInt(f[1], e.inst1) || !toInt(f[2], e.inst2) ||
+                !toInt(f[5], e.bassHit) || !toInt(f[6], e.hihat)) continue;
+            events.push_back(e);
+        }
+        return true;
+    }
+
+    bool load(const std::string& path) {
+        std::vector<FullEvent> events;
+        if (!readEvents(path, events)) return false;
+        build(events);
+        return true;
+    }
+
+    // 처음부터 전체 계산. initial: 첫 이벤트 전 손 상태 (셋리스트에서 앞 곡의 마지막 상태를 이어받을 때)
+    void build(const std::vector<FullEvent>& events, const HandState& initial = HandState{}) {
+        ev_.clear(); absMs_.clear(); after_.clear(); mAfter_.clear(); rowEnd_.clear(); rows_.clear();
+        initial_ = initial;
+        replaceEvents(0, 0, events);
+    }
+
+    // 이벤트 [first, last) 를 repl 로 교체 (repl 의 time/inst1/inst2/bassHit/hihat 만 사용)
+    void replaceEvents(size_t first, size_t last, const std::vector<FullEvent>& repl, EditStats* stats = nullptr) {
+        const size_t oldN = ev_.size();
+        bool prevLog = handLogEnabled;
+        handLogEnabled = false;
+
+        HandState hs = first ? after_[first - 1] : initial_;
+        MeasureState ms = first ? mAfter_[first - 1] : MeasureState{};
+        long t = first ? absMs_[first - 1] : 0;
+        const size_t rowBegin = first ? rowEnd_[first - 1] : 0;
+
+        std::vector<FullEvent> nEv;
+        std::vector<long> nAbs;
+        std::vector<HandState> nAfter;
+        std::vector<MeasureState> nM;
+        std::vector<size_t> nRowEnd;
+        std::vector<ScoreRow> nRows;
+
+        auto step = [&](FullEvent e) {
+            e.rightHand = e.leftHand = 0;
+            assignEvent(e, hs);
+            renderEvent(e, ms, nRows);
+            t += std::lround(e.time * 1000.0);
+            nEv.push_back(e);
+            nAbs.push_back(t);
+            nAfter.push_back(hs);
+            nM.push_back(ms);
+            nRowEnd.push_back(rowBegin + nRows.size());
+        };
+        for (const auto& e : repl) step(e);
+
+        // 뒤쪽 기존 이벤트: 손 상태가 예전과 같아질 때까지 다시 배정/변환
+        size_t j = last;
+        bool converged = false;
+        while (j < oldN) {
+            step(ev_[j]);
+            bool same = sameEffect(hs, after_[j]);
+            ++j;
+            if (same) {
+                converged = true;
+                break;
+            }
+        }
+
+        // 그 뒤 줄 내용은 예전과 같음. 마디 누적 시간이 아직 다르면(마디 경계가 밀림)
+        // 예전 줄의 dt 로 마디 번호만 다시 매기다가 누적 시간이 같아지면 남은 부분은 번호 차이만 더함
+        int shift = 0;
+        size_t k = j;
+        if (converged) {
+            MeasureState oldPrev = mAfter_[j - 1];   // 예전 실행에서 같은 이벤트 뒤 마디 상태
+            while (k < oldN && std::fabs(ms.acc - oldPrev.acc) >= 1e-9) {
+                oldPrev = mAfter_[k];
+                for (size_t r = rowEnd_[k - 1]; r < rowEnd_[k]; ++r) rows_[r].measure = advanceMeasure(ms, rows_[r].dt);
+                mAfter_[k] = ms;
+                ++k;
+            }
+            shift = ms.measure - oldPrev.measure;
+        }
+        const size_t renumEnd = k;
+
+        // 이어 붙이기: [first, j) → 새 구간, j 이후는 줄 위치/시각 보정, renumEnd 이후는 마디 번호 차이만
+        const size_t oldRowEnd = j ? rowEnd_[j - 1] : 0;
+        const long rowDelta = static_cast<long>(rowBegin + nRows.size()) - static_cast<long>(oldRowEnd);
+        const long timeDelta = j ? t - absMs_[j - 1] : 0;   // editMeasure 는 다음 타격 시각을 지키므로 0
+        if (shift) {
+            for (size_t e = renumEnd; e < oldN; ++e) mAfter_[e].measure += shift;
+            for (size_t r = renumEnd ? rowEnd_[renumEnd - 1] : 0; r < rows_.size(); ++r) rows_[r].measure += shift;
+        }
+        for (size_t e = j; e < oldN; ++e) {
+            rowEnd_[e] = static_cast<size_t>(static_cast<long>(rowEnd_[e]) + rowDelta);
+            absMs_[e] += timeDelta;
+        }
+
+        splice(ev_, first, j, nEv);
+        splice(absMs_, first, j, nAbs);
+        splice(after_, first, j, nAfter);
+        splice(mAfter_, first, j, nM);
+        splice(rowEnd_, first, j, nRowEnd);
+        splice(rows_, rowBegin, oldRowEnd, nRows);
+
+        handLogEnabled = prevLog;
+        if (stats) {
+            stats->firstEvent = first;
+            stats->reassigned = nEv.size();
+            stats->rerendered = nRows.size();
+            stats->renumbered = renumEnd - j;
+            stats->measureShift = shift;
+            stats->converged = converged;
+        }
+    }
+
+    // 마디 m 의 줄을 newRows(output6 형식, 마디 번호 열은 무시)로 바꿈
+    //  - 새 줄의 시각은 (m-1)마디 끝부터 dt 누적, R/L/베이스 중 하나라도 있는 줄이 이벤트가 됨
+    //    (손 배정은 다시 하므로 R/L 은 "이 줄에서 칠 악기 두 개"로만 봄)
+    //  - 바로 다음 타격의 시각은 그대로 두고 간격(dt)만 다시 계산
+    bool editMeasure(int m, const std::vector<ScoreRow>& newRows, EditStats* stats, std::string& err) {
+        auto lo = std::lower_bound(rows_.begin(), rows_.end(), m, [](const ScoreRow& r, int v) { return r.measure < v; });
+        auto hi = std::upper_bound(rows_.begin(), rows_.end(), m, [](int v, const ScoreRow& r) { return v < r.measure; });
+        if (lo == hi) {
+            err = "마디 " + std::to_string(m) + " 없음";
+            return false;
+        }
+        long tStart = 0, tEnd;
+        for (auto it = rows_.begin(); it != lo; ++it) tStart += std::lround(it->dt * 1000.0);
+        tEnd = tStart;
+        for (auto it = lo; it != hi; ++it) tEnd += std::lround(it->dt * 1000.0);
+
+        size_t first = std::upper_bound(absMs_.begin(), absMs_.end(), tStart) - absMs_.begin();
+        size_t last = std::upper_bound(absMs_.begin(), absMs_.end(), tEnd) - absMs_.begin();
+
+        std::vector<FullEvent> repl;
+        long prev = first ? absMs_[first - 1] : 0;
+        long t = tStart;
+        for (const auto& r : newRows) {
+            t += std::lround(r.dt * 1000.0);
+            if (!r.R && !r.L && !r.bass) continue;
+            FullEvent e;
+            e.time = (t - prev) / 1000.0;
+            e.inst1 = r.R ? r.R : r.L;
+            e.inst2 = r.R ? r.L : 0;
+            e.bassHit = r.bass;
+            e.hihat = r.hihat;
+            repl.push_back(e);
+            prev = t;
+        }
+        if (last < ev_.size()) {
+            if (t > absMs_[last] || prev > absMs_[last]) {
+                err = "고친 마디가 다음 타격 시각(" + std::to_string(absMs_[last] / 1000.0) + "s)을 넘어감";
+                return false;
+            }
+            FullEvent next = ev_[last];
+            next.time = (absMs_[last] - prev) / 1000.0;
+            repl.push_back(next);
+            ++last;
+        }
+        replaceEvents(first, last, repl, stats);
+        return true;
+    }
+
+    const std::vector<ScoreRow>& rows() const { return rows_; }
+    const std::vector<FullEvent>& events() const { return ev_; }
+    int lastMeasure() const { return mAfter_.empty() ? 1 : mAfter_.back().measure; }
+    HandState finalHand() const { return after_.empty() ? initial_ : after_.back(); }
+    // 이벤트 event 앞까지 만든 줄 수 (= 이 이벤트가 만드는 첫 줄 위치)
+    size_t rowsBefore(size_t event) const { return event ? rowEnd_[event - 1] : 0; }
+
+    // newconvertToMeasureFile 과 같은 형식으로 출력
+    void writeRows(std::ostream& out) const { writeScoreText(out, rows_, lastMeasure()); }
+
+    bool write(const std::string& path) const {
+        std::ofstream out(path);
+        if (!out.is_open()) {
+            std::cerr << "출력 파일 생성 실패: " << path << "\n";
+            return false;
+        }
+        writeRows(out);
+        return true;
+    }
+
+    // 편집 결과를 다시 불러올 수 있도록 output3 형식으로 저장
+    bool writeEvents(const std::string& path) const {
+        std::ofstream out(path);
+        if (!out.is_open()) {
+            std::cerr << "출력 파일 생성 실패: " << path << "\n";
+            return false;
+        }
+        for (const auto& e : ev_)
+            out << std::fixed << std::setprecision(3) << e.time << std::setw(6) << e.inst1 << std::setw(6) << e.inst2
+                << std::setw(6) << 0 << std::setw(6) << 0 << std::setw(6) << e.bassHit << std::setw(6) << e.hihat << "\n";
+        return true;
+    }
+
+private:
+    // newconvertToMeasureFile 의 마디 나누기: 길이 time 인 줄 하나를 넣고 그 줄의 마디 번호 반환
+    static int advanceMeasure(MeasureState& ms, double time) {
+        constexpr double MEASURE = 2.4;
+        constexpr double EPS = 1e-9;
+        if (ms.acc + time > MEASURE + EPS) {
+            ++ms.measure;
+            ms.acc = 0.0;
+        }
+        int m = ms.measure;
+        ms.acc += time;
+        if (std::fabs(ms.acc - MEASURE) < 1e-7) {
+            ++ms.measure;
+            ms.acc = 0.0;
+        }
+        return m;
+    }
+
+    // newconvertToMeasureFile 의 쪼개기 (이벤트 하나분)
+    static void renderEvent(const FullEvent& e, MeasureState& ms, std::vector<ScoreRow>& out) {
+        constexpr double CHUNK = 0.6;
+        constexpr double EPS = 1e-9;
+        if (e.time <= 0) return;
+
+        const int rp = e.rightHand != 0, lp = e.leftHand != 0;
+        auto emit = [&](double time, bool hit) {
+            int m = advanceMeasure(ms, time);
+            out.push_back(hit ? ScoreRow{m, time, e.rightHand, e.leftHand, rp, lp, e.bassHit, e.hihat}
+                              : ScoreRow{m, time, 0, 0, 0, 0, 0, e.hihat});
+        };
+
+        int fullCnt = static_cast<int>((e.time + EPS) / CHUNK);
+        double leftover = e.time - fullCnt * CHUNK;
+        if (std::fabs(leftover) < 1e-7) leftover = 0.0;
+        if (fullCnt == 0 && leftover > EPS) {
+            emit(e.time, true);
+            return;
+        }
+        for (int i = 0; i < fullCnt; ++i) emit(CHUNK, (leftover <= EPS) && (i == fullCnt - 1));
+        if (leftover > EPS) emit(leftover, true);
+    }
+
+    template <typename T>
+    static void splice(std::vector<T>& v, size_t a, size_t b, const std::vector<T>& repl) {
+        size_t n = std::min(b - a, repl.size());
+        std::copy(repl.begin(), repl.begin() + n, v.begin() + a);
+        if (repl.size() > b - a) v.insert(v.begin() + b, repl.begin() + n, repl.end());
+        else v.erase(v.begin() + a + n, v.begin() + b);
+    }
+
+    HandState initial_;
+    std::vector<FullEvent> ev_;
+    std::vector<long> absMs_;             // 이벤트 타격 시각 [ms] (곡 시작 기준, 선두 줄 제외)
+    std::vector<HandState> after_;        // 이벤트 배정 후 손 상태
+    std::vector<MeasureState> mAfter_;    // 이벤트 변환 후 마디 상태
+    std::vector<size_t> rowEnd_;          // 이 이벤트까지 만든 줄 수
+    std::vector<ScoreRow> rows_;
+};
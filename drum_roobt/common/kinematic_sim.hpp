@@ -0,0 +1,130 @@
+#pragma once
+
+// 최종 악보 오프라인 운동 시뮬레이션 (로봇 없이 "이 속도로 칠 수 있나" 확인)
+//  - 두 스틱 끝이 drumXYZ 사이를 최대 속도/가속도 제한으로 움직인다고 보고 타격마다 실제 도착 시각을 계산
+//      실제 타격 = max(악보 시각, 같은 손 직전 실제 타격 + dwell + 이동 시간)
+//    → 늦으면 그 손의 다음 타격까지 밀려서 누적되는 것까지 반영 (motion_onset 은 줄마다 따로 봄)
+//  - 이동 시간은 motionTravelTime (사다리꼴 속도 프로파일, 정지 → 정지)
+//  - 이동 시간은 악기 순서로만 정해지므로 곡을 읽을 때 한 번만 계산 → 속도를 바꿔 돌릴 때는 곱셈/max 만
+//    (5분 곡 한 번에 수십 us, bpm 스윕도 가벼움)
+//  - 발(베이스)은 스틱과 따로 움직이므로 보지 않음, 두 스틱 충돌도 보지 않음
+//
+// 사용 예)
+//   SimScore score;
+//   score.load("output6_final_x.txt", prof);
+//   SimResult r;
+//   simulateScore(score, 120.0, 0.02f, 0.010f, r);   // 120% 속도, dwell 20ms, 허용 10ms
+//   if (r.late) ...
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+#include "text_reader.hpp"
+#include "drum_kit.hpp"
+#include "motion_onset.hpp"
+
+struct SimHit {
+    uint32_t row;      // 악보 줄 번호 (선두 줄 포함 0부터)
+    int32_t measure;
+    uint8_t hand;      // 0 R, 1 L
+    uint8_t inst;
+    float sched;       // 악보 시각 [s] (속도 반영)
+    float actual;      // 실제 타격 시각 [s]
+};
+
+struct SimResult {
+    std::vector<SimHit> hits;   // keepHits 일 때만 채움
+    float maxErr = 0.0f;        // 가장 늦은 타격 [s]
+    double sumErr = 0.0;
+    uint32_t hitCount = 0;
+    uint32_t late = 0;          // 허용 오차를 넘은 타격 수
+    int32_t firstLateMeasure = -1;
+
+    double meanErr() const { return hitCount ? sumErr / hitCount : 0.0; }
+};
+
+class SimScore {
+public:
+    // 손마다 타격만 모은 배열 (악보 순서)
+    struct Hand {
+        std::vector<double> t;          // 100% 속도 타격 시각
+        std::vector<float> travel;      // 직전 타격 악기 → 이번 악기 이동 시간
+        std::vector<uint32_t> row;
+        std::vector<int32_t> measure;
+        std::vector<uint8_t> inst;
+    };
+    Hand hand[2];
+    double length = 0.0;   // 마지막 줄 시각
+
+    bool load(const std::string& path, const MotionProfile& prof) {
+        TextReader in(path);
+        if (!in.is_open()) {
+            std::cerr << "입력 파일 열기 실패: " << path << "\n";
+            return false;
+        }
+        for (auto& h : hand) h = Hand{};
+        int prev[2] = {1, 1};   // HandState 와 같이 스네어에서 시작
+        std::string_view line, f[8];
+        double t = 0.0;
+        uint32_t row = 0;
+        while (in.nextLine(line)) {
+            if (splitFields(line, f, 8) < 8) continue;
+            int measure, inst[2];
+            double dt;
+            if (!toInt(f[0], measure) || !toDouble(f[1], dt) || !toInt(f[2], inst[0]) || !toInt(f[3], inst[1])) continue;
+            if (measure == -1) break;
+            t += dt;
+            for (int h = 0; h < 2; ++h) {
+                int cur = inst[h];
+                if (cur <= 0 || cur >= NUM_INST) continue;
+                Hand& H = hand[h];
+                H.t.push_back(t);
+                H.travel.push_back(motionTravelTime(static_cast<float>(dist(drumXYZ[prev[h]], drumXYZ[cur])), prof));
+                H.row.push_back(row);
+                H.measure.push_back(measure);
+                H.inst.push_back(static_cast<uint8_t>(cur));
+                prev[h] = cur;
+            }
+            ++row;
+        }
+        length = t;
+        return true;
+    }
+
+    size_t hitCount() const { return hand[0].t.size() + hand[1].t.size(); }
+};
+
+// speedPct: 100 이 원래 속도 (200 이면 시각이 절반), dwell: 타격 후 스틱이 떠나기까지 [s], tol: 허용 오차 [s]
+inline void simulateScore(const SimScore& score, double speedPct, float dwell, float tol, SimResult& res,
+                          bool keepHits = false) {
+    res = SimResult{};
+    const double scale = 100.0 / speedPct;
+    for (int h = 0; h < 2; ++h) {
+        const SimScore::Hand& H = score.hand[h];
+        double ready = 0.0;   // 이 손이 다음 악기로 출발할 수 있는 시각
+        for (size_t k = 0; k < H.t.size(); ++k) {
+            double sched = H.t[k] * scale;
+            double actual = std::max(sched, ready + H.travel[k]);
+            float err = static_cast<float>(actual - sched);
+            ready = actual + dwell;
+
+            res.sumErr += err;
+            res.maxErr = std::max(res.maxErr, err);
+            if (err > tol) {
+                ++res.late;
+                if (res.firstLateMeasure < 0 || H.measure[k] < res.firstLateMeasure) res.firstLateMeasure = H.measure[k];
+            }
+            if (keepHits)
+                res.hits.push_back({H.row[k], H.measure[k], static_cast<uint8_t>(h), H.inst[k],
+                                    static_cast<float>(sched), static_cast<float>(actual)});
+        }
+        res.hitCount += static_cast<uint32_t>(H.t.size());
+    }
+    if (keepHits)
+        std::sort(res.hits.begin(), res.hits.end(), [](const SimHit& a, const SimHit& b) {
+            return a.row != b.row ? a.row < b.row : a.hand < b.hand;
+        });
+}
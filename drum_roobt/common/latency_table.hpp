@@ -0,0 +1,218 @@
+#pragma once
+
+// 악기별 기구 지연 보정표 (악기 × 손 × 세기 구간 → ms)
+//  - 심벌은 스네어보다 높이 있고, 베이스 페달은 스틱과 구동 방식이 달라서 "보낸 시각 → 실제 타격" 지연이 다름
+//  - 최종 악보를 내보낼 때 손/발 명령마다 지연만큼 먼저 보내도록 줄을 나눠서 다시 배치
+//    → 실제 타격 시각은 원래 악보와 같아짐 (세기/하이햇 상태는 그대로)
+//
+// 보정표 파일 (공백/탭/콤마, # 주석, 첫 줄 헤더 허용):
+//   inst hand vel ms
+//   7    R    2   31.5        (hand: R / L / F(발), vel: 세기 구간 0~3)
+// 없는 칸은 0ms
+//
+// 세기 구간 = MIDI 벨로시티 / 40 반올림 (0~3), Velfile.txt(MakeVelocitySummary) 의 drum_avg / cymbal_avg 와 같은 단위
+//  - output6 의 Rp/Lp 열은 타격 여부(0/1)라서 세기로 쓸 수 없음 → 세기는 Velfile.txt 에서 마디 단위로 가져옴
+//    (Velfile 의 구간은 원곡 템포 한 마디, output6 은 100 bpm 기준 마디이므로 i 번째 구간 = i+1 마디)
+//  - 베이스는 Velfile 에 따로 없어서 드럼(1~4) 평균을 씀. Velfile 이 없으면 모두 구간 0
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <iomanip>
+#include <cmath>
+#include <cstdint>
+
+#include "text_reader.hpp"
+
+const int LAT_INST = 11;        // 0~8 손 악기, 10 베이스
+const int LAT_HANDS = 3;        // 0 R, 1 L, 2 발
+const int LAT_VEL_BUCKETS = 4;  // 세기 구간 0~3 (MIDI 벨로시티 0~19 / 20~59 / 60~99 / 100~127)
+
+// MIDI 벨로시티(0~127) → 세기 구간 (MakeVelocitySummary 의 평균 / 40 반올림과 같은 규칙)
+inline int latencyBucket(int midiVelocity) {
+    return std::clamp(static_cast<int>(std::lround(midiVelocity / 40.0)), 0, LAT_VEL_BUCKETS - 1);
+}
+
+inline int latencyHandIndex(std::string_view s) {
+    if (s.empty()) return -1;
+    switch (s[0]) {
+        case 'R': case 'r': case '0': return 0;
+        case 'L': case 'l': case '1': return 1;
+        case 'F': case 'f': case '2': return 2;
+        default: return -1;
+    }
+}
+
+inline const char* latencyHandName(int h) {
+    static const char* names[LAT_HANDS] = {"R", "L", "F"};
+    return names[h];
+}
+
+struct LatencyTable {
+    float ms[LAT_INST][LAT_HANDS][LAT_VEL_BUCKETS] = {};
+
+    float get(int inst, int hand, int bucket) const {
+        if (inst < 0 || inst >= LAT_INST) return 0.0f;
+        return ms[inst][hand][std::clamp(bucket, 0, LAT_VEL_BUCKETS - 1)];
+    }
+
+    bool load(const std::string& path) {
+        TextReader in(path);
+        if (!in.is_open()) return false;
+        std::string_view line, f[4];
+        while (in.nextLine(line)) {
+            line = trimView(line);
+            if (line.empty() || line[0] == '#') continue;
+            if (splitFields(line, f, 4) < 4) continue;
+            int inst, bucket, hand = latencyHandIndex(f[1]);
+            double v;
+            if (hand < 0 || !toInt(f[0], inst) || !toInt(f[2], bucket) || !toDouble(f[3], v)) continue; // 헤더 포함
+            if (inst < 0 || inst >= LAT_INST || bucket < 0 || bucket >= LAT_VEL_BUCKETS) continue;
+            ms[inst][hand][bucket] = static_cast<float>(v);
+        }
+        return true;
+    }
+
+    bool save(const std::string& path) const {
+        std::ofstream out(path);
+        if (!out.is_open()) return false;
+        out << "inst\thand\tvel\tms\n" << std::fixed << std::setprecision(2);
+        for (int i = 0; i < LAT_INST; ++i)
+            for (int h = 0; h < LAT_HANDS; ++h)
+                for (int b = 0; b < LAT_VEL_BUCKETS; ++b)
+                    if (ms[i][h][b] != 0.0f) out << i << '\t' << latencyHandName(h) << '\t' << b << '\t' << ms[i][h][b] << '\n';
+        return true;
+    }
+};
+
+// Velfile.txt (start_time end_time drum_avg cymbal_avg) → 마디별 세기 구간
+struct VelocityLevels {
+    std::vector<int> drum, cymbal;
+
+    bool load(const std::string& path) {
+        drum.clear();
+        cymbal.clear();
+        TextReader in(path);
+        if (!in.is_open()) return false;
+        std::string_view line, f[4];
+        while (in.nextLine(line)) {
+            double t0, t1;
+            int d, c;
+            if (splitFields(line, f, 4) < 4 || !toDouble(f[0], t0) || !toDouble(f[1], t1) || !toInt(f[2], d) ||
+                !toInt(f[3], c)) continue;   // 헤더
+            drum.push_back(d);
+            cymbal.push_back(c);
+        }
+        return true;
+    }
+
+    // inst: 1~4 드럼, 5~8 심벌, 10 베이스(드럼 평균). 구간 밖이면 0
+    int bucket(int measure, int inst) const {
+        const std::vector<int>& v = (inst >= 5 && inst <= 8) ? cymbal : drum;
+        if (measure < 1 || measure > static_cast<int>(v.size())) return 0;
+        return std::clamp(v[measure - 1], 0, LAT_VEL_BUCKETS - 1);
+    }
+};
+
+// 최종 악보(output6 형식)를 읽어 보정표만큼 명령을 앞당긴 악보로 씀
+//  - 줄마다 R / L / 발 명령을 따로 떼어 (타격 시각 - 지연) 에 배치하고, 보낼 시각이 같은 같은 줄의 명령은 다시 한 줄로 합침
+//  - 빈 줄(타이밍용)은 지연 0 으로 그대로, 선두 줄과 종료 줄(-1)은 그대로 복사
+//  - 보낼 시각이 곡 시작(0)보다 앞서면 0 으로 자름 (선두 줄 0.6초가 있어서 보통은 생기지 않음)
+//  - 앞당긴 뒤 다시 맞추는 것
+//      · 줄 간격이 0.6초를 넘으면 (타격 줄 뒤 빈 줄처럼 앞 줄만 당겨진 경우) 0.6초 빈 줄을 끼워 넣음
+//      · 마디 번호는 줄 순서대로 줄어들지 않게 (다음 마디 명령이 앞 마디 빈 줄보다 먼저 나가면 그 뒤 줄은 다음 마디)
+//  - 간격은 ms 단위라 0.05 격자에 있지 않음 (_lat 악보는 ms 해상도로 읽는 쪽 전용, score_wire 도 ms 로 보냄)
+// vel: 마디별 세기 (없으면 모든 명령을 세기 구간 0 으로)
+inline bool applyLatencyTable(const std::string& inputFile, const std::string& outputFile, const LatencyTable& table,
+                              const VelocityLevels* vel = nullptr) {
+    struct Row { int measure; double t; int R, L, Rp, Lp, bass, hihat; };
+    struct Part { double send; uint32_t row; uint8_t mask; };   // mask: 1 R, 2 L, 4 발
+
+    TextReader in(inputFile);
+    if (!in.is_open()) {
+        std::cerr << "입력 파일 열기 실패: " << inputFile << "\n";
+        return false;
+    }
+    std::vector<Row> rows;
+    std::string endLine;
+    bool first = true;
+    Row lead{};
+    std::string_view line, f[8];
+    double t = 0.0;
+    while (in.nextLine(line)) {
+        if (splitFields(line, f, 8) < 8) continue;
+        Row r;
+        double dt;
+        if (!toInt(f[0], r.measure) || !toDouble(f[1], dt) || !toInt(f[2], r.R) || !toInt(f[3], r.L) ||
+            !toInt(f[4], r.Rp) || !toInt(f[5], r.Lp) || !toInt(f[6], r.bass) || !toInt(f[7], r.hihat)) continue;
+        if (r.measure == -1) {
+            endLine = std::string(line);
+            break;
+        }
+        t += dt;
+        r.t = t;
+        if (first) {           // 선두 더미 줄
+            lead = r;
+            first = false;
+            continue;
+        }
+        rows.push_back(r);
+    }
+
+    std::vector<Part> parts;
+    parts.reserve(rows.size() * 2);
+    for (uint32_t i = 0; i < rows.size(); ++i) {
+        const Row& r = rows[i];
+        auto bucket = [&](int inst) { return vel ? vel->bucket(r.measure, inst) : 0; };
+        double lat[3] = {r.R ? table.get(r.R, 0, bucket(r.R)) : 0.0, r.L ? table.get(r.L, 1, bucket(r.L)) : 0.0,
+                         r.bass ? table.get(10, 2, bucket(10)) : 0.0};
+        uint8_t has = (r.R ? 1 : 0) | (r.L ? 2 : 0) | (r.bass ? 4 : 0);
+        if (!has) {
+            parts.push_back({r.t, i, 0});
+            continue;
+        }
+        // 지연이 같은 명령끼리는 한 줄로
+        uint8_t done = 0;
+        for (int a = 0; a < 3; ++a) {
+            if (!(has & (1 << a)) || (done & (1 << a))) continue;
+            uint8_t mask = 0;
+            for (int b = a; b < 3; ++b)
+                if ((has & (1 << b)) && lat[b] == lat[a]) mask |= 1 << b;
+            done |= mask;
+            parts.push_back({std::max(lead.t, r.t - lat[a] / 1000.0), i, mask});
+        }
+    }
+    // 지연은 수십 ms 이내라 거의 정렬된 상태 → 안정 정렬로 같은 시각이면 원래 줄 순서 유지
+    std::stable_sort(parts.begin(), parts.end(), [](const Part& a, const Part& b) { return a.send < b.send; });
+
+    std::ofstream out(outputFile);
+    if (!out.is_open()) {
+        std::cerr << "출력 파일 생성 실패: " << outputFile << "\n";
+        return false;
+    }
+    out << std::fixed << std::setprecision(3);
+    out << lead.measure << "\t " << lead.t << "\t " << lead.R << "\t " << lead.L << "\t " << lead.Rp << "\t "
+        << lead.Lp << "\t " << lead.bass << "\t " << lead.hihat << "\n";
+    // dt 는 ms 단위로 반올림한 보낼 시각의 차이 (누적 오차 없음)
+    long prevMs = std::lround(lead.t * 1000.0);
+    int measure = lead.measure;
+    for (const Part& p : parts) {
+        const Row& r = rows[p.row];
+        long ms = std::lround(p.send * 1000.0);
+        measure = std::max(measure, r.measure);
+        while (ms - prevMs > 600) {
+            out << measure << "\t " << 0.600 << "\t 0\t 0\t 0\t 0\t 0\t " << r.hihat << "\n";
+            prevMs += 600;
+        }
+        bool all = p.mask == 0;
+        out << measure << "\t " << (ms - prevMs) / 1000.0 << "\t "
+            << ((all || (p.mask & 1)) ? r.R : 0) << "\t " << ((all || (p.mask & 2)) ? r.L : 0) << "\t "
+            << ((all || (p.mask & 1)) ? r.Rp : 0) << "\t " << ((all || (p.mask & 2)) ? r.Lp : 0) << "\t "
+            << ((all || (p.mask & 4)) ? r.bass : 0) << "\t " << r.hihat << "\n";
+        prevMs = ms;
+    }
+    if (!endLine.empty()) out << endLine << "\n";
+    return true;
+}
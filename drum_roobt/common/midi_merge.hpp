@@ -0,0 +1,141 @@
+#pragma once
+
+// 여러 MTrk 를 절대 tick 순서로 합쳐서 하나의 이벤트 스트림으로 읽기 (k-way merge)
+//  - 트랙마다 커서(위치, 누적 tick, running status)만 들고 다음 이벤트를 그때그때 해석 → 트랙 전체를 미리 풀어두지 않음
+//  - 커서들의 "다음 이벤트 tick" 을 작은 힙(트랙 수 T 크기)에 넣고 가장 이른 것부터 꺼냄 → O(N log T)
+//  - 같은 tick 이면 트랙 번호가 작은 쪽이 먼저, 같은 트랙 안에서는 파일 순서 유지 (안정 정렬과 같은 결과)
+//
+// 사용 예)
+//   MidiTrackMerger merger(midiData);
+//   MidiEvent ev;
+//   while (merger.next(ev)) { ... ev.tick, ev.status, ev.pos ... }
+
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+struct MidiEvent {
+    uint64_t tick;      // 곡 시작부터의 절대 tick
+    int track;          // MTrk 번호 (0부터)
+    unsigned char status; // 0x80~0xEF 채널 메시지, 0xFF 메타, 0xF0/0xF7 SysEx
+    size_t pos;         // 원본 버퍼에서 상태 바이트 다음(데이터 첫 바이트) 위치. 메타는 타입 바이트 위치
+    size_t len;         // 데이터 길이 (메타/SysEx 는 타입/길이 바이트 포함)
+};
+
+class MidiTrackMerger {
+public:
+    explicit MidiTrackMerger(const std::vector<unsigned char>& data) : data_(data) {
+        if (data_.size() < 14) return;
+        size_t hdrLen = be32(4);
+        tpqn_ = (data_[12] << 8) | data_[13];
+
+        // 청크 목록에서 MTrk 만 커서로 등록 (그 외 청크는 건너뜀)
+        size_t pos = 8 + hdrLen;
+        while (pos + 8 <= data_.size()) {
+            size_t chunkLen = be32(pos + 4);
+            size_t body = pos + 8;
+            size_t end = std::min(body + chunkLen, data_.size());
+            if (data_[pos] == 'M' && data_[pos+1] == 'T' && data_[pos+2] == 'r' && data_[pos+3] == 'k') {
+                Cursor c;
+                c.pos = body;
+                c.end = end;
+                cursors_.push_back(c);
+            }
+            pos = body + chunkLen;
+        }
+
+        for (size_t t = 0; t < cursors_.size(); ++t) {
+            if (readDelta(cursors_[t])) heap_.push({cursors_[t].tick, static_cast<int>(t)});
+        }
+    }
+
+    int tpqn() const { return tpqn_; }
+    size_t trackCount() const { return cursors_.size(); }
+
+    // 다음 이벤트 (tick 순). 더 없으면 false
+    bool next(MidiEvent& ev) {
+        while (!heap_.empty()) {
+            int t = heap_.top().second;
+            heap_.pop();
+            Cursor& c = cursors_[t];
+            bool ok = decode(c, ev);
+            ev.track = t;
+            if (ok && c.pos < c.end && readDelta(c)) heap_.push({c.tick, t});
+            if (ok) return true;
+        }
+        return false;
+    }
+
+private:
+    struct Cursor {
+        size_t pos = 0, end = 0;
+        uint64_t tick = 0;
+        unsigned char running = 0;
+    };
+
+    size_t be32(size_t p) const {
+        return (static_cast<size_t>(data_[p]) << 24) | (data_[p+1] << 16) | (data_[p+2] << 8) | data_[p+3];
+    }
+
+    bool readVlq(Cursor& c, size_t& value) const {
+        value = 0;
+        while (c.pos < c.end) {
+            unsigned char byte = data_[c.pos++];
+            value = (value << 7) | (byte & 0x7F);
+            if ((byte & 0x80) == 0) return true;
+        }
+        return false;
+    }
+
+    bool readDelta(Cursor& c) {
+        size_t delta;
+        if (!readVlq(c, delta)) return false;
+        c.tick += delta;
+        return c.pos < c.end;
+    }
+
+    // 커서 위치의 이벤트 하나를 해석하고 커서를 이벤트 끝으로 옮김
+    bool decode(Cursor& c, MidiEvent& ev) {
+        if (c.pos >= c.end) return false;
+        unsigned char status = data_[c.pos];
+        if (status & 0x80) {
+            c.pos++;
+            if (status < 0xF0) c.running = status; // 메타/SysEx 는 running status 에 영향 없음
+        } else {
+            status = c.running;
+            if (status == 0) return false;         // running status 없이 데이터 바이트 → 트랙 손상
+        }
+
+        ev.tick = c.tick;
+        ev.status = status;
+        ev.pos = c.pos;
+
+        if (status == 0xFF) {
+            if (c.pos >= c.end) return false;
+            c.pos++;                                // 메타 타입
+            size_t len;
+            if (!readVlq(c, len)) return false;
+            c.pos += len;
+        } else if (status == 0xF0 || status == 0xF7) {
+            size_t len;
+            if (!readVlq(c, len)) return false;
+            c.pos += len;
+        } else {
+            unsigned char hi = status & 0xF0;
+            c.pos += (hi == 0xC0 || hi == 0xD0) ? 1 : 2;
+        }
+        if (c.pos > c.end) return false;
+        ev.len = c.pos - ev.pos;
+        return true;
+    }
+
+    using Item = std::pair<uint64_t, int>; // (다음 이벤트 tick, 트랙 번호)
+    const std::vector<unsigned char>& data_;
+    int tpqn_ = 0;
+    std::vector<Cursor> cursors_;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> heap_;
+};
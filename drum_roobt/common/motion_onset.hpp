@@ -0,0 +1,112 @@
+#pragma once
+
+// 손별 이동 시작 시각 계산 (타격 시각만 있는 악보 → "언제 움직이기 시작해야 하는가")
+//  - 이동 시간은 최대 속도/가속도 사다리꼴 속도 프로파일로 계산
+//      거리 d < vmax²/amax  : 삼각형 프로파일  T = 2·sqrt(d / amax)
+//      그 외               : 사다리꼴        T = d / vmax + vmax / amax
+//    여기에 움직이기 전 스틱을 드는 시간(lift)을 더함 (같은 악기 연타는 이동 없음 → 0)
+//  - 이동 시작 = 타격 시각 - T, 여유 = 이동 시작 - 같은 손 직전 타격 시각 (음수면 직전 타격 전에 움직여야 함 → 표시)
+//  - 계산 순서: (1) 손마다 타격 줄만 골라 이동 벡터(dx,dy,dz)와 간격을 SoA 배열로 모음
+//              (2) 곡 전체에 대해 분기 없는 float 루프 한 번 (삼각/사다리꼴은 min/max 로 합침)
+//                  → -O3 -fno-math-errno -fno-trapping-math 에서 자동 벡터화 (SSE2 기준 4줄씩)
+//              (3) 결과를 원래 줄 위치에 되돌려 씀
+//  - 손 시작 위치는 HandState 와 같이 스네어(1번), 시작 시각 0
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+#include "drum_kit.hpp"
+
+struct MotionProfile {
+    float vmax = 4.0f;     // 스틱 최대 이동 속도 [m/s]
+    float amax = 30.0f;    // 최대 가속도 [m/s^2]
+    float lift = 0.0f;     // 이동 전 들어올리는 시간 [s]
+};
+
+// 정지 → 정지 이동 한 번의 시간 (아래 벡터 루프와 같은 식, 스칼라 버전)
+inline float motionTravelTime(float d, const MotionProfile& prof) {
+    if (d <= 0.0f) return 0.0f;
+    const float dCross = prof.vmax * prof.vmax / prof.amax;
+    return 2.0f * std::sqrt(std::min(d, dCross) / prof.amax) + std::max(d - dCross, 0.0f) / prof.vmax + prof.lift;
+}
+
+const uint8_t MOTION_LATE_R = 1 << 0;   // 오른손: 직전 타격 전에 움직이기 시작해야 함
+const uint8_t MOTION_LATE_L = 1 << 1;
+
+struct MotionPlan {
+    std::vector<float> leadR, leadL;     // 타격 몇 초 전에 움직이기 시작해야 하는지 (타격 없으면 0)
+    std::vector<float> slackR, slackL;   // 이동 시작 - 직전 타격 (타격 없으면 0)
+    std::vector<uint8_t> flags;          // MOTION_LATE_*
+};
+
+namespace motion_detail {
+
+// 손 하나: inst[i] != 0 인 줄만 처리
+inline void planHand(const std::vector<double>& t, const std::vector<int>& inst, const MotionProfile& prof,
+                     std::vector<float>& lead, std::vector<float>& slack, std::vector<uint8_t>& flags, uint8_t lateBit) {
+    size_t n = t.size();
+    lead.assign(n, 0.0f);
+    slack.assign(n, 0.0f);
+
+    // (1) 타격 줄 골라서 SoA 로
+    std::vector<uint32_t> idx;
+    std::vector<float> dx, dy, dz, gap;
+    idx.reserve(n); dx.reserve(n); dy.reserve(n); dz.reserve(n); gap.reserve(n);
+    int prevInst = 1;
+    double prevT = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        int cur = inst[i];
+        if (cur <= 0 || cur >= NUM_INST) continue;
+        const Coord& a = drumXYZ[prevInst];
+        const Coord& b = drumXYZ[cur];
+        idx.push_back(static_cast<uint32_t>(i));
+        dx.push_back(static_cast<float>(b.x - a.x));
+        dy.push_back(static_cast<float>(b.y - a.y));
+        dz.push_back(static_cast<float>(b.z - a.z));
+        gap.push_back(static_cast<float>(t[i] - prevT));
+        prevInst = cur;
+        prevT = t[i];
+    }
+
+    // (2) 분기 없는 루프 (벡터화 대상)
+    size_t m = idx.size();
+    std::vector<float> T(m), S(m);
+    const float v = prof.vmax, a = prof.amax, lift = prof.lift;
+    const float invA = 1.0f / a, invV = 1.0f / v, dCross = v * v * invA;
+    const float* px = dx.data();
+    const float* py = dy.data();
+    const float* pz = dz.data();
+    const float* pg = gap.data();
+    float* pT = T.data();
+    float* pS = S.data();
+    for (size_t k = 0; k < m; ++k) {
+        float d = std::sqrt(px[k] * px[k] + py[k] * py[k] + pz[k] * pz[k]);
+        // 가속 구간(최대 dCross 까지) + 등속 구간. d < dCross 면 삼각형, 아니면 사다리꼴과 같은 값
+        float travel = 2.0f * std::sqrt(std::min(d, dCross) * invA) + std::max(d - dCross, 0.0f) * invV;
+        // 이동이 있을 때만 lift (악기 간 거리는 수 cm 이상이므로 d·1e6 을 1 로 자름)
+        travel += lift * std::min(d * 1e6f, 1.0f);
+        pT[k] = travel;
+        pS[k] = pg[k] - travel;
+    }
+
+    // (3) 원래 줄 위치로
+    for (size_t k = 0; k < m; ++k) {
+        uint32_t i = idx[k];
+        lead[i] = T[k];
+        slack[i] = S[k];
+        if (S[k] < 0.0f) flags[i] |= lateBit;
+    }
+}
+
+} // namespace motion_detail
+
+// t: 곡 시작부터 누적 타격 시각 [s], R/L: 줄마다 손 악기 번호
+inline void planMotion(const std::vector<double>& t, const std::vector<int>& R, const std::vector<int>& L,
+                       const MotionProfile& prof, MotionPlan& plan) {
+    plan.flags.assign(t.size(), 0);
+    motion_detail::planHand(t, R, prof, plan.leadR, plan.slackR, plan.flags, MOTION_LATE_R);
+    motion_detail::planHand(t, L, prof, plan.leadL, plan.slackL, plan.flags, MOTION_LATE_L);
+}
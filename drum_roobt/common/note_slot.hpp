@@ -0,0 +1,45 @@
+#pragma once
+
+// 같은 시각에 동시에 치는 노트 묶음 (convertMcToC / merge_events_and_save 용)
+//  - 노트마다 std::vector 를 만들지 않고 고정 크기 슬롯에 바로 기록 → 묶는 과정에서 힙 할당 없음
+//  - 손으로 치는 악기 두 개(inst1, inst2)는 들어온 순서대로 앞에서부터 채움 (기존 우선순위와 동일, 세 번째부터는 버림)
+//  - 베이스/하이햇 같은 상태는 비트 플래그, 들어온 노트 전체는 16비트 마스크로 보관
+//  - 노트 → (손 악기, 플래그) 변환은 파일마다 규칙이 달라서 NoteSlotTable 로 넘겨받음
+
+#include <cstdint>
+
+const uint8_t SLOT_BASS      = 1 << 0;  // 베이스 드럼
+const uint8_t SLOT_HH_CLOSED = 1 << 1;  // 하이햇 닫힘 신호
+const uint8_t SLOT_HH_OPEN   = 1 << 2;  // 하이햇 열림 신호
+
+struct NoteSlotTable {
+    uint8_t hand[16];   // 노트 번호 → 손으로 칠 악기 번호 (0 이면 손 악기 아님)
+    uint8_t flags[16];  // 노트 번호 → SLOT_* 플래그
+};
+
+struct NoteSlot {
+    double time;
+    uint16_t mask;      // 들어온 노트 번호 비트마스크 (1 << note)
+    uint8_t hand[3];    // hand[0] = inst1, hand[1] = inst2, hand[2] 는 넘칠 때 쓰는 빈 칸
+    uint8_t nHand;
+    uint8_t flags;
+
+    // 분기 없이 기록: 손 악기가 아니거나 이미 두 개면 빈 칸에 쓰고 개수는 그대로
+    void add(int note, const NoteSlotTable& t) {
+        uint8_t h = t.hand[note & 15];
+        hand[nHand] = h;
+        nHand += (h != 0) & (nHand < 2);
+        hand[2] = 0;
+        flags |= t.flags[note & 15];
+        mask |= static_cast<uint16_t>(1u << (note & 15));
+    }
+
+    int inst1() const { return nHand > 0 ? hand[0] : 0; }
+    int inst2() const { return nHand > 1 ? hand[1] : 0; }
+};
+
+inline NoteSlot makeNoteSlot(double time, int note, const NoteSlotTable& t) {
+    NoteSlot s{time, 0, {0, 0, 0}, 0, 0};
+    s.add(note, t);
+    return s;
+}
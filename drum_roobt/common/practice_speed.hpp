@@ -0,0 +1,170 @@
+#pragma once
+
+// 연습 속도(70%, 85%, 110% ...) 악보 다시 만들기
+//  - 최종 악보(output6)를 0.05초 tick 정수로 한 번만 읽어 둠 (TickScore)
+//  - 마디 안 누적 tick 을 100/속도 배로 늘리고 다시 tick 에 반올림 → 줄마다 한 번씩만 보는 O(n)
+//  - 마디 단위로 따로 계산하므로 마디 경계는 정확히 유지되고, 속도는 마디마다 바꿀 수 있음
+//  - 늘어난 간격이 0.6초(12 tick)를 넘으면 newconvertToMeasureFile 과 같이 빈 줄로 나눠서 한 줄 간격 ≤ 0.6초 유지
+//  - 디스패처가 돌고 있는 중에도 setSpeed() 로 바꾸면 다음 마디부터 적용 (atomic)
+//
+// 사용 예)
+//   TickScore score;
+//   score.load("output6_final_x.txt");
+//   PracticeRenderer r(score, 85);
+//   std::vector<TickRow> rows;
+//   while (r.renderMeasure(rows)) { ... }     // 다른 스레드에서 r.setSpeed(70)
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+#include "text_reader.hpp"
+
+const double PRACTICE_TICK_SEC = 0.05;   // roundDurationsToStepSet100 의 step
+const uint32_t PRACTICE_CHUNK_TICKS = 12; // 0.6초 (newconvertToMeasureFile 의 CHUNK)
+const int PRACTICE_MIN_SPEED = 25;
+const int PRACTICE_MAX_SPEED = 200;
+
+struct TickRow {
+    int32_t measure;
+    uint32_t dt;           // 직전 줄부터 tick 수
+    uint8_t R, L, Rpow, Lpow, bass, hihat;
+};
+
+class TickScore {
+public:
+    bool load(const std::string& path) {
+        TextReader in(path);
+        if (!in.is_open()) {
+            std::cerr << "입력 파일 열기 실패: " << path << "\n";
+            return false;
+        }
+        rows.clear();
+        measureBegin.clear();
+        hasLead = hasEnd = false;
+        rows.reserve(in.size() / 24 + 1);
+
+        std::string_view line, f[8];
+        while (in.nextLine(line)) {
+            if (splitFields(line, f, 8) < 8) continue;
+            int v[8];
+            double dt;
+            if (!toInt(f[0], v[0]) || !toDouble(f[1], dt)) continue;
+            bool ok = true;
+            for (int i = 2; i < 8 && ok; ++i) ok = toInt(f[i], v[i]);
+            if (!ok) continue;
+            TickRow r{v[0], static_cast<uint32_t>(std::max(0L, std::lround(dt / PRACTICE_TICK_SEC))),
+                      (uint8_t)v[2], (uint8_t)v[3], (uint8_t)v[4], (uint8_t)v[5], (uint8_t)v[6], (uint8_t)v[7]};
+            if (r.measure == -1) {             // 종료 줄은 그대로 복사
+                end = r;
+                hasEnd = true;
+                break;
+            }
+            if (!hasLead && rows.empty()) {    // 선두 더미 줄(준비 시간)도 그대로
+                lead = r;
+                hasLead = true;
+                continue;
+            }
+            if (rows.empty() || rows.back().measure != r.measure) measureBegin.push_back(rows.size());
+            rows.push_back(r);
+        }
+        measureBegin.push_back(rows.size());
+        return true;
+    }
+
+    size_t measureCount() const { return measureBegin.empty() ? 0 : measureBegin.size() - 1; }
+
+    std::vector<TickRow> rows;            // 선두/종료 줄 제외
+    std::vector<size_t> measureBegin;     // 마디 m 의 줄 = rows[measureBegin[m] .. measureBegin[m+1])
+    TickRow lead{}, end{};
+    bool hasLead = false, hasEnd = false;
+};
+
+class PracticeRenderer {
+public:
+    PracticeRenderer(const TickScore& score, int speedPct = 100) : score_(score) { setSpeed(speedPct); }
+
+    // 어느 스레드에서 불러도 됨. 렌더 중인 마디는 그대로, 다음 마디부터 적용
+    void setSpeed(int pct) {
+        speed_.store(std::clamp(pct, PRACTICE_MIN_SPEED, PRACTICE_MAX_SPEED), std::memory_order_relaxed);
+    }
+    int speed() const { return speed_.load(std::memory_order_relaxed); }
+
+    void reset() { next_ = 0; }
+    size_t nextMeasure() const { return next_; }
+
+    // 다음 마디 하나를 현재 속도로 만들어 out 뒤에 붙임. 더 없으면 false
+    bool renderMeasure(std::vector<TickRow>& out, int* usedPct = nullptr) {
+        if (next_ >= score_.measureCount()) return false;
+        int pct = speed();
+        if (usedPct) *usedPct = pct;
+        size_t b = score_.measureBegin[next_], e = score_.measureBegin[next_ + 1];
+        ++next_;
+
+        uint64_t acc = 0;        // 원래 마디 안 누적 tick
+        uint64_t prevNew = 0;    // 바뀐 마디 안 누적 tick (직전 줄)
+        for (size_t i = b; i < e; ++i) {
+            const TickRow& r = score_.rows[i];
+            acc += r.dt;
+            // 반올림: acc * 100 / pct
+            uint64_t cur = (acc * 100 + pct / 2) / pct;
+            // 원래 간격이 있던 줄은 빨라져도 최소 1 tick 유지
+            if (r.dt > 0 && cur <= prevNew) cur = prevNew + 1;
+            uint32_t dt = static_cast<uint32_t>(cur - prevNew);
+            prevNew = cur;
+            emitSplit(r, dt, out);
+        }
+        return true;
+    }
+
+    // 곡 전체를 한 속도로
+    static void renderAll(const TickScore& score, int pct, std::vector<TickRow>& out) {
+        PracticeRenderer r(score, pct);
+        out.clear();
+        out.reserve(score.rows.size() * 2);
+        while (r.renderMeasure(out)) {}
+    }
+
+private:
+    // 0.6초를 넘는 간격은 빈 줄로 나누고 마지막 조각에서 침 (하이햇 상태는 유지)
+    static void emitSplit(const TickRow& r, uint32_t dt, std::vector<TickRow>& out) {
+        while (dt > PRACTICE_CHUNK_TICKS) {
+            TickRow gap{r.measure, PRACTICE_CHUNK_TICKS, 0, 0, 0, 0, 0, r.hihat};
+            out.push_back(gap);
+            dt -= PRACTICE_CHUNK_TICKS;
+        }
+        TickRow hit = r;
+        hit.dt = dt;
+        out.push_back(hit);
+    }
+
+    const TickScore& score_;
+    std::atomic<int> speed_{100};
+    size_t next_ = 0;
+};
+
+// output6 과 같은 형식으로 한 줄 쓰기
+inline void writeTickRow(std::ostream& out, const TickRow& r) {
+    out << r.measure << "\t " << r.dt * PRACTICE_TICK_SEC << "\t " << (int)r.R << "\t " << (int)r.L << "\t "
+        << (int)r.Rpow << "\t " << (int)r.Lpow << "\t " << (int)r.bass << "\t " << (int)r.hihat << "\n";
+}
+
+inline bool writePracticeScore(const TickScore& score, const std::vector<TickRow>& rows, const std::string& path) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        std::cerr << "출력 파일 생성 실패: " << path << "\n";
+        return false;
+    }
+    out << std::fixed << std::setprecision(3);
+    if (score.hasLead) writeTickRow(out, score.lead);
+    for (const auto& r : rows) writeTickRow(out, r);
+    if (score.hasEnd) writeTickRow(out, score.end);
+    return true;
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+// 절대 시각 그리드 양자화 단계 (roundDurationsToStepSet100 대신 쓸 수 있는 round 단계)
+//  - roundDurationsToStep* 은 간격(dt)마다 따로 0.05 반올림 → 오차가 뒤로 쌓이고 스윙/중복 처리 없음
+//  - 여기서는
+//      (1) 간격을 누적해 절대 시각으로 바꾸고 bpm 기준 그리드(8분 2, 셋잇단 8분 3, 16분 4, 셋잇단 16분 6 / 박)에 맞춤
+//          swing: 짝수 분할에서 뒷박 칸을 칸 길이 × swing 만큼 늦춤 (0 = 스트레이트, 1/3 ≈ 셋잇단 느낌)
+//          strength: 1 이면 그리드에 딱 맞추고, 0.5 면 원래 시각과 그리드의 중간
+//      (2) 같은 칸에 같은 악기가 두 번 이상 오면 하나만 남김 (파이썬 quantizer_drum_final.py 의 (pitch, grid_idx) 중복 제거)
+//          입력이 시각 순이고 맞춘 시각도 순서가 유지되므로 같은 칸은 연속으로 나옴
+//          → 악기 번호(1~11) 칸에 "마지막으로 본 칸 번호"만 적어 두는 버킷 배열로 한 번에 처리 (해시 없음)
+//          output1 에는 세기가 없어서 먼저 나온 노트를 남김 (세기는 벨로시티 단계에서 따로 처리)
+//      (3) roundDurationsToStepSet100 과 같이 100bpm 기준으로 늘리고 절대 시각을 0.05 에 반올림한 뒤 간격으로 씀
+//  - 입력/출력 형식은 round 단계와 같음 ("간격\t노트")
+//
+// 사용 예)
+//   QuantizeConfig q;            // 16분, 스윙 0, 강도 1
+//   q.division = 3;              // 셋잇단 8분
+//   quantizeToGrid(bpm, q, "output1_drum_hits_time.csv", "output2_mc.csv");
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <iomanip>
+#include <cmath>
+#include <cstdint>
+
+#include "text_reader.hpp"
+
+struct QuantizeConfig {
+    int division = 4;        // 한 박을 몇 칸으로 (2, 3, 4, 6)
+    double swing = 0.0;      // 0 ~ 0.5, 짝수 분할의 뒷박 칸 지연 (칸 길이 비율)
+    double strength = 1.0;   // 0 ~ 1
+
+    // 범위 밖이면 false + err 에 이유 (division 0 이면 칸 길이가 무한대 → 모든 노트가 0초로 뭉개짐)
+    bool valid(std::string* err = nullptr) const {
+        const char* why = nullptr;
+        if (division != 2 && division != 3 && division != 4 && division != 6) why = "division 은 2, 3, 4, 6 중 하나";
+        else if (!(swing >= 0.0 && swing <= 0.5)) why = "swing 은 0 ~ 0.5";
+        else if (!(strength >= 0.0 && strength <= 1.0)) why = "strength 는 0 ~ 1";
+        if (why && err) *err = why;
+        return why == nullptr;
+    }
+
+    std::string param() const {
+        return "div=" + std::to_string(division) + ",swing=" + std::to_string(swing) +
+               ",strength=" + std::to_string(strength);
+    }
+};
+
+const int QUANTIZE_MAX_NOTE = 16;   // 노트 번호 1~11 (convertMcToC 의 NoteSlotTable 크기와 같게)
+
+// 반환: 남은 노트 수 (입력 실패 / 설정 범위 오류 시 -1). dropped 에 중복으로 뺀 개수
+inline long quantizeToGrid(int bpm, const QuantizeConfig& cfg, const std::string& inputFilename,
+                           const std::string& outputFilename, long* dropped = nullptr) {
+    std::string why;
+    if (!cfg.valid(&why) || bpm <= 0) {
+        std::cerr << "quantizeToGrid 설정 오류: " << (bpm <= 0 ? "bpm > 0" : why) << "\n";
+        return -1;
+    }
+    TextReader input(inputFilename);
+    if (!input.is_open()) {
+        std::cerr << "quantizeToGrid 입력 파일 열기 실패: " << inputFilename << "\n";
+        return -1;
+    }
+    std::ofstream output(outputFilename);
+    if (!output.is_open()) {
+        std::cerr << "quantizeToGrid 출력 파일 열기 실패: " << outputFilename << "\n";
+        return -1;
+    }
+
+    const double cell = 60.0 / bpm / cfg.division;                  // 칸 길이 [s]
+    const bool swingable = cfg.division % 2 == 0 && cfg.swing > 0;
+    const double swingShift = swingable ? cfg.swing * cell : 0.0;
+    const double scale = static_cast<double>(bpm) / 100.0;          // roundDurationsToStepSet100 과 같은 기준
+    const double step = 0.05;
+
+    // 칸 번호 → 그리드 시각 (스윙이면 홀수 칸을 늦춤)
+    auto cellTime = [&](long k) { return k * cell + ((k & 1) ? swingShift : 0.0); };
+    // 원래 시각에서 가장 가까운 칸 (스윙 그리드는 칸 간격이 고르지 않으므로 양쪽 후보 비교)
+    auto nearestCell = [&](double t) {
+        long k = std::lround(t / cell);
+        long best = k;
+        double bestD = std::fabs(cellTime(k) - t);
+        for (long c : {k - 1, k + 1}) {
+            double d = std::fabs(cellTime(c) - t);
+            if (c >= 0 && d < bestD) { best = c; bestD = d; }
+        }
+        return std::max(0L, best);
+    };
+
+    long lastCell[QUANTIZE_MAX_NOTE];
+    std::fill(lastCell, lastCell + QUANTIZE_MAX_NOTE, -1L);
+
+    std::string_view line, f[2];
+    double t = 0.0;
+    long prevStep = 0;     // 직전 출력 노트의 절대 시각 (0.05 칸 번호)
+    long kept = 0, drop = 0;
+    output << std::fixed << std::setprecision(3);
+    while (input.nextLine(line)) {
+        double delta;
+        int note;
+        if (splitFields(line, f, 2) < 2 || !toDouble(f[0], delta) || !toInt(f[1], note)) {
+            std::cerr << "quantizeToGrid 잘못된 형식: " << line << "\n";
+            continue;
+        }
+        t += delta;
+        long k = nearestCell(t);
+        if (note >= 0 && note < QUANTIZE_MAX_NOTE) {
+            if (lastCell[note] == k) {   // 같은 칸, 같은 악기
+                ++drop;
+                continue;
+            }
+            lastCell[note] = k;
+        }
+        double snapped = t + cfg.strength * (cellTime(k) - t);
+        long s = std::lround(snapped * scale / step);
+        if (s < prevStep) s = prevStep;   // strength < 1 일 때 반올림으로 순서가 뒤집히지 않도록
+        output << (s - prevStep) * step << "\t" << note << "\n";
+        prevStep = s;
+        ++kept;
+    }
+    if (dropped) *dropped = drop;
+    return kept;
+}
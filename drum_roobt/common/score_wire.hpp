@@ -0,0 +1,260 @@
+#pragma once
+
+// 최종 악보 줄(measure dt R L Rpow Lpow bass hihat)을 컨트롤러로 보내는 바이너리 프레임 형식
+//
+// 프레임: 0xA5 0x5A | seq(u16 LE) | 줄 수(u8) | 길이(varint) | 본문 | CRC-16/CCITT(u16 LE, seq 부터 본문 끝까지)
+//  - 프레임마다 delta 상태를 0 에서 다시 시작 → 중간 프레임이 깨져도 다음 프레임부터 바로 복구
+//  - seq 로 빠진 프레임 수를 알 수 있음
+//
+// 줄 하나: 플래그(1) [measure 차이(zigzag varint)] [dt 차이(zigzag varint, ms)] 악기(1) [세기(1)]
+//  - 플래그 비트: 0 dt 가 앞 줄과 같음 / 1 measure 가 앞 줄과 같음 / 2 bass / 3 hihat
+//                 4 Rpow(0/1) / 5 Lpow(0/1) / 6 세기 바이트 따로 있음(0/1 이 아닌 값)
+//  - 악기 바이트: R | (L << 4)
+//  - dt 는 1ms 단위로 보냄 (악보 파일도 소수점 셋째 자리까지)
+//
+// 사용 예)
+//   WireEncoder enc(32);
+//   for (...) enc.add(row, out);   // 32줄마다 out 뒤에 프레임이 붙음
+//   enc.flush(out);
+//
+//   WireDecoder dec;
+//   dec.feed(buf, n, [&](const WireRow& r) { ... });
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cmath>
+
+struct WireRow {
+    int32_t measure;
+    int32_t dtMs;
+    uint8_t R, L, Rpow, Lpow, bass, hihat;
+
+    bool operator==(const WireRow& o) const {
+        return measure == o.measure && dtMs == o.dtMs && R == o.R && L == o.L && Rpow == o.Rpow &&
+               Lpow == o.Lpow && bass == o.bass && hihat == o.hihat;
+    }
+};
+
+const uint8_t WIRE_SYNC0 = 0xA5;
+const uint8_t WIRE_SYNC1 = 0x5A;
+const size_t WIRE_MAX_PAYLOAD = 4096;
+
+const uint8_t WF_SAME_DT      = 1 << 0;
+const uint8_t WF_SAME_MEASURE = 1 << 1;
+const uint8_t WF_BASS         = 1 << 2;
+const uint8_t WF_HIHAT        = 1 << 3;
+const uint8_t WF_RPOW         = 1 << 4;
+const uint8_t WF_LPOW         = 1 << 5;
+const uint8_t WF_POW_BYTE     = 1 << 6;
+
+// CRC-16/CCITT-FALSE (poly 0x1021, 초기값 0xFFFF), 표는 한 번만 생성
+inline uint16_t wireCrc16(const uint8_t* p, size_t n, uint16_t crc = 0xFFFF) {
+    static const auto table = [] {
+        std::vector<uint16_t> t(256);
+        for (int i = 0; i < 256; ++i) {
+            uint16_t c = static_cast<uint16_t>(i << 8);
+            for (int b = 0; b < 8; ++b) c = (c & 0x8000) ? static_cast<uint16_t>((c << 1) ^ 0x1021) : static_cast<uint16_t>(c << 1);
+            t[i] = c;
+        }
+        return t;
+    }();
+    for (size_t i = 0; i < n; ++i) crc = static_cast<uint16_t>((crc << 8) ^ table[((crc >> 8) ^ p[i]) & 0xFF]);
+    return crc;
+}
+
+inline void wirePutVarint(std::vector<uint8_t>& out, uint32_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+// 성공하면 읽은 바이트 수, 실패(끝까지 안 옴/너무 김)면 0
+inline size_t wireGetVarint(const uint8_t* p, size_t n, uint32_t& v) {
+    v = 0;
+    for (size_t i = 0; i < n && i < 5; ++i) {
+        v |= static_cast<uint32_t>(p[i] & 0x7F) << (7 * i);
+        if ((p[i] & 0x80) == 0) return i + 1;
+    }
+    return 0;
+}
+
+inline uint32_t wireZigzag(int32_t v) { return (static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31); }
+inline int32_t wireUnzigzag(uint32_t v) { return static_cast<int32_t>(v >> 1) ^ -static_cast<int32_t>(v & 1); }
+
+inline int32_t wireDtMs(double dt) { return static_cast<int32_t>(std::lround(dt * 1000.0)); }
+
+class WireEncoder {
+public:
+    explicit WireEncoder(int rowsPerFrame = 32) : rowsPerFrame_(rowsPerFrame < 1 ? 1 : (rowsPerFrame > 255 ? 255 : rowsPerFrame)) {
+        body_.reserve(rowsPerFrame_ * 8);
+    }
+
+    uint16_t nextSeq() const { return seq_; }
+
+    void add(const WireRow& r, std::vector<uint8_t>& out) {
+        uint8_t flags = 0;
+        flags |= (rows_ > 0 && r.dtMs == prevDt_) ? WF_SAME_DT : 0;
+        flags |= (r.measure == prevMeasure_) ? WF_SAME_MEASURE : 0;
+        flags |= r.bass ? WF_BASS : 0;
+        flags |= r.hihat ? WF_HIHAT : 0;
+        bool smallPow = r.Rpow <= 1 && r.Lpow <= 1;
+        if (smallPow) flags |= (r.Rpow ? WF_RPOW : 0) | (r.Lpow ? WF_LPOW : 0);
+        else flags |= WF_POW_BYTE;
+
+        body_.push_back(flags);
+        if (!(flags & WF_SAME_MEASURE)) wirePutVarint(body_, wireZigzag(r.measure - prevMeasure_));
+        if (!(flags & WF_SAME_DT)) wirePutVarint(body_, wireZigzag(r.dtMs - prevDt_));
+        body_.push_back(static_cast<uint8_t>((r.R & 0x0F) | (r.L << 4)));
+        if (!smallPow) body_.push_back(static_cast<uint8_t>((r.Rpow & 0x0F) | (r.Lpow << 4)));
+
+        prevMeasure_ = r.measure;
+        prevDt_ = r.dtMs;
+        if (++rows_ == rowsPerFrame_ || body_.size() > WIRE_MAX_PAYLOAD - 16) flush(out);
+    }
+
+    // 모인 줄이 있으면 프레임 하나로 내보냄
+    void flush(std::vector<uint8_t>& out) {
+        if (rows_ == 0) return;
+        out.push_back(WIRE_SYNC0);
+        out.push_back(WIRE_SYNC1);
+        size_t start = out.size();
+        out.push_back(static_cast<uint8_t>(seq_));
+        out.push_back(static_cast<uint8_t>(seq_ >> 8));
+        out.push_back(static_cast<uint8_t>(rows_));
+        wirePutVarint(out, static_cast<uint32_t>(body_.size()));
+        out.insert(out.end(), body_.begin(), body_.end());
+        uint16_t crc = wireCrc16(out.data() + start, out.size() - start);
+        out.push_back(static_cast<uint8_t>(crc));
+        out.push_back(static_cast<uint8_t>(crc >> 8));
+
+        ++seq_;
+        rows_ = 0;
+        body_.clear();
+        prevMeasure_ = 0;
+        prevDt_ = 0;
+    }
+
+private:
+    int rowsPerFrame_;
+    int rows_ = 0;
+    uint16_t seq_ = 0;
+    int32_t prevMeasure_ = 0, prevDt_ = 0;
+    std::vector<uint8_t> body_;
+};
+
+// 바이트가 조각조각 들어와도 되는 스트리밍 디코더
+//  - 동기 바이트를 찾고 프레임 전체가 모이면 CRC 확인 후 줄을 콜백으로 넘김
+//  - CRC 가 틀리면 한 바이트 뒤부터 다시 동기 바이트를 찾음
+class WireDecoder {
+public:
+    struct Stats {
+        uint64_t frames = 0;
+        uint64_t rows = 0;
+        uint64_t crcErrors = 0;
+        uint64_t lostFrames = 0;     // seq 건너뜀으로 계산
+        uint64_t skippedBytes = 0;   // 동기 찾는 동안 버린 바이트
+    };
+
+    const Stats& stats() const { return stats_; }
+
+    template <class OnRow>
+    void feed(const uint8_t* data, size_t n, OnRow&& onRow) {
+        buf_.insert(buf_.end(), data, data + n);
+        size_t pos = 0;
+        while (true) {
+            size_t used = tryFrame(pos, onRow);
+            if (used == NEED_MORE) break;
+            pos += used;
+        }
+        buf_.erase(buf_.begin(), buf_.begin() + pos);
+    }
+
+private:
+    static constexpr size_t NEED_MORE = static_cast<size_t>(-1);
+
+    // pos 에서 프레임 하나 해석. 반환값: 소비한 바이트 수 (버린 바이트 포함), 더 필요하면 NEED_MORE
+    template <class OnRow>
+    size_t tryFrame(size_t pos, OnRow& onRow) {
+        const uint8_t* p = buf_.data() + pos;
+        size_t n = buf_.size() - pos;
+        if (n < 2) return NEED_MORE;
+        if (p[0] != WIRE_SYNC0 || p[1] != WIRE_SYNC1) {
+            const void* s = std::memchr(p + 1, WIRE_SYNC0, n - 1);
+            size_t skip = s ? static_cast<const uint8_t*>(s) - p : n - 1;
+            stats_.skippedBytes += skip;
+            return skip;
+        }
+        if (n < 6) return NEED_MORE;
+        uint32_t len;
+        size_t lv = wireGetVarint(p + 5, n - 5, len);
+        if (lv == 0) return n - 5 >= 5 ? resync() : NEED_MORE;
+        if (len > WIRE_MAX_PAYLOAD) return resync();
+        size_t total = 5 + lv + len + 2;
+        if (n < total) return NEED_MORE;
+
+        uint16_t crc = static_cast<uint16_t>(p[total - 2] | (p[total - 1] << 8));
+        if (wireCrc16(p + 2, total - 4) != crc) {
+            stats_.crcErrors++;
+            return resync();
+        }
+
+        uint16_t seq = static_cast<uint16_t>(p[2] | (p[3] << 8));
+        int rows = p[4];
+        if (haveSeq_) stats_.lostFrames += static_cast<uint16_t>(seq - expectSeq_);
+        haveSeq_ = true;
+        expectSeq_ = static_cast<uint16_t>(seq + 1);
+        stats_.frames++;
+
+        // 본문 해석 (CRC 를 통과했으므로 형식 오류는 사실상 없음, 그래도 범위는 확인)
+        const uint8_t* b = p + 5 + lv;
+        const uint8_t* e = b + len;
+        WireRow r{0, 0, 0, 0, 0, 0, 0, 0};
+        for (int i = 0; i < rows && b < e; ++i) {
+            uint8_t flags = *b++;
+            uint32_t v;
+            size_t k;
+            if (!(flags & WF_SAME_MEASURE)) {
+                if (!(k = wireGetVarint(b, e - b, v))) break;
+                b += k;
+                r.measure += wireUnzigzag(v);
+            }
+            if (!(flags & WF_SAME_DT)) {
+                if (!(k = wireGetVarint(b, e - b, v))) break;
+                b += k;
+                r.dtMs += wireUnzigzag(v);
+            }
+            if (b >= e) break;
+            uint8_t inst = *b++;
+            r.R = inst & 0x0F;
+            r.L = inst >> 4;
+            if (flags & WF_POW_BYTE) {
+                if (b >= e) break;
+                uint8_t pw = *b++;
+                r.Rpow = pw & 0x0F;
+                r.Lpow = pw >> 4;
+            } else {
+                r.Rpow = (flags & WF_RPOW) ? 1 : 0;
+                r.Lpow = (flags & WF_LPOW) ? 1 : 0;
+            }
+            r.bass = (flags & WF_BASS) ? 1 : 0;
+            r.hihat = (flags & WF_HIHAT) ? 1 : 0;
+            stats_.rows++;
+            onRow(r);
+        }
+        return total;
+    }
+
+    size_t resync() {
+        stats_.skippedBytes++;
+        return 1;
+    }
+
+    std::vector<uint8_t> buf_;
+    bool haveSeq_ = false;
+    uint16_t expectSeq_ = 0;
+    Stats stats_;
+};
@@ -0,0 +1,389 @@
+#pragma once
+
+// IMU 로그 (블록 단위 바이너리 + 시각 색인)
+//  - sensor_log.csv 는 append 로 끝없이 커지고 "12:03:41 근처 자이로" 를 보려면 파일 전체를 읽어야 함
+//  - 로그 파일: 블록을 이어 붙임. 블록 = 헤더(24 bytes) + 고정 길이 레코드(24 bytes) × count
+//      헤더  "WSB1" | count(u32) | 첫 시각(i64 us) | 마지막 시각(i64 us)
+//      레코드 시각(i64, epoch us) | 종류('A' 가속도, 'G' 각속도) | 패딩 3 | x y z (float)
+//  - 색인 파일 (로그 경로 + ".idx"): 블록마다 한 줄 — 첫 시각 | 마지막 시각 | 헤더 위치(u64) | count(u32) | 0(u32)
+//    블록 수만큼만 있으므로 작음 (레코드 수천 개당 하나)
+//  - 쓰기: 블록이 차거나 1초가 지나면 헤더+레코드를 write() 한 번으로 붙이고 색인 줄도 붙임
+//          프로그램이 죽어도 잃는 것은 아직 안 쓴 블록 하나 (1초 이내)
+//          쓰기가 실패하면 그 블록은 버리고 로그 위치를 실제 파일 크기로 다시 맞춤 (일부만 써진 블록이 남을 수 있음)
+//  - 읽기: 로그를 mmap, 색인을 읽어 첫 시각으로 이분 탐색 → 범위 [from, to] 를 O(log 블록 수 + k) 로 꺼냄
+//          색인이 없거나 로그보다 짧으면(쓰는 중 종료) 마지막 색인 뒤의 블록 헤더를 훑어 나머지를 채움
+//          색인 줄이 틀렸거나 중간에 깨진 블록이 있으면 그것만 건너뛰고 다음 "WSB1" 헤더부터 계속 읽음
+//  - 시각은 블록 순서대로 늘어난다고 가정 (시스템 시계를 뒤로 돌리면 그 구간 검색이 부정확해짐)
+//
+// 사용 예)
+//   SensorLogWriter w;
+//   w.open("sensor_log.bin");
+//   w.append({nowUs, 'A', {}, x, y, z});
+//   ...
+//   SensorLogReader r;
+//   r.open("sensor_log.bin");
+//   SensorColumns gyro;
+//   r.collect(from, to, 'G', gyro);                // 열 배열 (t, x, y, z)
+//   r.envelope(from, to, 'G', 800, env);           // 그래프용 구간별 min/max
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <ctime>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "text_reader.hpp"
+
+struct SensorRecord {
+    int64_t tUs;       // epoch 기준 us
+    char type;         // 'A' / 'G'
+    char pad[3];
+    float x, y, z;
+};
+static_assert(sizeof(SensorRecord) == 24, "SensorRecord 는 24 bytes 고정");
+
+struct SensorBlockHeader {
+    char magic[4];
+    uint32_t count;
+    int64_t t0, t1;
+};
+static_assert(sizeof(SensorBlockHeader) == 24, "SensorBlockHeader 는 24 bytes 고정");
+
+struct SensorIndexEntry {
+    int64_t t0, t1;
+    uint64_t offset;
+    uint32_t count;
+    uint32_t reserved;
+};
+static_assert(sizeof(SensorIndexEntry) == 32, "SensorIndexEntry 는 32 bytes 고정");
+
+const uint32_t SENSOR_BLOCK_RECORDS = 4096;
+const int64_t SENSOR_BLOCK_FLUSH_US = 1000000;
+
+inline int64_t sensorNowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// "2025-11-12 13:18:51.737" (현지 시각) ↔ epoch us
+inline std::string formatSensorTime(int64_t tUs) {
+    std::time_t s = static_cast<std::time_t>(tUs / 1000000);
+    std::tm tm_buf;
+    localtime_r(&s, &tm_buf);
+    char buf[40];
+    size_t n = std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &tm_buf);
+    std::snprintf(buf + n, sizeof(buf) - n, ".%03d", static_cast<int>(tUs / 1000 % 1000));
+    return buf;
+}
+
+// 날짜 없이 "12:03:41(.5)" 만 주면 dayOfUs 가 속한 날짜로 해석. 실패하면 false
+inline bool parseSensorTime(const std::string& s, int64_t& tUs, int64_t dayOfUs = 0) {
+    std::tm tm_buf{};
+    double sec = 0;
+    int Y, M, D, h, m;
+    if (std::sscanf(s.c_str(), "%d-%d-%d %d:%d:%lf", &Y, &M, &D, &h, &m, &sec) == 6) {
+        tm_buf.tm_year = Y - 1900;
+        tm_buf.tm_mon = M - 1;
+        tm_buf.tm_mday = D;
+    } else if (std::sscanf(s.c_str(), "%d:%d:%lf", &h, &m, &sec) == 3) {
+        std::time_t d = static_cast<std::time_t>(dayOfUs / 1000000);
+        localtime_r(&d, &tm_buf);
+    } else {
+        return false;
+    }
+    tm_buf.tm_hour = h;
+    tm_buf.tm_min = m;
+    tm_buf.tm_sec = 0;
+    tm_buf.tm_isdst = -1;
+    std::time_t t = std::mktime(&tm_buf);
+    if (t == static_cast<std::time_t>(-1)) return false;
+    tUs = static_cast<int64_t>(t) * 1000000 + static_cast<int64_t>(sec * 1e6 + 0.5);
+    return true;
+}
+
+// 예전 CSV ("2025-11-12 13:18:51.737,A,x,y,z") 를 레코드로 읽어 fn(rec) 에 넘김. 반환: 건너뛴 줄 수 (열기 실패 -1)
+template <class Fn>
+long readSensorCsv(const std::string& path, Fn&& fn) {
+    TextReader in(path);
+    if (!in.is_open()) {
+        std::cerr << "CSV 열기 실패: " << path << "\n";
+        return -1;
+    }
+    std::string_view line, f[6];
+    long bad = 0;
+    SensorRecord r{};
+    double x, y, z;
+    while (in.nextLine(line)) {
+        // 공백도 구분자라 날짜/시각이 두 칸 → 6칸
+        if (splitFields(line, f, 6) < 6 || f[2].size() != 1 ||
+            !parseSensorTime(std::string(f[0]) + " " + std::string(f[1]), r.tUs) ||
+            !toDouble(f[3], x) || !toDouble(f[4], y) || !toDouble(f[5], z)) {
+            ++bad;   // 헤더 줄 포함
+            continue;
+        }
+        r.type = f[2][0];
+        r.x = static_cast<float>(x);
+        r.y = static_cast<float>(y);
+        r.z = static_cast<float>(z);
+        fn(r);
+    }
+    return bad;
+}
+
+class SensorLogWriter {
+public:
+    ~SensorLogWriter() { close(); }
+
+    bool open(const std::string& path) {
+        fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        idxFd_ = ::open((path + ".idx").c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (fd_ < 0 || idxFd_ < 0) {
+            std::cerr << "센서 로그 열기 실패: " << path << "\n";
+            close();
+            return false;
+        }
+        struct stat st;
+        offset_ = ::fstat(fd_, &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+        buf_.reserve(sizeof(SensorBlockHeader) + SENSOR_BLOCK_RECORDS * sizeof(SensorRecord));
+        return true;
+    }
+
+    bool append(const SensorRecord& r) {
+        if (count_ > 0 && r.tUs - t0_ >= SENSOR_BLOCK_FLUSH_US && !flush()) return false;
+        if (count_ == 0) {
+            t0_ = r.tUs;
+            buf_.resize(sizeof(SensorBlockHeader));
+        }
+        const char* p = reinterpret_cast<const char*>(&r);
+        buf_.insert(buf_.end(), p, p + sizeof(r));
+        t1_ = r.tUs;
+        ++records_;
+        if (++count_ == SENSOR_BLOCK_RECORDS) return flush();
+        return true;
+    }
+
+    // 모은 블록을 로그/색인에 붙임
+    //  - 로그 쓰기가 실패하면 블록을 버리고 offset_ 를 실제 파일 크기로 맞춤 (일부만 써졌어도 다음 색인 위치가 맞도록)
+    //  - 색인 쓰기만 실패하면 블록은 로그에 있으므로 offset_ 는 넘김 (읽는 쪽이 헤더를 훑어 복구)
+    bool flush() {
+        if (count_ == 0 || fd_ < 0) return true;
+        SensorBlockHeader h{{'W', 'S', 'B', '1'}, count_, t0_, t1_};
+        std::memcpy(buf_.data(), &h, sizeof(h));
+        count_ = 0;
+        if (!writeAll(fd_, buf_.data(), buf_.size())) {
+            std::cerr << "센서 로그 쓰기 실패\n";
+            struct stat st;
+            if (::fstat(fd_, &st) == 0) offset_ = static_cast<uint64_t>(st.st_size);
+            return false;
+        }
+        SensorIndexEntry e{t0_, t1_, offset_, h.count, 0};
+        offset_ += buf_.size();
+        ++blocks_;
+        if (!writeAll(idxFd_, &e, sizeof(e))) {
+            std::cerr << "센서 로그 색인 쓰기 실패\n";
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        flush();
+        if (fd_ >= 0) ::close(fd_);
+        if (idxFd_ >= 0) ::close(idxFd_);
+        fd_ = idxFd_ = -1;
+    }
+
+    long records() const { return records_; }
+    long blocks() const { return blocks_; }
+
+private:
+    static bool writeAll(int fd, const void* data, size_t n) {
+        const char* p = static_cast<const char*>(data);
+        while (n > 0) {
+            ssize_t w = ::write(fd, p, n);
+            if (w < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            p += w;
+            n -= static_cast<size_t>(w);
+        }
+        return true;
+    }
+
+    int fd_ = -1, idxFd_ = -1;
+    uint64_t offset_ = 0;
+    std::vector<char> buf_;
+    uint32_t count_ = 0;
+    int64_t t0_ = 0, t1_ = 0;
+    long records_ = 0, blocks_ = 0;
+};
+
+// 열 배열 (한 종류의 범위 결과)
+struct SensorColumns {
+    std::vector<int64_t> t;
+    std::vector<float> x, y, z;
+
+    void clear() { t.clear(); x.clear(); y.clear(); z.clear(); }
+    size_t size() const { return t.size(); }
+};
+
+// 그래프용 구간 하나 (비어 있으면 n = 0)
+struct SensorEnvelopeBin {
+    int64_t t0 = 0;
+    long n = 0;
+    float min[3] = {0, 0, 0}, max[3] = {0, 0, 0};
+};
+
+class SensorLogReader {
+public:
+    ~SensorLogReader() { close(); }
+
+    bool open(const std::string& path) {
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cerr << "센서 로그 열기 실패: " << path << "\n";
+            return false;
+        }
+        struct stat st;
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            size_ = static_cast<size_t>(st.st_size);
+            void* p = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+            if (p != MAP_FAILED) data_ = static_cast<const char*>(p);
+        }
+        ::close(fd);
+        if (size_ > 0 && !data_) {
+            std::cerr << "센서 로그 mmap 실패: " << path << "\n";
+            size_ = 0;
+            return false;
+        }
+        loadIndex(path + ".idx");
+        return true;
+    }
+
+    void close() {
+        if (data_) ::munmap(const_cast<char*>(data_), size_);
+        data_ = nullptr;
+        size_ = 0;
+        index_.clear();
+        recovered_ = 0;
+    }
+
+    const std::vector<SensorIndexEntry>& index() const { return index_; }
+    size_t recoveredBlocks() const { return recovered_; }
+    long records() const {
+        long n = 0;
+        for (const auto& e : index_) n += e.count;
+        return n;
+    }
+    int64_t firstTime() const { return index_.empty() ? 0 : index_.front().t0; }
+    int64_t lastTime() const { return index_.empty() ? 0 : index_.back().t1; }
+
+    const SensorRecord* blockRecords(const SensorIndexEntry& e) const {
+        return reinterpret_cast<const SensorRecord*>(data_ + e.offset + sizeof(SensorBlockHeader));
+    }
+
+    // [from, to] 의 레코드를 시각 순서로 fn(rec) 에 넘김. 첫 블록만 이분 탐색, 나머지는 순서대로
+    template <class Fn>
+    void forEach(int64_t from, int64_t to, Fn&& fn) const {
+        auto it = std::partition_point(index_.begin(), index_.end(),
+                                       [&](const SensorIndexEntry& e) { return e.t1 < from; });
+        for (; it != index_.end() && it->t0 <= to; ++it) {
+            const SensorRecord* r = blockRecords(*it);
+            const SensorRecord* end = r + it->count;
+            if (it->t0 < from)
+                r = std::partition_point(r, end, [&](const SensorRecord& x) { return x.tUs < from; });
+            for (; r != end && r->tUs <= to; ++r) fn(*r);
+        }
+    }
+
+    // type 이 0 이면 종류 구분 없이
+    size_t collect(int64_t from, int64_t to, char type, SensorColumns& out) const {
+        out.clear();
+        forEach(from, to, [&](const SensorRecord& r) {
+            if (type && r.type != type) return;
+            out.t.push_back(r.tUs);
+            out.x.push_back(r.x);
+            out.y.push_back(r.y);
+            out.z.push_back(r.z);
+        });
+        return out.size();
+    }
+
+    // [from, to] 를 bins 개로 나눠 축별 min/max (그래프 한 픽셀 열에 한 구간)
+    void envelope(int64_t from, int64_t to, char type, int bins, std::vector<SensorEnvelopeBin>& out) const {
+        out.assign(std::max(1, bins), SensorEnvelopeBin());
+        const double span = static_cast<double>(std::max<int64_t>(1, to - from + 1));
+        for (size_t i = 0; i < out.size(); ++i) out[i].t0 = from + static_cast<int64_t>(span * i / out.size());
+        forEach(from, to, [&](const SensorRecord& r) {
+            if (type && r.type != type) return;
+            size_t b = std::min(out.size() - 1, static_cast<size_t>((r.tUs - from) / span * out.size()));
+            SensorEnvelopeBin& e = out[b];
+            const float v[3] = {r.x, r.y, r.z};
+            for (int k = 0; k < 3; ++k) {
+                if (e.n == 0 || v[k] < e.min[k]) e.min[k] = v[k];
+                if (e.n == 0 || v[k] > e.max[k]) e.max[k] = v[k];
+            }
+            ++e.n;
+        });
+    }
+
+private:
+    static uint64_t blockBytes(uint32_t count) { return sizeof(SensorBlockHeader) + static_cast<uint64_t>(count) * sizeof(SensorRecord); }
+
+    // 헤더가 맞고 블록 전체가 [off, limit) 안에 있으면 true
+    bool validBlock(uint64_t off, SensorBlockHeader& h, uint64_t limit) const {
+        if (off + sizeof(h) > limit) return false;
+        std::memcpy(&h, data_ + off, sizeof(h));
+        return std::memcmp(h.magic, "WSB1", 4) == 0 && h.count > 0 && h.t0 <= h.t1 && off + blockBytes(h.count) <= limit;
+    }
+    bool validBlock(uint64_t off, SensorBlockHeader& h) const { return validBlock(off, h, size_); }
+
+    // [from, to) 의 블록 헤더를 훑어 색인에 없는 블록을 채움. 깨진 곳은 다음 "WSB1" 까지 건너뜀
+    void scanBlocks(uint64_t from, uint64_t to) {
+        SensorBlockHeader h;
+        while (from < to) {
+            if (validBlock(from, h, to)) {
+                index_.push_back({h.t0, h.t1, from, h.count, 0});
+                from += blockBytes(h.count);
+                ++recovered_;
+                continue;
+            }
+            const void* m = memmem(data_ + from + 1, static_cast<size_t>(to - from - 1), "WSB1", 4);
+            if (!m) break;
+            from = static_cast<uint64_t>(static_cast<const char*>(m) - data_);
+        }
+    }
+
+    void loadIndex(const std::string& idxPath) {
+        std::ifstream in(idxPath, std::ios::binary);
+        SensorIndexEntry e;
+        SensorBlockHeader h;
+        uint64_t next = 0;
+        while (in.read(reinterpret_cast<char*>(&e), sizeof(e))) {
+            // 앞 블록과 겹치거나 헤더와 안 맞는 색인 줄은 건너뜀
+            if (e.offset < next || !validBlock(e.offset, h) || h.count != e.count) continue;
+            if (e.offset > next) scanBlocks(next, e.offset);   // 사이의 깨진 블록/색인 없는 블록
+            index_.push_back(e);
+            next = e.offset + blockBytes(e.count);
+        }
+        // 색인에 없는 뒤쪽 블록 (색인을 쓰기 전에 종료된 경우)
+        scanBlocks(next, size_);
+    }
+
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    std::vector<SensorIndexEntry> index_;
+    size_t recovered_ = 0;
+};
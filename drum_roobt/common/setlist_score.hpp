@@ -0,0 +1,210 @@
+#pragma once
+
+// 여러 곡을 이어 붙인 셋리스트 악보 (컨트롤러가 곡 단위로 바로 찾아갈 수 있는 색인 포함)
+//  - 본문은 score_wire 프레임을 그대로 이어 붙인 것. 곡 경계마다 프레임을 끊으므로
+//    곡 표의 byteOffset 부터 디코딩을 시작하면 앞 곡을 읽지 않고 바로 그 곡(카운트인부터)을 재생
+//  - 줄 순서는 텍스트 악보와 같음: 선두 줄 | 곡 0 | 곡 1 | ... | 끝 줄 두 개 (빈 마디, -1)
+//    선두 줄과 끝 줄도 각자 프레임 하나
+//
+// 파일: "DSL1" | 곡 수(u32) | 전체 줄 수(u32) | 끝 줄 byteOffset(u32) | 본문 길이(u32)
+//       | 곡 표 (곡마다 64바이트) | 본문 (byteOffset 은 본문 시작 기준)
+// 곡 표 한 칸: 이름[36] (0 으로 채움) | bpm | firstRow | rowCount | countInRows | firstMeasure(i32) | startMs | byteOffset
+//  - 정수는 모두 u32 LE (score_wire 와 같은 바이트 순서)
+//  - firstRow/rowCount 는 곡 앞 빈 마디와 카운트인 줄까지 포함한 범위 (그 줄 수가 countInRows)
+//    startMs 는 셋리스트 처음부터 그 곡 첫 줄까지 악보 시간
+//
+// 사용 예)
+//   SetlistScoreWriter w;
+//   w.beginSong(song);  for (...) w.add(row);   // 곡마다
+//   w.write("setlist.dsl");
+//
+//   SetlistScoreReader r;
+//   r.open("setlist.dsl");
+//   r.decodeSong(3, [&](const WireRow& row) { ... });   // 4번째 곡만
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "score_wire.hpp"
+
+const char SETLIST_MAGIC[4] = {'D', 'S', 'L', '1'};
+const size_t SETLIST_HEADER_BYTES = 20;
+const size_t SETLIST_ENTRY_BYTES = 64;
+const size_t SETLIST_NAME_BYTES = 36;
+
+struct SetlistSong {
+    std::string name;
+    uint32_t bpm = 0;
+    uint32_t firstRow = 0;
+    uint32_t rowCount = 0;
+    uint32_t countInRows = 0;
+    int32_t firstMeasure = 0;
+    uint32_t startMs = 0;
+    uint32_t byteOffset = 0;
+};
+
+inline void setlistPutU32(std::vector<uint8_t>& out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+}
+
+inline uint32_t setlistGetU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+}
+
+class SetlistScoreWriter {
+public:
+    explicit SetlistScoreWriter(int rowsPerFrame = 32) : enc_(rowsPerFrame) {}
+
+    // 곡 시작 (그 전 곡/선두 줄 프레임을 닫음). 줄 범위와 byteOffset 은 여기서 채움
+    void beginSong(const SetlistSong& song) {
+        enc_.flush(body_);
+        closeSong();
+        songs_.push_back(song);
+        songs_.back().firstRow = rows_;
+        songs_.back().startMs = static_cast<uint32_t>(timeMs_);
+        songs_.back().byteOffset = static_cast<uint32_t>(body_.size());
+        songOpen_ = true;
+    }
+
+    // 마지막 곡 뒤 끝 줄 시작
+    void beginTrailer() {
+        enc_.flush(body_);
+        closeSong();
+        trailerOffset_ = static_cast<uint32_t>(body_.size());
+    }
+
+    void add(const WireRow& r) {
+        enc_.add(r, body_);
+        ++rows_;
+        timeMs_ += r.dtMs;
+    }
+
+    const std::vector<SetlistSong>& songs() const { return songs_; }
+    uint32_t rows() const { return rows_; }
+
+    bool write(const std::string& path) {
+        enc_.flush(body_);
+        closeSong();
+        std::vector<uint8_t> out;
+        out.insert(out.end(), SETLIST_MAGIC, SETLIST_MAGIC + 4);
+        setlistPutU32(out, static_cast<uint32_t>(songs_.size()));
+        setlistPutU32(out, rows_);
+        setlistPutU32(out, trailerOffset_ ? trailerOffset_ : static_cast<uint32_t>(body_.size()));
+        setlistPutU32(out, static_cast<uint32_t>(body_.size()));
+        for (const auto& s : songs_) {
+            char name[SETLIST_NAME_BYTES] = {};
+            std::memcpy(name, s.name.data(), std::min(s.name.size(), SETLIST_NAME_BYTES - 1));
+            out.insert(out.end(), name, name + SETLIST_NAME_BYTES);
+            for (uint32_t v : {s.bpm, s.firstRow, s.rowCount, s.countInRows, static_cast<uint32_t>(s.firstMeasure),
+                               s.startMs, s.byteOffset})
+                setlistPutU32(out, v);
+        }
+        out.insert(out.end(), body_.begin(), body_.end());
+
+        std::ofstream f(path, std::ios::binary | std::ios::trunc);
+        if (!f) {
+            std::cerr << "출력 파일 생성 실패: " << path << "\n";
+            return false;
+        }
+        f.write(reinterpret_cast<const char*>(out.data()), static_cast<std::streamsize>(out.size()));
+        return static_cast<bool>(f);
+    }
+
+private:
+    void closeSong() {
+        if (songOpen_) songs_.back().rowCount = rows_ - songs_.back().firstRow;
+        songOpen_ = false;
+    }
+
+    WireEncoder enc_;
+    std::vector<uint8_t> body_;
+    std::vector<SetlistSong> songs_;
+    uint32_t rows_ = 0;
+    uint64_t timeMs_ = 0;
+    uint32_t trailerOffset_ = 0;
+    bool songOpen_ = false;
+};
+
+class SetlistScoreReader {
+public:
+    bool open(const std::string& path) {
+        std::ifstream f(path, std::ios::binary);
+        if (!f) {
+            std::cerr << "입력 파일 열기 실패: " << path << "\n";
+            return false;
+        }
+        std::vector<uint8_t> buf((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+        if (buf.size() < SETLIST_HEADER_BYTES || std::memcmp(buf.data(), SETLIST_MAGIC, 4) != 0) {
+            std::cerr << "셋리스트 형식 아님: " << path << "\n";
+            return false;
+        }
+        uint32_t count = setlistGetU32(&buf[4]);
+        rows_ = setlistGetU32(&buf[8]);
+        trailerOffset_ = setlistGetU32(&buf[12]);
+        uint32_t bodyLen = setlistGetU32(&buf[16]);
+        size_t bodyStart = SETLIST_HEADER_BYTES + static_cast<size_t>(count) * SETLIST_ENTRY_BYTES;
+        if (buf.size() != bodyStart + bodyLen || trailerOffset_ > bodyLen) {
+            std::cerr << "셋리스트 파일 길이 오류: " << path << "\n";
+            return false;
+        }
+        songs_.clear();
+        for (uint32_t i = 0; i < count; ++i) {
+            const uint8_t* p = &buf[SETLIST_HEADER_BYTES + i * SETLIST_ENTRY_BYTES];
+            SetlistSong s;
+            s.name.assign(reinterpret_cast<const char*>(p), strnlen(reinterpret_cast<const char*>(p), SETLIST_NAME_BYTES));
+            p += SETLIST_NAME_BYTES;
+            s.bpm = setlistGetU32(p);
+            s.firstRow = setlistGetU32(p + 4);
+            s.rowCount = setlistGetU32(p + 8);
+            s.countInRows = setlistGetU32(p + 12);
+            s.firstMeasure = static_cast<int32_t>(setlistGetU32(p + 16));
+            s.startMs = setlistGetU32(p + 20);
+            s.byteOffset = setlistGetU32(p + 24);
+            // 곡 byteOffset 은 끝 줄 위치를 넘지 않고 곡 순서대로 줄어들지 않아야 함 (decodeSong 의 범위가 거꾸로 되지 않게)
+            if (s.byteOffset > trailerOffset_ || (!songs_.empty() && s.byteOffset < songs_.back().byteOffset)) {
+                std::cerr << "셋리스트 곡 표 오류: " << path << "\n";
+                return false;
+            }
+            songs_.push_back(s);
+        }
+        body_.assign(buf.begin() + bodyStart, buf.end());
+        return true;
+    }
+
+    const std::vector<SetlistSong>& songs() const { return songs_; }
+    uint32_t rows() const { return rows_; }
+
+    // 곡 하나만 디코딩 (곡 byteOffset ~ 다음 곡/끝 줄 byteOffset)
+    template <class OnRow>
+    WireDecoder::Stats decodeSong(size_t i, OnRow&& onRow) const {
+        uint32_t end = i + 1 < songs_.size() ? songs_[i + 1].byteOffset : trailerOffset_;
+        return decodeRange(songs_[i].byteOffset, end, onRow);
+    }
+
+    // 선두 줄부터 끝 줄까지 전체
+    template <class OnRow>
+    WireDecoder::Stats decodeAll(OnRow&& onRow) const {
+        return decodeRange(0, static_cast<uint32_t>(body_.size()), onRow);
+    }
+
+private:
+    template <class OnRow>
+    WireDecoder::Stats decodeRange(uint32_t from, uint32_t to, OnRow& onRow) const {
+        WireDecoder dec;
+        if (from > to || to > body_.size()) return dec.stats();   // open 에서 걸러지지만 범위가 뒤집히면 읽지 않음
+        dec.feed(body_.data() + from, to - from, onRow);
+        return dec.stats();
+    }
+
+    std::vector<SetlistSong> songs_;
+    std::vector<uint8_t> body_;
+    uint32_t rows_ = 0;
+    uint32_t trailerOffset_ = 0;
+};
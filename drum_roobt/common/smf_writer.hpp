@@ -0,0 +1,226 @@
+#pragma once
+
+// Standard MIDI File(SMF) 쓰기 (format 0 / 1)
+//  - 이벤트를 트랙별 배열에 모아 두었다가 render() 에서 한 번에 직렬화
+//  - 출력 크기 상한을 먼저 계산해서 버퍼를 한 번만 잡음 → 쓰는 동안 재할당 없음
+//  - running status 압축: 노트 끄기는 "노트 켜기 + 세기 0" 으로 써서 같은 채널이면 상태 바이트 생략
+//  - 템포(0x51) / 박자(0x58) / 트랙 이름(0x03) 메타 이벤트 지원
+//  - writeFile() 은 완성된 버퍼를 write() 한 번으로 기록
+//
+// 사용 예)
+//   SmfWriter smf(480, 1);
+//   smf.setTempo(0, 120.0);
+//   smf.setTimeSignature(0, 4, 4);
+//   int tr = smf.addTrack("R");
+//   smf.addNote(tr, tick, 9, 38, 100, 60);
+//   smf.writeFile("out.mid");
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// 템포 메타 이벤트는 4분음표 길이(us)를 24비트로 저장 → setTempo 에 줄 수 있는 bpm 범위
+const double SMF_MIN_BPM = 60000000.0 / 0xFFFFFF;   // 약 3.58 (이보다 느리면 24비트 넘침)
+const double SMF_MAX_BPM = 60000000.0;              // 4분음표 1us
+
+class SmfWriter {
+public:
+    // format 0: 모든 이벤트를 트랙 하나로 합침, format 1: 0번은 템포/박자 트랙, 나머지는 addTrack() 순서
+    explicit SmfWriter(int tpqn = 480, int format = 1) : tpqn_(tpqn), format_(format == 0 ? 0 : 1) {
+        tracks_.emplace_back();   // 0번 트랙 (템포/박자)
+    }
+
+    int tpqn() const { return tpqn_; }
+    int format() const { return format_; }
+
+    // format 0 이면 이름만 남기고 모든 이벤트를 0번 트랙에 넣음
+    int addTrack(const std::string& name = "") {
+        if (format_ == 0) {
+            if (!name.empty() && tracks_[0].name.empty()) tracks_[0].name = name;
+            return 0;
+        }
+        tracks_.emplace_back();
+        tracks_.back().name = name;
+        return static_cast<int>(tracks_.size()) - 1;
+    }
+
+    // bpm 은 [SMF_MIN_BPM, SMF_MAX_BPM] 안이어야 함 (호출 쪽에서 확인)
+    void setTempo(uint64_t tick, double bpm) {
+        uint32_t us = static_cast<uint32_t>(60000000.0 / bpm + 0.5);
+        unsigned char d[3] = {static_cast<unsigned char>(us >> 16), static_cast<unsigned char>(us >> 8),
+                              static_cast<unsigned char>(us)};
+        addMeta(0, tick, 0x51, d, 3);
+    }
+
+    // den 은 실제 분모 (4, 8 ...)
+    void setTimeSignature(uint64_t tick, int num, int den) {
+        unsigned char pow2 = 0;
+        while ((1 << pow2) < den && pow2 < 7) ++pow2;
+        unsigned char d[4] = {static_cast<unsigned char>(num), pow2, 24, 8};
+        addMeta(0, tick, 0x58, d, 4);
+    }
+
+    // 채널은 0부터 (GM 드럼 = 9). 노트 끄기는 tick + duration 에 자동 추가
+    // duration 0 은 1 tick 으로 (같은 tick 에서는 끄기가 켜기보다 먼저 나가므로 0 이면 노트가 안 꺼짐)
+    void addNote(int track, uint64_t tick, int channel, int note, int velocity, uint32_t duration) {
+        duration = std::max<uint32_t>(duration, 1);
+        Track& t = tracks_[track];
+        unsigned char st = static_cast<unsigned char>(0x90 | (channel & 0x0F));
+        unsigned char n = static_cast<unsigned char>(note & 0x7F);
+        unsigned char v = static_cast<unsigned char>(std::clamp(velocity, 1, 127));
+        t.events.push_back({tick, t.seq++, KIND_ON, st, n, v, 0, 0});
+        t.events.push_back({tick + duration, t.seq++, KIND_OFF, st, n, 0, 0, 0});
+    }
+
+    size_t noteCount() const {
+        size_t n = 0;
+        for (const auto& t : tracks_)
+            for (const auto& e : t.events) n += (e.kind == KIND_ON);
+        return n;
+    }
+
+    // 파일 전체를 buf 에 직렬화. 반환값은 바이트 수
+    size_t render(std::vector<unsigned char>& buf) {
+        // 이름 메타 이벤트 추가는 한 번만
+        if (!named_) {
+            for (size_t i = 0; i < tracks_.size(); ++i) {
+                const std::string& nm = tracks_[i].name;
+                if (!nm.empty())
+                    addMeta(static_cast<int>(i), 0, 0x03, reinterpret_cast<const unsigned char*>(nm.data()), nm.size(), true);
+            }
+            named_ = true;
+        }
+
+        // 상한: 이벤트당 delta(최대 5) + 상태 1 + 데이터 2, 메타는 + 길이(최대 5) + 내용
+        size_t bound = 14;
+        for (const auto& t : tracks_) bound += 8 + t.events.size() * 8 + t.metaBytes + 4 + 5;
+        buf.resize(bound);
+
+        unsigned char* p = buf.data();
+        auto put32 = [&](uint32_t v) { p[0] = v >> 24; p[1] = v >> 16; p[2] = v >> 8; p[3] = v; p += 4; };
+        auto put16 = [&](uint16_t v) { p[0] = v >> 8; p[1] = v; p += 2; };
+        auto putVlq = [&](uint64_t v) {
+            unsigned char tmp[10];
+            int n = 0;
+            tmp[n++] = v & 0x7F;
+            while (v >>= 7) tmp[n++] = 0x80 | (v & 0x7F);
+            while (n) *p++ = tmp[--n];
+        };
+
+        std::memcpy(p, "MThd", 4); p += 4;
+        put32(6);
+        put16(static_cast<uint16_t>(format_));
+        put16(static_cast<uint16_t>(tracks_.size()));
+        put16(static_cast<uint16_t>(tpqn_));
+
+        for (auto& t : tracks_) {
+            // 같은 tick 이면 메타 → 노트 끄기 → 노트 켜기 순, 그 안에서는 추가한 순서
+            // (앞 노트를 끄고 같은 노트를 다시 켜는 경우를 위한 순서, 길이 0 노트는 addNote 에서 1 tick 으로 늘림)
+            std::sort(t.events.begin(), t.events.end(), [](const Ev& a, const Ev& b) {
+                if (a.tick != b.tick) return a.tick < b.tick;
+                if (a.kind != b.kind) return kindRank(a.kind) < kindRank(b.kind);
+                return a.seq < b.seq;
+            });
+
+            std::memcpy(p, "MTrk", 4); p += 4;
+            unsigned char* lenPos = p;
+            p += 4;
+            unsigned char* body = p;
+
+            uint64_t last = 0;
+            unsigned char running = 0;
+            for (const Ev& e : t.events) {
+                putVlq(e.tick - last);
+                last = e.tick;
+                if (e.kind == KIND_META) {
+                    *p++ = 0xFF;
+                    *p++ = e.d1;
+                    putVlq(e.metaLen);
+                    std::memcpy(p, t.meta.data() + e.metaOff, e.metaLen);
+                    p += e.metaLen;
+                    running = 0;   // 메타 뒤에는 상태 바이트를 다시 씀 (일부 리더 호환)
+                } else {
+                    if (e.status != running) *p++ = running = e.status;
+                    *p++ = e.d1;
+                    *p++ = e.d2;
+                }
+            }
+            // End of Track
+            *p++ = 0x00; *p++ = 0xFF; *p++ = 0x2F; *p++ = 0x00;
+
+            uint32_t len = static_cast<uint32_t>(p - body);
+            lenPos[0] = len >> 24; lenPos[1] = len >> 16; lenPos[2] = len >> 8; lenPos[3] = len;
+        }
+
+        size_t n = p - buf.data();
+        buf.resize(n);
+        return n;
+    }
+
+    // render() 결과를 write() 한 번으로 기록 (부분 쓰기면 나머지만 이어서)
+    bool writeFile(const std::string& path) {
+        render(buf_);
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return false;
+        const unsigned char* p = buf_.data();
+        size_t left = buf_.size();
+        while (left > 0) {
+            ssize_t w = ::write(fd, p, left);
+            if (w < 0) {
+                if (errno == EINTR) continue;
+                ::close(fd);
+                return false;
+            }
+            p += w;
+            left -= static_cast<size_t>(w);
+        }
+        return ::close(fd) == 0;
+    }
+
+    const std::vector<unsigned char>& buffer() const { return buf_; }
+
+private:
+    enum : uint8_t { KIND_OFF = 0, KIND_ON = 1, KIND_META = 2 };
+
+    static int kindRank(uint8_t k) { return k == KIND_META ? 0 : (k == KIND_OFF ? 1 : 2); }
+
+    struct Ev {
+        uint64_t tick;
+        uint32_t seq;       // 같은 tick 안에서 추가 순서 유지용
+        uint8_t kind;       // 정렬 순서: 메타 → 끄기 → 켜기
+        uint8_t status;     // 채널 메시지 상태 바이트
+        uint8_t d1, d2;     // 노트/세기, 메타는 d1 = 메타 타입
+        uint32_t metaOff, metaLen;
+    };
+
+    struct Track {
+        std::string name;
+        std::vector<Ev> events;
+        std::vector<unsigned char> meta;   // 메타 이벤트 내용
+        size_t metaBytes = 0;              // 메타 이벤트 직렬화 상한 합
+        uint32_t seq = 0;
+    };
+
+    void addMeta(int track, uint64_t tick, uint8_t type, const unsigned char* d, size_t len, bool front = false) {
+        Track& t = tracks_[track];
+        uint32_t off = static_cast<uint32_t>(t.meta.size());
+        t.meta.insert(t.meta.end(), d, d + len);
+        // 트랙 이름은 맨 앞에 오도록 가장 작은 순번 사용
+        uint32_t seq = front ? 0 : ++t.seq;
+        t.events.push_back({tick, seq, KIND_META, 0xFF, type, 0, off, static_cast<uint32_t>(len)});
+        t.metaBytes += 2 + 5 + len;
+    }
+
+    int tpqn_;
+    int format_;
+    bool named_ = false;
+    std::vector<Track> tracks_;
+    std::vector<unsigned char> buf_;
+};
@@ -0,0 +1,223 @@
+#pragma once
+
+// 단계별 결과 캐시 (content-addressed)
+//  - 키 = hash(입력 파일 내용, 단계 이름, 단계 버전, 단계 파라미터(bpm, step ...))
+//  - 값 = 그 단계가 만든 출력 파일들(직렬화된 중간 이벤트 배열) + 작은 메타 문자열(예: bpm)
+//  - 입력 내용이 같으면 그 단계는 건너뛰고 캐시에서 출력만 복사 → 바뀐 단계부터 아래쪽만 다시 계산
+//  - 단계 코드를 고치면 해당 단계 버전을 올려야 함 (버전이 키에 들어감)
+//  - 전체 크기가 상한을 넘으면 가장 오래 안 쓴 항목부터 제거 (hit 때 mtime 갱신 → LRU)
+//
+// 캐시 항목 파일 형식: "DSC1" | 파트 개수(u32) | [이름 길이(u32) 이름 | 크기(u64) 내용] ...
+//   파트 이름 "#meta" 는 메타 문자열, 그 외는 출력 파일 순서 번호
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <algorithm>
+#include <functional>
+
+#include <unistd.h>
+
+#include "trace.hpp"
+
+class StageCache {
+public:
+    struct Stats {
+        int hits = 0;
+        int misses = 0;
+        uint64_t bytesStored = 0;
+        int evictions = 0;
+    };
+
+    StageCache(const std::filesystem::path& dir, uint64_t maxBytes)
+        : dir_(dir), maxBytes_(maxBytes) {
+        std::error_code ec;
+        std::filesystem::create_directories(dir_, ec);
+        if (ec) {
+            std::cerr << "캐시 디렉토리 생성 실패: " << dir_ << " (" << ec.message() << ")\n";
+            enabled_ = false;
+        }
+    }
+
+    void setEnabled(bool on) { enabled_ = on; }
+    void setVerbose(bool on) { verbose_ = on; }
+    const Stats& stats() const { return stats_; }
+
+    // FNV-1a 64비트
+    static uint64_t hashBytes(const void* data, size_t n, uint64_t h = 1469598103934665603ULL) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < n; ++i) {
+            h ^= p[i];
+            h *= 1099511628211ULL;
+        }
+        return h;
+    }
+
+    static bool readAll(const std::string& path, std::string& out) {
+        std::ifstream f(path, std::ios::binary);
+        if (!f) return false;
+        std::ostringstream ss;
+        ss << f.rdbuf();
+        out = ss.str();
+        return true;
+    }
+
+    // 단계 키 계산. 입력 파일이 없으면 빈 문자열 반환 (캐시 사용 안 함)
+    static std::string makeKey(const std::string& stage, int version, const std::string& params,
+                               const std::vector<std::string>& inputs) {
+        uint64_t h = hashBytes(stage.data(), stage.size());
+        h = hashBytes(&version, sizeof(version), h);
+        h = hashBytes(params.data(), params.size(), h);
+        std::string buf;
+        for (const auto& in : inputs) {
+            if (!readAll(in, buf)) return "";
+            uint64_t n = buf.size();
+            h = hashBytes(&n, sizeof(n), h);
+            h = hashBytes(buf.data(), buf.size(), h);
+        }
+        char hex[17];
+        std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(h));
+        return stage + "_" + hex;
+    }
+
+    // 캐시에 있으면 출력 파일들을 복원하고 true
+    // metaOk 가 있으면 저장된 메타를 먼저 확인하고, 틀리면(비었거나 깨짐) 없는 것으로 봄
+    bool load(const std::string& key, const std::vector<std::string>& outputs, std::string* meta,
+              const std::function<bool(const std::string&)>& metaOk = nullptr) {
+        if (!enabled_ || key.empty()) return false;
+        std::filesystem::path entry = dir_ / key;
+        std::string blob;
+        if (!readAll(entry.string(), blob) || blob.size() < 8 || blob.compare(0, 4, "DSC1") != 0) return false;
+
+        size_t pos = 4;
+        auto rd32 = [&](uint32_t& v) { if (pos + 4 > blob.size()) return false; std::memcpy(&v, &blob[pos], 4); pos += 4; return true; };
+        auto rd64 = [&](uint64_t& v) { if (pos + 8 > blob.size()) return false; std::memcpy(&v, &blob[pos], 8); pos += 8; return true; };
+
+        uint32_t parts;
+        if (!rd32(parts)) return false;
+        std::vector<std::pair<std::string, std::string>> decoded;
+        for (uint32_t i = 0; i < parts; ++i) {
+            uint32_t nameLen;
+            uint64_t size;
+            if (!rd32(nameLen) || pos + nameLen > blob.size()) return false;
+            std::string name = blob.substr(pos, nameLen);
+            pos += nameLen;
+            if (!rd64(size) || pos + size > blob.size()) return false;
+            decoded.emplace_back(name, blob.substr(pos, size));
+            pos += size;
+        }
+        if (decoded.size() != outputs.size() + 1) return false;
+        if (metaOk && !metaOk(decoded.back().second)) return false;
+
+        for (size_t i = 0; i < outputs.size(); ++i) {
+            std::ofstream f(outputs[i], std::ios::binary | std::ios::trunc);
+            if (!f) return false;
+            f.write(decoded[i].second.data(), decoded[i].second.size());
+        }
+        if (meta) *meta = decoded.back().second;
+
+        std::error_code ec;
+        std::filesystem::last_write_time(entry, std::filesystem::file_time_type::clock::now(), ec);
+        stats_.hits++;
+        return true;
+    }
+
+    void save(const std::string& key, const std::vector<std::string>& outputs, const std::string& meta) {
+        if (!enabled_ || key.empty()) return;
+        std::string blob = "DSC1";
+        auto wr32 = [&](uint32_t v) { blob.append(reinterpret_cast<const char*>(&v), 4); };
+        auto wr64 = [&](uint64_t v) { blob.append(reinterpret_cast<const char*>(&v), 8); };
+        auto part = [&](const std::string& name, const std::string& data) {
+            wr32(static_cast<uint32_t>(name.size()));
+            blob += name;
+            wr64(data.size());
+            blob += data;
+        };
+
+        wr32(static_cast<uint32_t>(outputs.size() + 1));
+        std::string buf;
+        for (size_t i = 0; i < outputs.size(); ++i) {
+            if (!readAll(outputs[i], buf)) return;
+            part(std::to_string(i), buf);
+        }
+        part("#meta", meta);
+
+        std::filesystem::path entry = dir_ / key;
+        // 같은 캐시 폴더를 여러 스레드/프로세스가 같이 쓰므로 임시 파일 이름은 객체마다 다르게
+        std::filesystem::path tmp = dir_ / (key + ".tmp" + std::to_string(reinterpret_cast<uintptr_t>(this)) +
+                                            "_" + std::to_string(::getpid()));
+        {
+            std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+            if (!f) return;
+            f.write(blob.data(), blob.size());
+        }
+        std::error_code ec;
+        std::filesystem::rename(tmp, entry, ec);
+        if (ec) return;
+        stats_.bytesStored += blob.size();
+        evict();
+    }
+
+    // 캐시 확인 → 없으면 run() 실행 후 저장. 캐시를 썼으면 true
+    // metaOk: 캐시의 메타를 쓸 수 있는지 (못 쓰면 miss 로 보고 다시 실행해서 덮어씀)
+    bool runStage(const std::string& stage, int version, const std::string& params,
+                  const std::vector<std::string>& inputs, const std::vector<std::string>& outputs,
+                  const std::function<void()>& run,
+                  std::string* meta = nullptr, const std::function<std::string()>& makeMeta = nullptr,
+                  const std::function<bool(const std::string&)>& metaOk = nullptr) {
+        TRACE_ZONE(drumtrace::intern(stage));
+        std::string key = enabled_ ? makeKey(stage, version, params, inputs) : "";
+        if (load(key, outputs, meta, metaOk)) {
+            if (verbose_) std::cout << "[캐시 hit] " << stage << "\n";
+            return true;
+        }
+        stats_.misses++;
+        TRACE_COUNTER("cache_misses", stats_.misses);
+        run();
+        std::string m = makeMeta ? makeMeta() : "";
+        if (meta) *meta = m;
+        save(key, outputs, m);
+        return false;
+    }
+
+    void printStats() const {
+        std::cout << "[캐시] hit " << stats_.hits << " / miss " << stats_.misses
+                  << ", 저장 " << stats_.bytesStored << " bytes, 제거 " << stats_.evictions << "\n";
+    }
+
+private:
+    // 전체 크기가 상한을 넘으면 오래 안 쓴 항목부터 삭제
+    void evict() {
+        struct Item { std::filesystem::path path; uint64_t size; std::filesystem::file_time_type mtime; };
+        std::vector<Item> items;
+        uint64_t total = 0;
+        std::error_code ec;
+        for (const auto& de : std::filesystem::directory_iterator(dir_, ec)) {
+            if (!de.is_regular_file(ec)) continue;
+            Item it{de.path(), de.file_size(ec), de.last_write_time(ec)};
+            total += it.size;
+            items.push_back(it);
+        }
+        if (total <= maxBytes_) return;
+        std::sort(items.begin(), items.end(), [](const Item& a, const Item& b) { return a.mtime < b.mtime; });
+        for (const auto& it : items) {
+            if (total <= maxBytes_) break;
+            if (std::filesystem::remove(it.path, ec)) {
+                total -= it.size;
+                stats_.evictions++;
+            }
+        }
+    }
+
+    std::filesystem::path dir_;
+    uint64_t maxBytes_;
+    bool enabled_ = true;
+    bool verbose_ = true;
+    Stats stats_;
+};
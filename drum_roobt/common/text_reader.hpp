@@ -0,0 +1,204 @@
+#pragma once
+
+// 구분자 텍스트(악보, 벨로시티, 센서 CSV) 공용 리더
+//  - 파일 전체를 mmap 하고 memchr 로 줄을 자름 (glibc memchr 는 SIMD)
+//  - 줄마다 istringstream / std::string 을 만들지 않고 string_view 로 필드를 나눔 → 줄 단위 할당 없음
+//  - 숫자는 std::from_chars 로 바로 변환 (예외/try-catch 없음)
+//  - 콤마/탭/공백 혼용, 줄 끝 \r, 파일 앞 BOM 을 한 곳에서 처리
+//  - 필요하면 숫자 열들을 열 단위 배열(ColumnTable)로 한 번에 읽음 (첫 줄 헤더 자동 감지)
+//    벨로시티 원본(시간 악기 세기)을 이렇게 읽음 (midi_final 의 MakeVelocitySummary)
+//
+// 사용 예)
+//   TextReader in(path);
+//   std::string_view line, f[8];
+//   while (in.nextLine(line)) {
+//       int n = splitFields(line, f, 8);
+//       double t; int note;
+//       if (n != 2 || !toDouble(f[0], t) || !toInt(f[1], note)) continue;
+//   }
+//
+//   ColumnTable cols;
+//   loadColumns(path, 3, cols);          // cols[0][i], cols[1][i], cols[2][i]
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <charconv>
+#include <cstring>
+#include <cstddef>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+class TextReader {
+public:
+    TextReader() = default;
+    explicit TextReader(const std::string& path) { open(path); }
+    ~TextReader() { close(); }
+    TextReader(const TextReader&) = delete;
+    TextReader& operator=(const TextReader&) = delete;
+
+    bool open(const std::string& path) {
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
+        }
+        ok_ = true;
+        if (st.st_size > 0) {
+            void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                ok_ = false;
+            } else {
+                madvise(p, st.st_size, MADV_SEQUENTIAL);
+                base_ = static_cast<const char*>(p);
+                size_ = static_cast<size_t>(st.st_size);
+            }
+        }
+        ::close(fd);
+        cur_ = base_;
+        end_ = base_ + size_;
+        // UTF-8 BOM 은 파일 맨 앞에서 한 번만 건너뜀
+        if (size_ >= 3 && (unsigned char)cur_[0] == 0xEF && (unsigned char)cur_[1] == 0xBB && (unsigned char)cur_[2] == 0xBF)
+            cur_ += 3;
+        return ok_;
+    }
+
+    void close() {
+        if (base_) munmap(const_cast<char*>(base_), size_);
+        base_ = cur_ = end_ = nullptr;
+        size_ = 0;
+        ok_ = false;
+    }
+
+    bool is_open() const { return ok_; }
+    size_t size() const { return size_; }
+
+    // 다음 줄 (개행 문자와 끝의 \r 제외). 파일 끝이면 false
+    bool nextLine(std::string_view& line) {
+        if (cur_ >= end_) return false;
+        const char* nl = static_cast<const char*>(std::memchr(cur_, '\n', end_ - cur_));
+        const char* stop = nl ? nl : end_;
+        const char* e = stop;
+        if (e > cur_ && e[-1] == '\r') --e;
+        line = std::string_view(cur_, e - cur_);
+        cur_ = nl ? nl + 1 : end_;
+        return true;
+    }
+
+private:
+    const char* base_ = nullptr;
+    const char* cur_ = nullptr;
+    const char* end_ = nullptr;
+    size_t size_ = 0;
+    bool ok_ = false;
+};
+
+inline bool isFieldDelim(char c) {
+    return c == ' ' || c == '\t' || c == ',' || c == '\r';
+}
+
+// 콤마/탭/공백(연속 구분자는 하나로 취급)으로 필드 분리
+// out 에는 최대 maxFields 개까지 저장하고, 반환값은 실제 필드 개수
+inline int splitFields(std::string_view line, std::string_view* out, int maxFields) {
+    const char* p = line.data();
+    const char* e = p + line.size();
+    int n = 0;
+    while (true) {
+        while (p < e && isFieldDelim(*p)) ++p;
+        if (p >= e) break;
+        const char* b = p;
+        while (p < e && !isFieldDelim(*p)) ++p;
+        if (n < maxFields) out[n] = std::string_view(b, p - b);
+        ++n;
+    }
+    return n;
+}
+
+// 앞뒤 공백 제거
+inline std::string_view trimView(std::string_view s) {
+    size_t b = 0, e = s.size();
+    while (b < e && (s[b] == ' ' || s[b] == '\t' || s[b] == '\r' || s[b] == '\n')) ++b;
+    while (e > b && (s[e-1] == ' ' || s[e-1] == '\t' || s[e-1] == '\r' || s[e-1] == '\n')) --e;
+    return s.substr(b, e - b);
+}
+
+// stod/stoi 처럼 앞부분 숫자만 읽어도 성공 ("12abc" → 12). 숫자가 하나도 없으면 false
+inline bool toDouble(std::string_view s, double& v) {
+    const char* b = s.data();
+    const char* e = b + s.size();
+    if (b < e && *b == '+') ++b;
+    return std::from_chars(b, e, v).ec == std::errc();
+}
+
+inline bool toInt(std::string_view s, int& v) {
+    const char* b = s.data();
+    const char* e = b + s.size();
+    if (b < e && *b == '+') ++b;
+    return std::from_chars(b, e, v).ec == std::errc();
+}
+
+inline bool looksNumber(std::string_view s) {
+    double d;
+    return toDouble(s, d);
+}
+
+// 숫자 열 묶음 (열 단위 배열)
+struct ColumnTable {
+    std::vector<std::vector<double>> cols;
+    std::vector<size_t> lineNo;   // 각 행의 원본 줄 번호 (1부터)
+    bool hadHeader = false;
+
+    size_t rows() const { return cols.empty() ? 0 : cols[0].size(); }
+    const std::vector<double>& operator[](size_t c) const { return cols[c]; }
+};
+
+const int LOAD_COLUMNS_MAX = 32;
+
+// 앞에서부터 ncols 개 숫자 열을 읽음 (ncols 는 1 ~ LOAD_COLUMNS_MAX, 벗어나면 false)
+//  - 첫 번째 내용 있는 줄이 숫자로 시작하지 않으면 헤더로 보고 한 번만 건너뜀
+//  - 필드가 모자라거나 숫자가 아닌 줄은 건너뜀
+inline bool loadColumns(const std::string& path, int ncols, ColumnTable& table) {
+    table.cols.clear();
+    table.lineNo.clear();
+    table.hadHeader = false;
+    if (ncols < 1 || ncols > LOAD_COLUMNS_MAX) return false;
+    TextReader in(path);
+    if (!in.is_open()) return false;
+
+    table.cols.assign(ncols, {});
+    // 대략적인 줄 수로 미리 확보 (평균 한 줄 16바이트 가정)
+    for (auto& c : table.cols) c.reserve(in.size() / 16 + 1);
+    table.lineNo.reserve(in.size() / 16 + 1);
+
+    std::string_view line, f[LOAD_COLUMNS_MAX];
+    bool first = true;
+    size_t lineNo = 0;
+    while (in.nextLine(line)) {
+        ++lineNo;
+        int n = splitFields(line, f, LOAD_COLUMNS_MAX);
+        if (n == 0) continue;
+        if (first) {
+            first = false;
+            if (!looksNumber(f[0])) {
+                table.hadHeader = true;
+                continue;
+            }
+        }
+        if (n < ncols) continue;
+        double v[LOAD_COLUMNS_MAX];
+        bool ok = true;
+        for (int c = 0; c < ncols; ++c) {
+            if (!toDouble(f[c], v[c])) { ok = false; break; }
+        }
+        if (!ok) continue;
+        for (int c = 0; c < ncols; ++c) table.cols[c].push_back(v[c]);
+        table.lineNo.push_back(lineNo);
+    }
+    return true;
+}
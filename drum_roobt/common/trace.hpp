@@ -0,0 +1,242 @@
+#pragma once
+
+// 구간/카운터 계측 → Chrome trace-event JSON (chrome://tracing, ui.perfetto.dev 에서 열기)
+//  - DRUM_TRACE 를 정의하고 빌드할 때만 동작 (g++ -DDRUM_TRACE ...). 정의하지 않으면 매크로가 모두 비어서 코드가 남지 않음
+//  - TRACE_ZONE(이름)          범위(scope) 시작~끝을 한 구간으로 기록 (이름은 문자열 리터럴처럼 끝까지 살아 있는 포인터)
+//  - TRACE_COUNTER(이름, 값)   그 시각의 값 (그래프로 보임)
+//  - TRACE_THREAD(이름)        현재 스레드 이름 (워커, 디스패처 ...)
+//  - TRACE_DUMP(경로)          지금까지 모든 스레드에서 모은 기록을 JSON 으로 씀
+//  - 실행 중에 만든 이름(단계 이름 std::string 등)은 drumtrace::intern() 으로 고정된 포인터를 받아 씀
+//
+//  - 스레드마다 자기 버퍼(고정 크기 블록 목록)에만 쓰므로 기록할 때 잠금/원자 연산 없음
+//    (버퍼 등록만 처음 한 번 mutex). 버퍼는 스레드가 끝나도 남아 있어 워커가 끝난 뒤에도 덤프 가능
+//  - 시각은 x86 이면 rdtsc (수 ns), 아니면 steady_clock. 덤프할 때 steady_clock 과 비교해 us 로 바꿈
+//  - 스레드당 TRACE_MAX_EVENTS 를 넘으면 더 기록하지 않고 버린 개수만 셈 (오래 도는 데몬에서 메모리 상한)
+//  - 덤프는 기록 중인 스레드가 없을 때 (워커 join 뒤, 종료 직전) 부르는 것을 전제로 함
+//
+// 사용 예)
+//   void convert() {
+//       TRACE_ZONE("convert");
+//       ...
+//       TRACE_COUNTER("events", n);
+//   }
+//   TRACE_THREAD("worker");
+//   TRACE_ZONE(drumtrace::intern(stageName));
+//   TRACE_DUMP("trace.json");
+
+#ifdef DRUM_TRACE
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <unordered_set>
+#include <cstdint>
+
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace drumtrace {
+
+const size_t TRACE_BLOCK_EVENTS = 1 << 14;
+const size_t TRACE_MAX_EVENTS = 1 << 21;   // 스레드당 (이벤트 32 bytes → 64MB)
+
+struct Event {
+    const char* name;
+    uint64_t start;        // 시각 원본 단위 (rdtsc 또는 ns)
+    union {
+        uint64_t end;      // 구간 끝
+        double value;      // 카운터 값
+    };
+    bool counter;
+};
+
+struct ThreadBuffer {
+    int tid = 0;
+    std::string name;
+    std::vector<std::unique_ptr<Event[]>> blocks;
+    size_t count = 0;
+    size_t dropped = 0;
+
+    Event* push() {
+        if (count >= TRACE_MAX_EVENTS) {
+            ++dropped;
+            return nullptr;
+        }
+        size_t b = count / TRACE_BLOCK_EVENTS, i = count % TRACE_BLOCK_EVENTS;
+        if (b == blocks.size()) blocks.emplace_back(new Event[TRACE_BLOCK_EVENTS]);
+        ++count;
+        return &blocks[b][i];
+    }
+    const Event& at(size_t k) const { return blocks[k / TRACE_BLOCK_EVENTS][k % TRACE_BLOCK_EVENTS]; }
+};
+
+inline uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+struct Registry {
+    std::mutex mu;
+    std::vector<std::unique_ptr<ThreadBuffer>> threads;
+    std::unordered_set<std::string> names;
+    uint64_t origin = now();   // 첫 사용 시각 (덤프의 0)
+    std::chrono::steady_clock::time_point originClock = std::chrono::steady_clock::now();
+};
+
+inline Registry& registry() {
+    static Registry r;
+    return r;
+}
+
+inline ThreadBuffer& localBuffer() {
+    thread_local ThreadBuffer* buf = nullptr;
+    if (!buf) {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lk(r.mu);
+        r.threads.emplace_back(new ThreadBuffer);
+        buf = r.threads.back().get();
+        buf->tid = static_cast<int>(r.threads.size());
+    }
+    return *buf;
+}
+
+// 실행 중 만든 이름을 프로세스 끝까지 살아 있는 포인터로 (같은 문자열은 같은 포인터)
+inline const char* intern(const std::string& s) {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lk(r.mu);
+    return r.names.insert(s).first->c_str();
+}
+
+inline void setThreadName(const std::string& name) { localBuffer().name = name; }
+
+inline void counter(const char* name, double value) {
+    Event* e = localBuffer().push();
+    if (!e) return;
+    e->name = name;
+    e->start = now();
+    e->value = value;
+    e->counter = true;
+}
+
+class Zone {
+public:
+    explicit Zone(const char* name) : name_(name), start_(now()) {}
+    ~Zone() {
+        uint64_t end = now();
+        Event* e = localBuffer().push();
+        if (!e) return;
+        e->name = name_;
+        e->start = start_;
+        e->end = end;
+        e->counter = false;
+    }
+    Zone(const Zone&) = delete;
+    Zone& operator=(const Zone&) = delete;
+
+private:
+    const char* name_;
+    uint64_t start_;
+};
+
+inline void writeJsonString(std::ostream& o, const char* s) {
+    o << '"';
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') o << '\\' << *s;
+        else if (static_cast<unsigned char>(*s) < 0x20) o << ' ';
+        else o << *s;
+    }
+    o << '"';
+}
+
+// 모든 스레드 기록을 Chrome trace JSON 으로. 반환: 쓴 이벤트 수 (실패 -1)
+inline long dump(const std::string& path) {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lk(r.mu);
+
+    // 원본 시각 단위 → us (rdtsc 는 지금까지 흐른 steady_clock 시간으로 주파수를 구함)
+    double usPerTick = 1e-3;
+#if defined(__x86_64__) || defined(__i386__)
+    double elapsedUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - r.originClock).count();
+    uint64_t ticks = now() - r.origin;
+    if (ticks > 0 && elapsedUs > 0) usPerTick = elapsedUs / static_cast<double>(ticks);
+#endif
+    auto us = [&](uint64_t t) { return t < r.origin ? 0.0 : static_cast<double>(t - r.origin) * usPerTick; };
+
+    std::ofstream o(path, std::ios::trunc);
+    if (!o) {
+        std::cerr << "trace 파일 열기 실패: " << path << "\n";
+        return -1;
+    }
+    const int pid = static_cast<int>(::getpid());
+    long written = 0;
+    size_t dropped = 0;
+    o.setf(std::ios::fixed);
+    o.precision(3);
+    o << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    auto sep = [&] {
+        if (!first) o << ",\n";
+        first = false;
+    };
+    for (const auto& tb : r.threads) {
+        dropped += tb->dropped;
+        if (!tb->name.empty()) {
+            sep();
+            o << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << tb->tid << ",\"args\":{\"name\":";
+            writeJsonString(o, tb->name.c_str());
+            o << "}}";
+        }
+        for (size_t k = 0; k < tb->count; ++k) {
+            const Event& e = tb->at(k);
+            sep();
+            o << "{\"name\":";
+            writeJsonString(o, e.name);
+            if (e.counter) {
+                o << ",\"ph\":\"C\",\"pid\":" << pid << ",\"tid\":" << tb->tid << ",\"ts\":" << us(e.start)
+                  << ",\"args\":{\"value\":" << e.value << "}}";
+            } else {
+                o << ",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << tb->tid << ",\"ts\":" << us(e.start)
+                  << ",\"dur\":" << static_cast<double>(e.end - e.start) * usPerTick << "}";
+            }
+            ++written;
+        }
+    }
+    o << "\n]}\n";
+    if (!o) {
+        std::cerr << "trace 파일 쓰기 실패: " << path << "\n";
+        return -1;
+    }
+    std::cout << "[trace] " << path << ": 이벤트 " << written << "개, 스레드 " << r.threads.size() << "개"
+              << (dropped ? ", 상한 초과로 버림 " + std::to_string(dropped) + "개" : std::string()) << "\n";
+    return written;
+}
+
+}  // namespace drumtrace
+
+#define DRUM_TRACE_CAT2(a, b) a##b
+#define DRUM_TRACE_CAT(a, b) DRUM_TRACE_CAT2(a, b)
+#define TRACE_ZONE(name) drumtrace::Zone DRUM_TRACE_CAT(traceZone_, __LINE__)(name)
+#define TRACE_COUNTER(name, value) drumtrace::counter(name, static_cast<double>(value))
+#define TRACE_THREAD(name) drumtrace::setThreadName(name)
+#define TRACE_DUMP(path) drumtrace::dump(path)
+
+#else
+
+#define TRACE_ZONE(name) ((void)0)
+#define TRACE_COUNTER(name, value) ((void)0)
+#define TRACE_THREAD(name) ((void)0)
+#define TRACE_DUMP(path) ((void)0)
+
+#endif
@@ -0,0 +1,124 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <iomanip>
+#include <cstring>
+
+#include "../common/text_reader.hpp"
+#include "../common/hand_table.hpp"
+
+// 손 배정 결정표 만들기 / 검증
+//  - --gen        표 생성 후 저장 (키트 좌표나 배정 규칙을 바꿨을 때 한 번)
+//  - 기본(검증)    output3_mc2c.csv 들을 원래 분기 코드(assignEvent)와 표(assignEventTable)로 각각 배정해서
+//                 줄마다 결과를 비교, 다르면 목록 출력 후 종료 코드 2
+//
+// 사용법: ./hand_table --gen [--table=hand_table.bin]
+//         ./hand_table [--table=hand_table.bin] [--quiet] output3_mc2c.csv...
+
+bool loadEvents(const std::string& file, std::vector<FullEvent>& events) {
+    TextReader in(file);
+    if (!in.is_open()) {
+        std::cerr << "입력 파일 열기 실패: " << file << "\n";
+        return false;
+    }
+    std::string_view line, f[7];
+    while (in.nextLine(line)) {
+        if (splitFields(line, f, 7) != 7) continue;
+        FullEvent e;
+        if (!toDouble(f[0], e.time) || !toInt(f[1], e.inst1) || !toInt(f[2], e.inst2) ||
+            !toInt(f[5], e.bassHit) || !toInt(f[6], e.hihat)) continue;
+        events.push_back(e);
+    }
+    return true;
+}
+
+// 반환값: 0 같음, 1 파일 오류, 2 결과 다름
+int verifyFile(const std::string& file, const HandDecisionTable& table, bool quiet, double& nsBranch, double& nsTable,
+               size_t& total) {
+    std::vector<FullEvent> ref;
+    if (!loadEvents(file, ref)) return 1;
+    std::vector<FullEvent> tab = ref;
+
+    handLogEnabled = false;
+    auto t0 = std::chrono::steady_clock::now();
+    HandState s1;
+    assignHandsSerial(ref, s1);
+    auto t1 = std::chrono::steady_clock::now();
+    HandState s2;
+    assignHandsTable(tab, s2, table);
+    auto t2 = std::chrono::steady_clock::now();
+    nsBranch += std::chrono::duration<double, std::nano>(t1 - t0).count();
+    nsTable += std::chrono::duration<double, std::nano>(t2 - t1).count();
+    total += ref.size();
+
+    int diff = 0;
+    for (size_t i = 0; i < ref.size(); ++i) {
+        if (ref[i].rightHand == tab[i].rightHand && ref[i].leftHand == tab[i].leftHand) continue;
+        ++diff;
+        if (!quiet)
+            std::cout << file << ": 줄 " << i + 1 << " (" << ref[i].inst1 << "," << ref[i].inst2 << ") 분기 R="
+                      << ref[i].rightHand << " L=" << ref[i].leftHand << ", 표 R=" << tab[i].rightHand
+                      << " L=" << tab[i].leftHand << "\n";
+    }
+    if (!sameEffect(s1, s2)) ++diff;
+    if (!quiet || diff)
+        std::cout << "[요약] " << file << ": 이벤트 " << ref.size() << "개, 다른 줄 " << diff
+                  << (diff ? "  → FAIL" : "  → OK") << "\n";
+    return diff ? 2 : 0;
+}
+
+int main(int argc, char** argv) {
+    std::ios::sync_with_stdio(false);
+
+    std::string tablePath = "hand_table.bin";
+    bool gen = false, quiet = false;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        if (std::strcmp(a, "--gen") == 0) gen = true;
+        else if (std::strncmp(a, "--table=", 8) == 0) tablePath = a + 8;
+        else if (std::strcmp(a, "--quiet") == 0) quiet = true;
+        else files.push_back(a);
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    HandDecisionTable table;
+    if (gen) {
+        auto t0 = std::chrono::steady_clock::now();
+        table.build();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        if (!table.save(tablePath)) {
+            std::cerr << "표 저장 실패: " << tablePath << "\n";
+            return 1;
+        }
+        std::cout << "[생성] " << tablePath << " (" << table.bytes() << " bytes, 규칙 버전 " << HAND_TABLE_VERSION
+                  << ", " << ms << " ms)\n";
+        return 0;
+    }
+
+    if (!table.load(tablePath)) {
+        std::cout << "[알림] " << tablePath << " 없음 또는 키트/규칙 버전 다름 → 새로 생성해서 검증\n";
+        table.build();
+    }
+
+    if (files.empty()) {
+        std::string file;
+        std::cout << "output3_mc2c.csv 경로: ";
+        std::cin >> file;
+        files.push_back(file);
+    }
+
+    int result = 0, failed = 0;
+    double nsBranch = 0, nsTable = 0;
+    size_t total = 0;
+    for (const auto& f : files) {
+        int r = verifyFile(f, table, quiet, nsBranch, nsTable, total);
+        if (r != 0) failed++;
+        if (r > result) result = r;
+    }
+    std::cout << "[전체] " << files.size() << "곡, 이벤트 " << total << "개, " << failed << "곡 불일치\n";
+    if (total)
+        std::cout << "  분기 코드 " << nsBranch / total << " ns/이벤트, 결정표 " << nsTable / total << " ns/이벤트\n";
+    return result;
+}
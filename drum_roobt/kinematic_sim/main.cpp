@@ -0,0 +1,186 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <cstdlib>
+#include <cstring>
+
+#include "../common/kinematic_sim.hpp"
+
+// 최종 악보(output6_final_*.txt) 오프라인 운동 시뮬레이션
+//  - 기본: --speed 속도로 한 번 돌려 <파일>_sim.txt 에 타격마다 악보 시각 / 실제 시각 / 오차(ms) 기록
+//          허용 오차(--tol)를 넘는 타격이 있으면 목록 출력 후 종료 코드 2 (score_check 와 같은 규칙)
+//  - --sweep=50:200:5   속도 50%~200% 를 5% 간격으로 모든 코어에서 돌려 곡마다 칠 수 있는 최대 속도 출력
+//                       (--bpm=원곡bpm 을 주면 bpm 으로도 표시)
+//
+// 사용법: ./kinematic_sim [--vmax=4.0] [--amax=30] [--lift=0.0] [--dwell=0.0] [--tol=0.010]
+//                         [--speed=100 | --sweep=from:to:step [--bpm=120] [--threads=N]] [--quiet] 파일...
+
+struct SimConfig {
+    MotionProfile prof;
+    float dwell = 0.0f;
+    float tol = 0.010f;
+    double speed = 100.0;
+    double sweepFrom = 0, sweepTo = 0, sweepStep = 0;
+    double bpm = 0.0;
+    unsigned threads = 0;
+    bool quiet = false;
+};
+
+// 반환값: 0 통과, 1 파일 오류, 2 늦은 타격 있음
+int simulateFile(const std::string& file, const SimConfig& cfg) {
+    SimScore score;
+    if (!score.load(file, cfg.prof)) return 1;
+
+    auto t0 = std::chrono::steady_clock::now();
+    SimResult res;
+    simulateScore(score, cfg.speed, cfg.dwell, cfg.tol, res, true);
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+
+    size_t dot = file.find_last_of('.');
+    std::string out = (dot == std::string::npos ? file : file.substr(0, dot)) + "_sim.txt";
+    std::ofstream o(out);
+    if (!o.is_open()) {
+        std::cerr << "출력 파일 생성 실패: " << out << "\n";
+        return 1;
+    }
+    std::cout << std::fixed << std::setprecision(3);
+    o << std::fixed << std::setprecision(3);
+    o << "measure\trow\thand\tinst\tsched\tactual\terr_ms\n";
+    for (const SimHit& h : res.hits) {
+        float errMs = (h.actual - h.sched) * 1000.0f;
+        o << h.measure << '\t' << h.row << '\t' << (h.hand ? 'L' : 'R') << '\t' << (int)h.inst << '\t' << h.sched
+          << '\t' << h.actual << '\t' << errMs << '\n';
+        if (!cfg.quiet && h.actual - h.sched > cfg.tol)
+            std::cout << file << ": measure " << h.measure << " row " << h.row << " " << (h.hand ? "L" : "R")
+                      << " 악기 " << (int)h.inst << " " << errMs << "ms 늦음\n";
+    }
+
+    double songSec = score.length * 100.0 / cfg.speed;
+    std::cout << "[요약] " << file << " → " << out << " (속도 " << cfg.speed << "%)\n"
+              << "  타격 " << res.hitCount << "개, 곡 " << songSec << "s, 계산 " << us << " us\n"
+              << "  오차 평균 " << res.meanErr() * 1000.0 << "ms, 최대 " << res.maxErr * 1000.0 << "ms\n"
+              << "  늦은 타격(>" << cfg.tol * 1000.0f << "ms): " << res.late << "개"
+              << (res.late ? ", 처음 마디 " + std::to_string(res.firstLateMeasure) : std::string())
+              << (res.late ? "  → FAIL" : "  → OK") << "\n";
+    return res.late ? 2 : 0;
+}
+
+// 곡 × 속도 조합을 스레드들이 나눠 가짐 (원자 카운터로 다음 조합 가져가기)
+int sweep(const std::vector<std::string>& files, const SimConfig& cfg) {
+    std::vector<double> speeds;
+    for (double s = cfg.sweepFrom; s <= cfg.sweepTo + 1e-9; s += cfg.sweepStep) speeds.push_back(s);
+    if (speeds.empty() || cfg.sweepStep <= 0) {
+        std::cerr << "--sweep=from:to:step 형식 오류\n";
+        return 1;
+    }
+
+    std::vector<SimScore> scores(files.size());
+    for (size_t i = 0; i < files.size(); ++i)
+        if (!scores[i].load(files[i], cfg.prof)) return 1;
+
+    const size_t S = speeds.size();
+    const size_t jobs = files.size() * S;
+    std::vector<float> maxErr(jobs);
+    std::vector<uint32_t> late(jobs);
+    std::atomic<size_t> next{0};
+    unsigned nThreads = cfg.threads ? cfg.threads : std::max(1u, std::thread::hardware_concurrency());
+    nThreads = static_cast<unsigned>(std::min<size_t>(nThreads, jobs));
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned w = 0; w < nThreads; ++w) {
+        workers.emplace_back([&] {
+            SimResult res;
+            for (size_t j; (j = next.fetch_add(1, std::memory_order_relaxed)) < jobs;) {
+                simulateScore(scores[j / S], speeds[j % S], cfg.dwell, cfg.tol, res);
+                maxErr[j] = res.maxErr;
+                late[j] = res.late;
+            }
+        });
+    }
+    for (auto& t : workers) t.join();
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    // 최대 속도 = 느린 쪽부터 처음 실패하기 직전 속도 (가장 느린 속도부터 실패면 없음)
+    std::cout << std::fixed << std::setprecision(1);
+    int none = 0;
+    for (size_t i = 0; i < files.size(); ++i) {
+        size_t ok = 0;
+        while (ok < S && late[i * S + ok] == 0) ++ok;
+        std::cout << files[i] << ": ";
+        if (ok == 0) {
+            ++none;
+            std::cout << speeds[0] << "% 에서도 늦음 (최대 " << maxErr[i * S] * 1000.0f << "ms)\n";
+            continue;
+        }
+        double best = speeds[ok - 1];
+        std::cout << "최대 " << best << "%";
+        if (cfg.bpm > 0) std::cout << " (" << cfg.bpm * best / 100.0 << " bpm)";
+        if (ok < S) std::cout << ", " << speeds[ok] << "% 에서 " << late[i * S + ok] << "타 늦음";
+        else std::cout << ", 스윕 범위 끝까지 통과";
+        std::cout << "\n";
+    }
+    std::cout << "[전체] " << files.size() << "곡 × " << S << "개 속도 = " << jobs << "회, " << nThreads << "스레드, "
+              << ms << " ms";
+    if (none) std::cout << ", " << none << "곡은 최저 속도에서도 실패";
+    std::cout << "\n";
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    std::ios::sync_with_stdio(false);
+
+    SimConfig cfg;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        if (std::strncmp(a, "--vmax=", 7) == 0) cfg.prof.vmax = std::atof(a + 7);
+        else if (std::strncmp(a, "--amax=", 7) == 0) cfg.prof.amax = std::atof(a + 7);
+        else if (std::strncmp(a, "--lift=", 7) == 0) cfg.prof.lift = std::atof(a + 7);
+        else if (std::strncmp(a, "--dwell=", 8) == 0) cfg.dwell = std::atof(a + 8);
+        else if (std::strncmp(a, "--tol=", 6) == 0) cfg.tol = std::atof(a + 6);
+        else if (std::strncmp(a, "--speed=", 8) == 0) cfg.speed = std::atof(a + 8);
+        else if (std::strncmp(a, "--sweep=", 8) == 0) {
+            if (std::sscanf(a + 8, "%lf:%lf:%lf", &cfg.sweepFrom, &cfg.sweepTo, &cfg.sweepStep) != 3) cfg.sweepStep = -1;
+        }
+        else if (std::strncmp(a, "--bpm=", 6) == 0) cfg.bpm = std::atof(a + 6);
+        else if (std::strncmp(a, "--threads=", 10) == 0) cfg.threads = std::atoi(a + 10);
+        else if (std::strcmp(a, "--quiet") == 0) cfg.quiet = true;
+        else files.push_back(a);
+    }
+    if (cfg.prof.vmax <= 0 || cfg.prof.amax <= 0 || cfg.speed <= 0) {
+        std::cerr << "vmax/amax/speed 는 0보다 커야 함\n";
+        return 1;
+    }
+
+    if (files.empty()) {
+        std::string file;
+        std::cout << "악보 파일 경로: ";
+        std::cin >> file;
+        files.push_back(file);
+    }
+
+    if (cfg.sweepStep != 0) {
+        if (cfg.sweepStep < 0 || cfg.sweepFrom <= 0) {
+            std::cerr << "--sweep=from:to:step 형식 오류\n";
+            return 1;
+        }
+        return sweep(files, cfg);
+    }
+
+    int result = 0;
+    int failed = 0;
+    for (const auto& f : files) {
+        int r = simulateFile(f, cfg);
+        if (r != 0) failed++;
+        if (r > result) result = r;
+    }
+    if (files.size() > 1)
+        std::cout << "[전체] " << files.size() << "곡 중 " << failed << "곡 실패\n";
+    return result;
+}
@@ -0,0 +1,316 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <random>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include "../common/text_reader.hpp"
+#include "../common/hand_assign.hpp"
+#include "../common/motion_onset.hpp"
+
+// 드럼 키트 배치 최적화 (담금질 기법)
+//  - 변수: 악기별 좌표 (원래 drumXYZ 에서 축마다 ±range 안, 악기끼리 sep 이상 떨어져야 함, --fix 악기는 고정)
+//  - 평가: 곡마다 후보 키트로 손 배정(assignEvent, activeKit 교체)을 다시 하고
+//          손별 스틱 이동 거리 합 + late 가중치 × (이동 시간이 타격 간격보다 긴 만큼의 합) 을 비용으로 씀
+//  - 입력은 midi_final 이 만든 output3_mc2c.csv (배정 전 단계라 키트와 무관) → 곡마다 한 번만 읽음
+//    디렉터리를 주면 아래의 output3_mc2c.csv 를 모두 찾음
+//    (예: 0_미디파일_250703/, midifile/midbox/ 의 MIDI 를 midi_final 로 한 번 돌린 output/ 디렉터리)
+//  - 한 단계에 후보 batch 개를 만들어 코어마다 나눠 평가하고 가장 좋은 후보로 메트로폴리스 판정
+//    후보 생성/판정은 메인 스레드의 난수 하나로 하므로 스레드 수와 관계없이 결과가 같음
+//
+// 사용법: ./kit_opt [--iters=2000] [--batch=4] [--threads=N] [--range=0.15] [--sep=0.20] [--fix=1]
+//                   [--late=10] [--seed=1] [--top=5] [--out=kit_best.txt] output3_mc2c.csv 또는 디렉터리...
+
+struct OptConfig {
+    int iters = 2000;
+    int batch = 4;
+    unsigned threads = 0;
+    double range = 0.15;
+    double sep = 0.20;
+    double lateWeight = 10.0;    // 늦은 1초 = 이동 거리 10m 와 같은 비용
+    uint64_t seed = 1;
+    int top = 5;
+    bool fixed[NUM_INST] = {true, true};   // 0(악기 없음), 1(스네어) 고정
+    std::string out = "kit_best.txt";
+    MotionProfile prof;
+};
+
+struct Song {
+    std::string name;
+    std::vector<FullEvent> events;
+};
+
+struct SongScore {
+    double travel = 0.0;     // 스틱 이동 거리 합 [m]
+    double lateSec = 0.0;    // 이동 시간 - 타격 간격 (양수만) 합 [s]
+    int late = 0;
+};
+
+using Kit = std::vector<Coord>;
+
+bool loadSong(const std::string& file, Song& song) {
+    TextReader in(file);
+    if (!in.is_open()) {
+        std::cerr << "입력 파일 열기 실패: " << file << "\n";
+        return false;
+    }
+    std::string_view line, f[7];
+    while (in.nextLine(line)) {
+        if (splitFields(line, f, 7) != 7) continue;
+        FullEvent e;
+        if (!toDouble(f[0], e.time) || !toInt(f[1], e.inst1) || !toInt(f[2], e.inst2) ||
+            !toInt(f[5], e.bassHit) || !toInt(f[6], e.hihat)) continue;
+        song.events.push_back(e);
+    }
+    std::filesystem::path p(file);
+    song.name = p.has_parent_path() ? p.parent_path().filename().string() : p.stem().string();
+    return true;
+}
+
+// 곡 하나 평가 (work 는 스레드마다 재사용하는 배정 버퍼)
+SongScore evaluateSong(const Song& song, const Kit& kit, const MotionProfile& prof, std::vector<FullEvent>& work) {
+    activeKit = kit.data();
+    work = song.events;
+    HandState st;
+    for (auto& e : work) assignEvent(e, st);
+
+    SongScore sc;
+    int prev[2] = {1, 1};
+    double lastHit[2] = {0.0, 0.0};
+    double t = 0.0;
+    for (const auto& e : work) {
+        t += e.time;
+        int cur[2] = {e.rightHand, e.leftHand};
+        for (int h = 0; h < 2; ++h) {
+            if (cur[h] <= 0 || cur[h] >= NUM_INST) continue;
+            double d = dist(kit[prev[h]], kit[cur[h]]);
+            double need = motionTravelTime(static_cast<float>(d), prof);
+            double gap = t - lastHit[h];
+            sc.travel += d;
+            if (need > gap) {
+                sc.lateSec += need - gap;
+                ++sc.late;
+            }
+            prev[h] = cur[h];
+            lastHit[h] = t;
+        }
+    }
+    return sc;
+}
+
+double songCost(const SongScore& s, const OptConfig& cfg) { return s.travel + cfg.lateWeight * s.lateSec; }
+
+// 후보 여러 개를 스레드에 나눠 평가 → costs[i]
+void evaluateBatch(const std::vector<Song>& songs, const std::vector<Kit>& kits, const OptConfig& cfg,
+                   std::vector<double>& costs) {
+    costs.assign(kits.size(), 0.0);
+    unsigned nThreads = cfg.threads ? cfg.threads : std::max(1u, std::thread::hardware_concurrency());
+    nThreads = std::min<unsigned>(nThreads, static_cast<unsigned>(kits.size()));
+    auto work = [&](unsigned w) {
+        handLogEnabled = false;
+        std::vector<FullEvent> buf;
+        for (size_t k = w; k < kits.size(); k += nThreads) {
+            double c = 0.0;
+            for (const auto& s : songs) c += songCost(evaluateSong(s, kits[k], cfg.prof, buf), cfg);
+            costs[k] = c;
+        }
+    };
+    std::vector<std::thread> workers;
+    for (unsigned w = 1; w < nThreads; ++w) workers.emplace_back(work, w);
+    work(0);
+    for (auto& t : workers) t.join();
+}
+
+bool feasible(const Kit& kit, const OptConfig& cfg) {
+    for (int a = 1; a < NUM_INST; ++a) {
+        if (std::abs(kit[a].x - drumXYZ[a].x) > cfg.range + 1e-12 || std::abs(kit[a].y - drumXYZ[a].y) > cfg.range + 1e-12 ||
+            std::abs(kit[a].z - drumXYZ[a].z) > cfg.range + 1e-12) return false;
+        for (int b = a + 1; b < NUM_INST; ++b)
+            if (dist(kit[a], kit[b]) < cfg.sep) return false;
+    }
+    return true;
+}
+
+// 움직일 수 있는 악기 하나를 정규분포로 옮김 (범위 밖/너무 가까우면 다시 뽑음)
+Kit perturb(const Kit& cur, double sigma, const std::vector<int>& movable, const OptConfig& cfg, std::mt19937_64& rng) {
+    std::normal_distribution<double> nd(0.0, sigma);
+    std::uniform_int_distribution<size_t> pick(0, movable.size() - 1);
+    for (int tries = 0; tries < 50; ++tries) {
+        Kit k = cur;
+        Coord& c = k[movable[pick(rng)]];
+        int i = static_cast<int>(&c - k.data());
+        c.x = std::clamp(c.x + nd(rng), drumXYZ[i].x - cfg.range, drumXYZ[i].x + cfg.range);
+        c.y = std::clamp(c.y + nd(rng), drumXYZ[i].y - cfg.range, drumXYZ[i].y + cfg.range);
+        c.z = std::clamp(c.z + nd(rng), drumXYZ[i].z - cfg.range, drumXYZ[i].z + cfg.range);
+        if (feasible(k, cfg)) return k;
+    }
+    return cur;
+}
+
+double kitDistance(const Kit& a, const Kit& b) {
+    double m = 0.0;
+    for (int i = 1; i < NUM_INST; ++i) m = std::max(m, dist(a[i], b[i]));
+    return m;
+}
+
+int main(int argc, char** argv) {
+    std::ios::sync_with_stdio(false);
+    handLogEnabled = false;
+
+    OptConfig cfg;
+    std::vector<std::string> inputs;
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        if (std::strncmp(a, "--iters=", 8) == 0) cfg.iters = std::atoi(a + 8);
+        else if (std::strncmp(a, "--batch=", 8) == 0) cfg.batch = std::max(1, std::atoi(a + 8));
+        else if (std::strncmp(a, "--threads=", 10) == 0) cfg.threads = std::atoi(a + 10);
+        else if (std::strncmp(a, "--range=", 8) == 0) cfg.range = std::atof(a + 8);
+        else if (std::strncmp(a, "--sep=", 6) == 0) cfg.sep = std::atof(a + 6);
+        else if (std::strncmp(a, "--late=", 7) == 0) cfg.lateWeight = std::atof(a + 7);
+        else if (std::strncmp(a, "--seed=", 7) == 0) cfg.seed = std::strtoull(a + 7, nullptr, 10);
+        else if (std::strncmp(a, "--top=", 6) == 0) cfg.top = std::max(1, std::atoi(a + 6));
+        else if (std::strncmp(a, "--out=", 6) == 0) cfg.out = a + 6;
+        else if (std::strncmp(a, "--fix=", 6) == 0) {
+            std::fill(cfg.fixed + 1, cfg.fixed + NUM_INST, false);
+            for (const char* s = a + 6; *s;) {
+                char* end;
+                long v = std::strtol(s, &end, 10);
+                if (end == s) break;
+                if (v > 0 && v < NUM_INST) cfg.fixed[v] = true;
+                s = *end == ',' ? end + 1 : end;
+            }
+        }
+        else inputs.push_back(a);
+    }
+    if (inputs.empty()) {
+        std::string in;
+        std::cout << "output3_mc2c.csv 파일 또는 디렉터리 경로: ";
+        std::cin >> in;
+        inputs.push_back(in);
+    }
+
+    // 입력 모으기
+    std::vector<std::string> files;
+    for (const auto& in : inputs) {
+        std::error_code ec;
+        if (std::filesystem::is_directory(in, ec)) {
+            for (const auto& ent : std::filesystem::recursive_directory_iterator(in, ec))
+                if (ent.is_regular_file() && ent.path().filename() == "output3_mc2c.csv") files.push_back(ent.path());
+        } else {
+            files.push_back(in);
+        }
+    }
+    std::sort(files.begin(), files.end());
+    std::vector<Song> songs;
+    for (const auto& f : files) {
+        Song s;
+        if (!loadSong(f, s)) return 1;
+        if (!s.events.empty()) songs.push_back(std::move(s));
+    }
+    if (songs.empty()) {
+        std::cerr << "평가할 곡이 없음 (output3_mc2c.csv)\n";
+        return 1;
+    }
+
+    std::vector<int> movable;
+    for (int i = 1; i < NUM_INST; ++i) if (!cfg.fixed[i]) movable.push_back(i);
+    Kit base(drumXYZ, drumXYZ + NUM_INST);
+    if (movable.empty() || !feasible(base, cfg)) {
+        std::cerr << (movable.empty() ? "움직일 악기가 없음\n" : "원래 배치가 --sep 조건을 만족하지 않음\n");
+        return 1;
+    }
+
+    // 원래 배치 평가 (1회 평가 시간도 잼)
+    std::vector<double> costs;
+    auto t0 = std::chrono::steady_clock::now();
+    evaluateBatch(songs, {base}, cfg, costs);
+    double evalUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+    const double baseCost = costs[0];
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << "[시작] 곡 " << songs.size() << "개, 원래 비용 " << baseCost << ", 키트 1개 평가 " << evalUs
+              << " us (곡당 " << evalUs / songs.size() << " us)\n";
+
+    // 담금질: 온도는 원래 비용 대비 1% → 0.01% 로 기하급수 감소, 이동 폭도 같이 줄임
+    std::mt19937_64 rng(cfg.seed);
+    std::uniform_real_distribution<double> uni(0.0, 1.0);
+    Kit cur = base;
+    double curCost = baseCost;
+    std::vector<std::pair<double, Kit>> top{{baseCost, base}};
+    const double T0 = baseCost * 1e-2, T1 = baseCost * 1e-4;
+    int accepted = 0;
+    t0 = std::chrono::steady_clock::now();
+    for (int it = 0; it < cfg.iters; ++it) {
+        double frac = cfg.iters > 1 ? static_cast<double>(it) / (cfg.iters - 1) : 1.0;
+        double T = T0 * std::pow(T1 / T0, frac);
+        double sigma = cfg.range * (0.3 * (1.0 - frac) + 0.03);
+
+        std::vector<Kit> cands(cfg.batch);
+        for (auto& k : cands) k = perturb(cur, sigma, movable, cfg, rng);
+        evaluateBatch(songs, cands, cfg, costs);
+        size_t b = std::min_element(costs.begin(), costs.end()) - costs.begin();
+
+        if (costs[b] <= curCost || uni(rng) < std::exp((curCost - costs[b]) / T)) {
+            cur = cands[b];
+            curCost = costs[b];
+            ++accepted;
+            // 상위 배치 목록 (1cm 이내로 같은 배치는 하나만)
+            auto same = std::find_if(top.begin(), top.end(), [&](const auto& p) { return kitDistance(p.second, cur) < 0.01; });
+            if (same != top.end()) {
+                if (curCost < same->first) *same = {curCost, cur};
+            } else {
+                top.push_back({curCost, cur});
+            }
+            std::sort(top.begin(), top.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+            if ((int)top.size() > cfg.top) top.resize(cfg.top);
+        }
+    }
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    std::cout << "[탐색] " << cfg.iters << "단계 × 후보 " << cfg.batch << "개, 채택 " << accepted << "회, " << sec << " s\n";
+
+    static const char* names[NUM_INST] = {"-", "스네어", "플로어탐", "미드탐", "하이탐", "하이햇", "라이드벨", "오른크래시", "왼크래시"};
+    for (size_t r = 0; r < top.size(); ++r) {
+        std::cout << "\n[배치 " << r + 1 << "] 비용 " << top[r].first << " (" << std::setprecision(1)
+                  << 100.0 * (baseCost - top[r].first) / baseCost << "% 감소)\n" << std::setprecision(4);
+        for (int i = 1; i < NUM_INST; ++i) {
+            const Coord& c = top[r].second[i];
+            double moved = dist(c, drumXYZ[i]);
+            std::cout << "  {" << std::setw(7) << c.x << ", " << std::setw(7) << c.y << ", " << std::setw(7) << c.z
+                      << "},  // " << i << " " << names[i];
+            if (moved >= 0.005) std::cout << "  (" << std::setprecision(1) << moved * 100.0 << "cm 이동)" << std::setprecision(4);
+            std::cout << "\n";
+        }
+    }
+
+    // 가장 좋은 배치의 곡별 개선
+    const Kit& best = top.front().second;
+    std::cout << "\n[곡별] 이동거리(m) 원래 → 최적, 늦은 타격 원래 → 최적\n";
+    std::vector<FullEvent> buf;
+    for (const auto& s : songs) {
+        SongScore a = evaluateSong(s, base, cfg.prof, buf);
+        SongScore b = evaluateSong(s, best, cfg.prof, buf);
+        double ca = songCost(a, cfg), cb = songCost(b, cfg);
+        std::cout << "  " << std::left << std::setw(24) << s.name << std::right << std::setprecision(2) << std::setw(8)
+                  << a.travel << " → " << std::setw(8) << b.travel << "   " << std::setw(4) << a.late << " → " << std::setw(4)
+                  << b.late << "   " << std::setprecision(1) << std::setw(6) << (ca > 0 ? 100.0 * (ca - cb) / ca : 0.0)
+                  << "%\n";
+    }
+    activeKit = drumXYZ;
+
+    std::ofstream out(cfg.out);
+    if (!out.is_open()) {
+        std::cerr << "출력 파일 생성 실패: " << cfg.out << "\n";
+        return 1;
+    }
+    out << std::fixed << std::setprecision(4) << "inst\tx\ty\tz\n";
+    for (int i = 1; i < NUM_INST; ++i) out << i << '\t' << best[i].x << '\t' << best[i].y << '\t' << best[i].z << '\n';
+    std::cout << "[완료] " << cfg.out << "\n";
+    return 0;
+}
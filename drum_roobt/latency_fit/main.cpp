@@ -0,0 +1,119 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <iomanip>
+#include <cstdlib>
+#include <cstring>
+
+#include "../common/text_reader.hpp"
+#include "../common/latency_table.hpp"
+
+// 타격 로그로 기구 지연 보정표 맞추기
+//  - 로그 한 줄: inst hand vel scheduled observed   (hand: R/L/F, vel: 그 노트의 MIDI 벨로시티 0~127, 시각은 초)
+//    세기 구간은 vel / 40 반올림 (0~3) → midi_final 이 Velfile.txt 의 마디 평균으로 찾는 구간과 같은 단위
+//    지연 = observed - scheduled
+//  - 칸(악기 × 손 × 세기 구간)마다 중앙값 → 튀는 측정값(센서 잡음, 놓친 타격)에 강함
+//  - 표본이 --min 개보다 적은 칸은 같은 악기/손의 모든 세기 구간 중앙값으로 채우고, 그것도 없으면 비워 둠
+//  - --base=기존표: 보정표를 적용한 상태에서 찍은 로그면 남은 오차를 기존 값에 더함
+//
+// 사용법: ./latency_fit [--min=3] [--base=latency_table.txt] [--out=latency_table.txt] 로그...
+
+struct FitConfig {
+    int minSamples = 3;
+    std::string base;
+    std::string out = "latency_table.txt";
+};
+
+float median(std::vector<float>& v) {
+    size_t mid = v.size() / 2;
+    std::nth_element(v.begin(), v.begin() + mid, v.end());
+    float m = v[mid];
+    if (v.size() % 2 == 0) {
+        float lower = *std::max_element(v.begin(), v.begin() + mid);
+        m = (m + lower) * 0.5f;
+    }
+    return m;
+}
+
+int main(int argc, char** argv) {
+    std::ios::sync_with_stdio(false);
+
+    FitConfig cfg;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        if (std::strncmp(a, "--min=", 6) == 0) cfg.minSamples = std::max(1, std::atoi(a + 6));
+        else if (std::strncmp(a, "--base=", 7) == 0) cfg.base = a + 7;
+        else if (std::strncmp(a, "--out=", 6) == 0) cfg.out = a + 6;
+        else files.push_back(a);
+    }
+    if (files.empty()) {
+        std::string file;
+        std::cout << "타격 로그 파일 경로: ";
+        std::cin >> file;
+        files.push_back(file);
+    }
+
+    // 칸별 표본 [inst][hand][bucket]
+    std::vector<float> samples[LAT_INST][LAT_HANDS][LAT_VEL_BUCKETS];
+    size_t used = 0, skipped = 0;
+    for (const auto& file : files) {
+        TextReader in(file);
+        if (!in.is_open()) {
+            std::cerr << "입력 파일 열기 실패: " << file << "\n";
+            return 1;
+        }
+        std::string_view line, f[5];
+        while (in.nextLine(line)) {
+            line = trimView(line);
+            if (line.empty() || line[0] == '#') continue;
+            int inst, vel, hand;
+            double sched, obs;
+            if (splitFields(line, f, 5) < 5 || (hand = latencyHandIndex(f[1])) < 0 || !toInt(f[0], inst) ||
+                !toInt(f[2], vel) || !toDouble(f[3], sched) || !toDouble(f[4], obs) || inst < 0 || inst >= LAT_INST) {
+                ++skipped;   // 헤더/형식 불량
+                continue;
+            }
+            samples[inst][hand][latencyBucket(vel)].push_back(static_cast<float>((obs - sched) * 1000.0));
+            ++used;
+        }
+    }
+
+    LatencyTable table;
+    if (!cfg.base.empty() && !table.load(cfg.base)) {
+        std::cerr << "기존 보정표 열기 실패: " << cfg.base << "\n";
+        return 1;
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "[표본] " << used << "개 사용, " << skipped << "줄 건너뜀\n";
+    std::cout << "inst hand vel    n   median_ms\n";
+    int filled = 0, fallback = 0;
+    for (int i = 0; i < LAT_INST; ++i) {
+        for (int h = 0; h < LAT_HANDS; ++h) {
+            // 같은 악기/손 전체 (표본이 적은 칸의 대체값)
+            std::vector<float> all;
+            for (int b = 0; b < LAT_VEL_BUCKETS; ++b) all.insert(all.end(), samples[i][h][b].begin(), samples[i][h][b].end());
+            if (all.empty()) continue;
+            float allMed = median(all);
+
+            for (int b = 0; b < LAT_VEL_BUCKETS; ++b) {
+                auto& v = samples[i][h][b];
+                bool own = static_cast<int>(v.size()) >= cfg.minSamples;
+                float m = own ? median(v) : allMed;
+                table.ms[i][h][b] += m;
+                (own ? filled : fallback)++;
+                std::cout << std::setw(4) << i << std::setw(5) << latencyHandName(h) << std::setw(4) << b
+                          << std::setw(5) << v.size() << std::setw(12) << m << (own ? "" : "  (대체)") << "\n";
+            }
+        }
+    }
+
+    if (!table.save(cfg.out)) {
+        std::cerr << "보정표 저장 실패: " << cfg.out << "\n";
+        return 1;
+    }
+    std::cout << "[완료] " << cfg.out << " (칸 " << filled << "개 직접, " << fallback << "개 대체)\n";
+    return 0;
+}
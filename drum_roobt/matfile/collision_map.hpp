@@ -0,0 +1,346 @@
+#pragma once
+
+// collisionMap 바이너리 캐시
+//  - mat.cpp 가 .mat 파일을 한 번만 matio 로 읽어서 이 형식으로 저장
+//  - 이후에는 matio 없이 mmap 으로 바로 열어서 조회
+//  - 캐시 헤더에 원본 .mat 의 크기와 수정 시각(ns)을 기록해 두고, 둘 중 하나라도 다르면 다시 만듦
+//    (초 단위 mtime 비교는 같은 초 안에 .mat 을 다시 쓰면 옛 캐시를 그대로 씀)
+//
+// 캐시 형식 (little-endian, 4바이트 정렬)
+//  [헤더 CacheHeader]  (원본 변수명 포함. 다른 변수의 캐시를 잘못 열면 open 에서 거부)
+//  kind == KIND_PAIRS : int32 key[count] (오름차순), int32 value[count]
+//  kind == KIND_DENSE : int32 value[count]  (dims[0] x dims[1] x ... , MATLAB 과 같은 column-major)
+//
+// 조회 함수는 찾았는지 여부를 값과 따로 돌려줌 (저장된 값이 -1 이어도 구분 가능)
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace cmap {
+
+const uint32_t MAGIC   = 0x50414D43; // "CMAP"
+const uint32_t VERSION = 3; // 2: 헤더에 변수명 추가, 3: 원본 크기/수정 시각 추가
+
+const uint32_t KIND_PAIRS = 0; // (N,2) 키-값 배열 → 정렬 후 이분 탐색 O(log n)
+const uint32_t KIND_DENSE = 1; // N차원 테이블 → 직접 인덱싱 O(1)
+
+const int MAX_RANK = 4;
+const size_t VAR_NAME_BYTES = 32; // 변수명 (0 으로 채움, 마지막 바이트는 항상 0)
+
+struct CacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t kind;
+    uint32_t rank;
+    uint32_t dims[MAX_RANK];
+    uint64_t count;
+    char var[VAR_NAME_BYTES];
+    uint64_t srcSize;     // 캐시를 만들 때 원본 .mat 크기
+    int64_t srcMtimeNs;   // 원본 .mat 수정 시각 (epoch ns)
+};
+
+// 원본 .mat 의 크기 + 수정 시각(ns). 캐시가 어느 원본에서 만들어졌는지 확인하는 데 씀
+struct SourceStamp {
+    uint64_t size = 0;
+    int64_t mtimeNs = 0;
+};
+
+inline bool sourceStamp(const std::string& path, SourceStamp& st) {
+    struct stat s;
+    if (stat(path.c_str(), &s) != 0) return false;
+    st.size = static_cast<uint64_t>(s.st_size);
+    st.mtimeNs = static_cast<int64_t>(s.st_mtim.tv_sec) * 1000000000 + s.st_mtim.tv_nsec;
+    return true;
+}
+
+// 캐시 파일 경로: 같은 .mat 안의 변수마다 따로 만듦
+//   예) collisionMap.mat + collisionMapInst → collisionMap.mat.collisionMapInst.cmap
+inline std::string cachePathFor(const std::string& matPath, const std::string& varname) {
+    return matPath + "." + varname + ".cmap";
+}
+
+inline void setVarName(CacheHeader& h, const std::string& varname) {
+    std::memset(h.var, 0, sizeof(h.var));
+    std::memcpy(h.var, varname.data(), std::min(varname.size(), VAR_NAME_BYTES - 1));
+}
+
+inline bool varNameMatches(const CacheHeader& h, const std::string& varname) {
+    return varname.size() < VAR_NAME_BYTES && strnlen(h.var, VAR_NAME_BYTES) == varname.size() &&
+           std::memcmp(h.var, varname.data(), varname.size()) == 0;
+}
+
+// (N,2) 키-값 쌍을 키 기준으로 정렬해서 캐시로 저장
+// 같은 키가 여러 번 나오면 선형 탐색과 같은 결과가 나오도록 처음 나온 값만 남김
+inline bool writePairsCache(const std::string& path, const std::string& varname, const SourceStamp& src,
+                            std::vector<std::pair<int, int>> pairs) {
+    std::stable_sort(pairs.begin(), pairs.end(),
+                     [](const std::pair<int, int>& a, const std::pair<int, int>& b) { return a.first < b.first; });
+    pairs.erase(std::unique(pairs.begin(), pairs.end(),
+                            [](const std::pair<int, int>& a, const std::pair<int, int>& b) { return a.first == b.first; }),
+                pairs.end());
+
+    CacheHeader h{};
+    h.magic = MAGIC;
+    h.version = VERSION;
+    h.kind = KIND_PAIRS;
+    h.rank = 2;
+    h.dims[0] = static_cast<uint32_t>(pairs.size());
+    h.dims[1] = 2;
+    h.count = pairs.size();
+    setVarName(h, varname);
+    h.srcSize = src.size;
+    h.srcMtimeNs = src.mtimeNs;
+
+    std::vector<int32_t> buf(2 * pairs.size());
+    for (size_t i = 0; i < pairs.size(); ++i) {
+        buf[i] = pairs[i].first;
+        buf[pairs.size() + i] = pairs[i].second;
+    }
+
+    std::string tmp = path + ".tmp";
+    FILE* fp = std::fopen(tmp.c_str(), "wb");
+    if (!fp) {
+        std::cerr << "캐시 파일 생성 실패: " << tmp << "\n";
+        return false;
+    }
+    bool ok = std::fwrite(&h, sizeof(h), 1, fp) == 1 &&
+              std::fwrite(buf.data(), sizeof(int32_t), buf.size(), fp) == buf.size();
+    ok = (std::fclose(fp) == 0) && ok;
+    // 다 쓴 뒤에 rename 해서 중간에 죽어도 깨진 캐시가 남지 않도록 함
+    if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+        std::cerr << "캐시 파일 저장 실패: " << path << "\n";
+        std::remove(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+// N차원 테이블(예: 8x8x8x8 collisionMapInst)을 그대로 캐시로 저장
+inline bool writeDenseCache(const std::string& path, const std::string& varname, const SourceStamp& src,
+                            const std::vector<uint32_t>& dims, const std::vector<int32_t>& values) {
+    if (dims.empty() || dims.size() > MAX_RANK) {
+        std::cerr << "지원하지 않는 차원 수: " << dims.size() << "\n";
+        return false;
+    }
+    CacheHeader h{};
+    h.magic = MAGIC;
+    h.version = VERSION;
+    h.kind = KIND_DENSE;
+    h.rank = static_cast<uint32_t>(dims.size());
+    uint64_t count = 1;
+    for (size_t i = 0; i < dims.size(); ++i) {
+        h.dims[i] = dims[i];
+        count *= dims[i];
+    }
+    if (count != values.size()) {
+        std::cerr << "차원과 데이터 개수가 맞지 않습니다.\n";
+        return false;
+    }
+    h.count = count;
+    setVarName(h, varname);
+    h.srcSize = src.size;
+    h.srcMtimeNs = src.mtimeNs;
+
+    std::string tmp = path + ".tmp";
+    FILE* fp = std::fopen(tmp.c_str(), "wb");
+    if (!fp) {
+        std::cerr << "캐시 파일 생성 실패: " << tmp << "\n";
+        return false;
+    }
+    bool ok = std::fwrite(&h, sizeof(h), 1, fp) == 1 &&
+              std::fwrite(values.data(), sizeof(int32_t), values.size(), fp) == values.size();
+    ok = (std::fclose(fp) == 0) && ok;
+    if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+        std::cerr << "캐시 파일 저장 실패: " << path << "\n";
+        std::remove(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+// 캐시가 없거나, 형식이 옛 버전이거나, 헤더의 원본 크기/수정 시각이 지금 .mat 과 다르면 다시 만들어야 함
+inline bool cacheIsStale(const std::string& matPath, const std::string& cachePath) {
+    CacheHeader h{};
+    int fd = ::open(cachePath.c_str(), O_RDONLY);
+    if (fd < 0) return true;
+    bool readOk = ::read(fd, &h, sizeof(h)) == static_cast<ssize_t>(sizeof(h));
+    ::close(fd);
+    if (!readOk || h.magic != MAGIC || h.version != VERSION) return true;
+    SourceStamp src;
+    if (!sourceStamp(matPath, src)) return false; // 원본이 없으면 있는 캐시를 그대로 사용
+    return h.srcSize != src.size || h.srcMtimeNs != src.mtimeNs;
+}
+
+class CollisionMap {
+public:
+    CollisionMap() = default;
+    ~CollisionMap() { close(); }
+    CollisionMap(const CollisionMap&) = delete;
+    CollisionMap& operator=(const CollisionMap&) = delete;
+
+    // varname 을 주면 헤더의 변수명과 같은지도 확인
+    bool open(const std::string& cachePath, const std::string& varname = "") {
+        close();
+        int fd = ::open(cachePath.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cerr << "캐시 파일을 열 수 없습니다: " << cachePath << "\n";
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(CacheHeader)) {
+            std::cerr << "캐시 파일 크기가 잘못되었습니다: " << cachePath << "\n";
+            ::close(fd);
+            return false;
+        }
+        void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) {
+            std::cerr << "mmap 실패: " << cachePath << "\n";
+            return false;
+        }
+        base_ = p;
+        size_ = static_cast<size_t>(st.st_size);
+
+        const CacheHeader* h = static_cast<const CacheHeader*>(base_);
+        bool shapeOk = h->magic == MAGIC && h->version == VERSION && h->rank != 0 && h->rank <= MAX_RANK &&
+                       (h->kind == KIND_PAIRS || h->kind == KIND_DENSE) && h->var[VAR_NAME_BYTES - 1] == 0;
+        if (shapeOk && h->kind == KIND_PAIRS) {
+            // 키-값 캐시는 (count, 2)
+            shapeOk = h->rank == 2 && h->dims[0] == h->count && h->dims[1] == 2;
+        } else if (shapeOk) {
+            // N차원 캐시는 원소 개수 == 차원 곱
+            uint64_t prod = 1;
+            for (uint32_t i = 0; i < h->rank; ++i) prod *= h->dims[i];
+            shapeOk = prod == h->count;
+        }
+        // 크기 계산 전에 count 상한을 확인 (곱셈 넘침 방지)
+        if (shapeOk) {
+            uint64_t per = sizeof(int32_t) * (h->kind == KIND_PAIRS ? 2 : 1);
+            shapeOk = h->count <= (size_ - sizeof(CacheHeader)) / per && sizeof(CacheHeader) + h->count * per == size_;
+        }
+        if (!shapeOk) {
+            std::cerr << "캐시 형식이 맞지 않습니다: " << cachePath << "\n";
+            close();
+            return false;
+        }
+        if (!varname.empty() && !varNameMatches(*h, varname)) {
+            std::cerr << "캐시 변수명이 다릅니다: " << cachePath << " (" << std::string(h->var, strnlen(h->var, VAR_NAME_BYTES))
+                      << " != " << varname << ")\n";
+            close();
+            return false;
+        }
+        header_ = *h;
+        const int32_t* payload = reinterpret_cast<const int32_t*>(static_cast<const char*>(base_) + sizeof(CacheHeader));
+        if (header_.kind == KIND_PAIRS) {
+            keys_ = payload;
+            values_ = payload + header_.count;
+        } else {
+            keys_ = nullptr;
+            values_ = payload;
+            uint64_t stride = 1;
+            for (uint32_t i = 0; i < header_.rank; ++i) {
+                strides_[i] = stride;
+                stride *= header_.dims[i];
+            }
+        }
+        return true;
+    }
+
+    void close() {
+        if (base_) munmap(base_, size_);
+        base_ = nullptr;
+        size_ = 0;
+        keys_ = values_ = nullptr;
+        header_ = CacheHeader{};
+    }
+
+    bool isOpen() const { return base_ != nullptr; }
+    bool isDense() const { return header_.kind == KIND_DENSE; }
+    size_t size() const { return static_cast<size_t>(header_.count); }
+    uint32_t rank() const { return header_.rank; }
+    uint32_t dim(int i) const { return header_.dims[i]; }
+
+    // key → value
+    //  - 키-값 캐시: 정렬된 키에서 이분 탐색
+    //  - N차원 캐시: key 를 선형(column-major) 인덱스로 보고 직접 조회
+    bool find(int key, int& value) const {
+        if (!base_) return false;
+        if (header_.kind == KIND_DENSE) {
+            if (key < 0 || (uint64_t)key >= header_.count) return false;
+            value = values_[key];
+            return true;
+        }
+        const int32_t* end = keys_ + header_.count;
+        const int32_t* it = std::lower_bound(keys_, end, key);
+        if (it == end || *it != key) return false;
+        value = values_[it - keys_];
+        return true;
+    }
+
+    // [lo, hi] 범위에 들어가는 키의 인덱스 구간 [first, last) (키-값 캐시 전용)
+    std::pair<size_t, size_t> range(int lo, int hi) const {
+        if (!base_ || header_.kind != KIND_PAIRS || lo > hi) return {0, 0};
+        const int32_t* end = keys_ + header_.count;
+        const int32_t* b = std::lower_bound(keys_, end, lo);
+        const int32_t* e = std::upper_bound(b, end, hi);
+        return {static_cast<size_t>(b - keys_), static_cast<size_t>(e - keys_)};
+    }
+    int keyAt(size_t i) const { return keys_ ? keys_[i] : static_cast<int>(i); }
+    int valueAt(size_t i) const { return values_[i]; }
+
+    // N차원 테이블 조회 (0-based 첨자). 범위를 벗어나면 false
+    bool at(const int* sub, int& value) const {
+        if (!base_ || header_.kind != KIND_DENSE) return false;
+        uint64_t idx = 0;
+        for (uint32_t i = 0; i < header_.rank; ++i) {
+            if (sub[i] < 0 || (uint32_t)sub[i] >= header_.dims[i]) return false;
+            idx += sub[i] * strides_[i];
+        }
+        value = values_[idx];
+        return true;
+    }
+
+    // 여러 키를 한 번에 조회. found[i] 에 찾았는지(1/0) 기록 (없는 키의 out[i] 는 0). 찾은 개수를 반환
+    size_t lookupBatch(const int* keys, size_t n, int* out, uint8_t* found) const {
+        size_t count = 0;
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = 0;
+            found[i] = find(keys[i], out[i]) ? 1 : 0;
+            count += found[i];
+        }
+        return count;
+    }
+
+    // 곡 전체의 자세 조합을 한 번에 조회 (N차원 캐시 전용)
+    // subs 는 rank 개씩 붙어있는 0-based 첨자 배열 (예: 4차원이면 [a0 b0 c0 d0 a1 b1 c1 d1 ...])
+    // found[i] 는 첨자가 범위 안이었는지(1/0). 범위 안이고 값이 0 이 아닌(= 충돌) 조합 개수를 반환
+    size_t lookupBatchSub(const int* subs, size_t n, int* out, uint8_t* found) const {
+        size_t hits = 0;
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = 0;
+            found[i] = at(subs + i * header_.rank, out[i]) ? 1 : 0;
+            if (found[i] && out[i] != 0) ++hits;
+        }
+        return hits;
+    }
+
+private:
+    void* base_ = nullptr;
+    size_t size_ = 0;
+    CacheHeader header_{};
+    const int32_t* keys_ = nullptr;
+    const int32_t* values_ = nullptr;
+    uint64_t strides_[MAX_RANK] = {0, 0, 0, 0};
+};
+
+} // namespace cmap
@@ -1,31 +1,34 @@
 #include <iostream>   // 표준 입출력 라이브러리
 #include <matio.h>    // Matio 라이브러리 (MATLAB 파일을 읽기 위한 라이브러리)
 #include <vector>     // std::vector 사용
+#include <string>
 
-int main() {
-    const char *filename = "matFileTest.mat";
+#include "collision_map.hpp" // 변환된 바이너리 캐시 (mmap 조회)
+
+// .mat 파일을 matio 로 읽어서 바이너리 캐시로 변환
+//  - (N,2) 배열 : 첫 번째 열 = key, 두 번째 열 = value → 정렬된 키-값 캐시
+//  - 그 외 N차원 배열 (예: collisionMapInst 8x8x8x8) → 직접 인덱싱 캐시
+bool buildCache(const std::string& filename, const std::string& varname, const std::string& cachePath) {
+    // 읽기 전에 원본 크기/수정 시각을 잡아 둠 (읽는 도중 .mat 이 바뀌면 다음 실행에서 다시 만들어짐)
+    cmap::SourceStamp src;
+    if (!cmap::sourceStamp(filename, src)) {
+        std::cerr << "파일을 열 수 없습니다: " << filename << "\n";
+        return false;
+    }
 
     // .mat 파일 열기
-    mat_t *matfp = Mat_Open(filename, MAT_ACC_RDONLY);
+    mat_t *matfp = Mat_Open(filename.c_str(), MAT_ACC_RDONLY);
     if (!matfp) {
         std::cerr << "파일을 열 수 없습니다: " << filename << "\n";
-        return 1;
+        return false;
     }
 
-    // "data" 변수 읽기
-    matvar_t *matvar = Mat_VarRead(matfp, "matFileTest");  // 실제 변수명을 확인해서 변경하세요.
+    // 변수 읽기
+    matvar_t *matvar = Mat_VarRead(matfp, varname.c_str());
     if (!matvar) {
-        std::cerr << "변수를 찾을 수 없습니다: data\n";
-        Mat_Close(matfp);
-        return 1;
-    }
-
-    // 데이터 차원 확인 (2차원 배열인지 확인)
-    if (matvar->rank != 2 || matvar->dims[1] != 2) {
-        std::cerr << "데이터 형식이 (N,2) 형태의 배열이 아닙니다.\n";
-        Mat_VarFree(matvar);
+        std::cerr << "변수를 찾을 수 없습니다: " << varname << "\n";
         Mat_Close(matfp);
-        return 1;
+        return false;
     }
 
     // 데이터 타입 확인
@@ -33,45 +36,99 @@ int main() {
         std::cerr << "지원되지 않는 데이터 타입입니다. (double 배열 필요)\n";
         Mat_VarFree(matvar);
         Mat_Close(matfp);
-        return 1;
+        return false;
     }
 
     // 데이터 포인터 가져오기
     double *data = static_cast<double *>(matvar->data);
-    size_t rows = matvar->dims[0]; // 행 개수
+    bool ok;
+
+    if (matvar->rank == 2 && matvar->dims[1] == 2) {
+        size_t rows = matvar->dims[0]; // 행 개수
 
-    // 데이터를 (키, 값) 형태로 저장할 벡터
-    std::vector<std::pair<int, int>> key_value_pairs;
+        // 데이터를 (키, 값) 형태로 저장할 벡터
+        std::vector<std::pair<int, int>> key_value_pairs;
+        key_value_pairs.reserve(rows);
+        for (size_t i = 0; i < rows; i++) {
+            int key = static_cast<int>(data[i]);              // 첫 번째 열 (key)
+            int value = static_cast<int>(data[i + rows]);     // 두 번째 열 (value)
+            key_value_pairs.push_back({key, value});
+        }
+        ok = cmap::writePairsCache(cachePath, varname, src, std::move(key_value_pairs));
+    } else if (matvar->rank >= 1 && matvar->rank <= cmap::MAX_RANK) {
+        std::vector<uint32_t> dims;
+        size_t count = 1;
+        for (int i = 0; i < matvar->rank; i++) {
+            dims.push_back(static_cast<uint32_t>(matvar->dims[i]));
+            count *= matvar->dims[i];
+        }
+        std::vector<int32_t> values(count);
+        for (size_t i = 0; i < count; i++) values[i] = static_cast<int32_t>(data[i]);
+        ok = cmap::writeDenseCache(cachePath, varname, src, dims, values);
+    } else {
+        std::cerr << "데이터 형식이 (N,2) 배열이나 4차원 이하 배열이 아닙니다.\n";
+        ok = false;
+    }
+
+    // 메모리 해제
+    Mat_VarFree(matvar);
+    Mat_Close(matfp);
+    return ok;
+}
+
+// 사용법: ./mat [mat 파일] [변수명]
+//   예) ./mat collisionMap.mat collisionMapInst
+int main(int argc, char **argv) {
+    std::string filename = (argc > 1) ? argv[1] : "matFileTest.mat";
+    std::string varname  = (argc > 2) ? argv[2] : "matFileTest";  // 실제 변수명을 확인해서 변경하세요.
+    if (varname.empty() || varname.size() >= cmap::VAR_NAME_BYTES) {
+        std::cerr << "변수명 길이가 잘못되었습니다 (1~" << cmap::VAR_NAME_BYTES - 1 << "자): " << varname << "\n";
+        return 1;
+    }
+    std::string cachePath = cmap::cachePathFor(filename, varname); // 변수마다 캐시 따로
+
+    // 캐시가 없거나 .mat 이 더 새로우면 한 번만 matio 로 변환
+    if (cmap::cacheIsStale(filename, cachePath)) {
+        std::cout << "캐시 생성: " << filename << " → " << cachePath << "\n";
+        if (!buildCache(filename, varname, cachePath)) return 1;
+    }
+
+    // 이후로는 matio 없이 mmap 으로 조회
+    cmap::CollisionMap map;
+    if (!map.open(cachePath, varname)) return 1;
+
+    if (map.isDense()) {
+        std::cout << "N차원 테이블 (";
+        for (uint32_t i = 0; i < map.rank(); i++) std::cout << (i ? "x" : "") << map.dim(i);
+        std::cout << ")\n";
+
+        // 사용자 입력을 받아 값 찾기 (0-based 첨자, 직접 인덱싱)
+        int sub[cmap::MAX_RANK] = {0, 0, 0, 0};
+        std::cout << map.rank() << "개의 첨자를 입력하세요 (0부터): ";
+        for (uint32_t i = 0; i < map.rank(); i++) std::cin >> sub[i];
+
+        int value;
+        if (!map.at(sub, value)) std::cout << "범위를 벗어난 첨자입니다.\n";
+        else std::cout << "대응 값: " << value << '\n';
+        return 0;
+    }
 
     std::cout << "파일 내용:\n";
-    for (size_t i = 0; i < rows; i++) {
-        int key = static_cast<int>(data[i]);              // 첫 번째 열 (key)
-        int value = static_cast<int>(data[i + rows]);     // 두 번째 열 (value)
-        key_value_pairs.push_back({key, value});
-        std::cout << key << " " << value << '\n';
+    for (size_t i = 0; i < map.size(); i++) {
+        std::cout << map.keyAt(i) << " " << map.valueAt(i) << '\n';
     }
 
-    // 사용자 입력을 받아 값 찾기 (선형 탐색 방식)
+    // 사용자 입력을 받아 값 찾기 (이분 탐색)
     int input;
     std::cout << "숫자를 입력하세요: ";
     std::cin >> input;
 
-    bool found = false;
-    for (const auto &pair : key_value_pairs) {
-        if (pair.first == input) {
-            std::cout << "대응 값: " << pair.second << '\n';
-            found = true;
-            break;
-        }
-    }
-
-    if (!found) {
+    int value;
+    if (map.find(input, value)) {
+        std::cout << "대응 값: " << value << '\n';
+    } else {
         std::cout << "해당 숫자에 대한 값이 없습니다.\n";
     }
 
-    // 메모리 해제
-    Mat_VarFree(matvar);
-    Mat_Close(matfp);
-
     return 0;
 }
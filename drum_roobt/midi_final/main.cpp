@@ -4,6 +4,9 @@
 #include <vector>
 #include <string>
 #include <sstream>
+#include <cstdint>
+
+#include "../common/midi_merge.hpp"
 
 struct Event {
     double time;
@@ -20,17 +23,6 @@ std::vector<std::string> splitByWhitespace(const std::string& line) {
     return tokens;
 }
 
-size_t readTime(const std::vector<unsigned char>& data, size_t& pos) {
-    size_t value = 0;
-    while (pos < data.size()) {
-        unsigned char byte = data[pos];
-        value = (value << 7) | (byte & 0x7F);
-        pos++;
-        if ((byte & 0x80) == 0) break;
-    }
-    return value;
-}
-
 bool readMidiFile(const std::string& filename, std::vector<unsigned char>& buffer) {
     std::ifstream file(filename, std::ios::binary | std::ios::ate);
     if (!file) {
@@ -69,11 +61,6 @@ void handleMetaEvent(const std::vector<unsigned char>& data, size_t& pos, int &i
     pos = startPos + length;
 }
 
-void handleChannel10(const std::vector<unsigned char>& data, size_t& pos, unsigned char eventType) {
-    unsigned char control = data[pos++];
-    if (eventType == 0xB9) pos++;
-}
-
 void save_to_csv(const std::string& outputCsvPath, double &note_on_time, int drumNote) {
     std::ofstream file(outputCsvPath, std::ios::app);
     if (!file) {
@@ -124,26 +111,6 @@ void handleNoteOn(const std::vector<unsigned char>& data, size_t& pos, double &n
     }
 }
 
-void analyzeMidiEvent(const std::vector<unsigned char>& data, size_t& pos, unsigned char& runningStatus, int &initial_setting_flag, double &note_on_time, int &tpqn, const std::string& midiFilePath) {
-    if (pos >= data.size()) return;
-    unsigned char eventType = data[pos];
-    if (eventType == 0xFF || eventType == 0xB9 || eventType == 0xC9 || eventType == 0x99) {
-        runningStatus = eventType;
-        pos++;
-    } else {
-        eventType = runningStatus;
-    }
-    if (eventType == 0xFF) {
-        handleMetaEvent(data, pos, initial_setting_flag);
-    } else if (eventType == 0xB9 || eventType == 0xC9) {
-        handleChannel10(data, pos, eventType);
-    } else if (eventType == 0x99) {
-        handleNoteOn(data, pos, note_on_time, tpqn, midiFilePath);
-    } else {
-        pos++;
-    }
-}
-
 void convertMcToC(const std::string& inputFilename, const std::string& outputFilename) {
     std::ifstream input(inputFilename);
     if (!input.is_open()) {
@@ -414,7 +381,6 @@ void convertToMeasureFile(const std::string& inputFilename, const std::string& o
 int main() {
     std::string midiNameOnly;
     size_t pos;
-    unsigned char runningStatus;
     int initial_setting_flag = 0;
     double note_on_time = 0;
 
@@ -429,31 +395,23 @@ int main() {
     std::vector<unsigned char> midiData;
     if (!readMidiFile(inputPath, midiData)) return 1;
 
-    pos = 14;
-    int tpqn = (midiData[12] << 8) | midiData[13];
+    // 트랙들을 절대 tick 순서로 합쳐서 읽음 (format 1 에서 드럼이 여러 트랙에 나뉘어 있어도 순서 유지)
+    MidiTrackMerger merger(midiData);
+    int tpqn = merger.tpqn();
     std::cout << "Time Division (TPQN): " << tpqn << " ticks per quarter note\n";
-
-    while (pos + 8 <= midiData.size()) {
-        if (!(midiData[pos] == 'M' && midiData[pos+1] == 'T' && midiData[pos+2] == 'r' && midiData[pos+3] == 'k')) {
-            std::cerr << "MTrk expected at pos " << pos << "\n";
-            break;
-        }
-        size_t trackLength = (midiData[pos+4] << 24) |
-                             (midiData[pos+5] << 16) |
-                             (midiData[pos+6] << 8) |
-                             midiData[pos+7];
-        pos += 8;
-        size_t trackEnd = pos + trackLength;
-
-        std::cout << "🎵 Reading MTrk (length=" << trackLength << ") from pos " << pos << " to " << trackEnd << "\n";
-
-        note_on_time = 0;
-        while (pos < trackEnd) {
-            size_t delta = readTime(midiData, pos);
-            note_on_time += delta;
-            analyzeMidiEvent(midiData, pos, runningStatus, initial_setting_flag, note_on_time, tpqn, outputPath);
+    std::cout << "🎵 Merging " << merger.trackCount() << " MTrk by absolute tick\n";
+
+    uint64_t prevTick = 0;
+    MidiEvent ev;
+    while (merger.next(ev)) {
+        note_on_time += static_cast<double>(ev.tick - prevTick);
+        prevTick = ev.tick;
+        pos = ev.pos;
+        if (ev.status == 0xFF) {
+            handleMetaEvent(midiData, pos, initial_setting_flag);
+        } else if (ev.status == 0x99) {
+            handleNoteOn(midiData, pos, note_on_time, tpqn, outputPath);
         }
-        pos = trackEnd;
     }
 
     std::cout << "-------------------- midi to mc done --------------------" << std::endl;
@@ -0,0 +1,264 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include "../common/smf_writer.hpp"
+#include "../common/midi_merge.hpp"
+
+// 벤치마크용 합성 드럼 MIDI 만들기
+//  - 마디 단위로 기본 그루브(킥/스네어/하이햇·라이드) + 가끔 필인(탐/스네어 16분) + 마디 첫 박 크래시
+//  - 노트는 save_to_csv 매핑에 있는 GM 드럼 노트만 사용 (36 38 41 42 45 46 47 48 49 50 51 57)
+//  - 템포/박자 변경(마디 경계), 트랙 배치(single: format 0 한 트랙 / drum: format 1 드럼 트랙 하나 /
+//    split: format 1 킥·스네어·하이햇·탐·심벌 트랙 따로), 같은 tick 최대 동시 노트 수(--poly) 조절
+//  - 파일 i 의 난수 시드 = splitmix64(seed + i) → 스레드 수와 관계없이 같은 파일이 나옴
+//  - --verify: 만든 파일을 MidiTrackMerger 로 다시 읽어 노트 수 확인 (다르면 종료 코드 2)
+//
+// 사용법: ./midi_gen [--count=4] [--notes=10000] [--bpm=120] [--bpm-min=70] [--bpm-max=180] [--tempo-changes=0]
+//                    [--meter-changes=0] [--layout=drum] [--fill=0.1] [--poly=3] [--tpqn=480] [--seed=1]
+//                    [--threads=N] [--out=gen] [--prefix=gen] [--verify]
+
+struct GenConfig {
+    int count = 4;
+    long notes = 10000;           // 파일당 목표 노트 수 (이 수를 넘기는 마디에서 멈춤)
+    double bpm = 120.0;
+    double bpmMin = 70.0, bpmMax = 180.0;
+    int tempoChanges = 0;
+    int meterChanges = 0;
+    std::string layout = "drum";  // single / drum / split
+    double fill = 0.1;            // 마디가 필인일 확률
+    int poly = 3;                 // 같은 tick 최대 노트 수 (1~4)
+    int tpqn = 480;
+    uint64_t seed = 1;
+    unsigned threads = 0;
+    std::string out = "gen";
+    std::string prefix = "gen";
+    bool verify = false;
+};
+
+enum GenPart { PART_KICK, PART_SNARE, PART_HATS, PART_TOMS, PART_CYMBALS, PART_COUNT };
+
+struct GenFileResult {
+    std::string path;
+    long notes = 0;
+    long bars = 0;
+    size_t bytes = 0;
+    double ms = 0.0;
+    bool ok = true;
+};
+
+const int GM_CHANNEL = 9;
+
+uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+GenFileResult generateFile(int index, const GenConfig& cfg) {
+    auto t0 = std::chrono::steady_clock::now();
+    GenFileResult res;
+    std::mt19937_64 rng(splitmix64(cfg.seed + static_cast<uint64_t>(index)));
+    std::uniform_real_distribution<double> uni(0.0, 1.0);
+    auto chance = [&](double p) { return uni(rng) < p; };
+    auto pick = [&](std::initializer_list<int> v) { return *(v.begin() + static_cast<size_t>(uni(rng) * v.size())); };
+
+    SmfWriter smf(cfg.tpqn, cfg.layout == "single" ? 0 : 1);
+    int track[PART_COUNT];
+    if (cfg.layout == "split") {
+        static const char* names[PART_COUNT] = {"Kick", "Snare", "Hats", "Toms", "Cymbals"};
+        for (int p = 0; p < PART_COUNT; ++p) track[p] = smf.addTrack(names[p]);
+    } else {
+        int t = smf.addTrack("Drums");
+        std::fill(track, track + PART_COUNT, t);
+    }
+
+    // 대략 마디 수를 먼저 잡고 그 안에서 템포/박자 변경 마디를 고름
+    const long estBars = std::max(1L, cfg.notes / 14);
+    std::vector<long> tempoBars, meterBars;
+    for (int i = 0; i < cfg.tempoChanges; ++i) tempoBars.push_back(1 + static_cast<long>(uni(rng) * estBars));
+    for (int i = 0; i < cfg.meterChanges; ++i) meterBars.push_back(1 + static_cast<long>(uni(rng) * estBars));
+    std::sort(tempoBars.begin(), tempoBars.end());
+    std::sort(meterBars.begin(), meterBars.end());
+
+    static const int meters[][2] = {{4, 4}, {3, 4}, {6, 8}, {7, 8}, {5, 4}};
+    int num = 4, den = 4;
+    smf.setTempo(0, cfg.bpm);
+    smf.setTimeSignature(0, num, den);
+
+    // 한 tick 에 쌓인 노트 (poly 제한용)
+    struct Hit { int part, note, vel; };
+    std::vector<Hit> slot;
+    auto flush = [&](uint64_t tick, uint32_t dur) {
+        // 넘치면 무작위로 남김 (킥/스네어가 항상 살아남지 않도록 섞음)
+        if ((int)slot.size() > cfg.poly) {
+            std::shuffle(slot.begin(), slot.end(), rng);
+            slot.resize(cfg.poly);
+        }
+        for (const Hit& h : slot) smf.addNote(track[h.part], tick, GM_CHANNEL, h.note, h.vel, dur);
+        res.notes += static_cast<long>(slot.size());
+        slot.clear();
+    };
+
+    uint64_t tick = 0;
+    size_t ti = 0, mi = 0;
+    bool ride = false;
+    while (res.notes < cfg.notes) {
+        long bar = res.bars;
+        if (ti < tempoBars.size() && tempoBars[ti] <= bar) {
+            while (ti < tempoBars.size() && tempoBars[ti] <= bar) ++ti;
+            smf.setTempo(tick, cfg.bpmMin + uni(rng) * (cfg.bpmMax - cfg.bpmMin));
+        }
+        if (mi < meterBars.size() && meterBars[mi] <= bar) {
+            while (mi < meterBars.size() && meterBars[mi] <= bar) ++mi;
+            const int* m = meters[static_cast<size_t>(uni(rng) * 5)];
+            num = m[0];
+            den = m[1];
+            smf.setTimeSignature(tick, num, den);
+            ride = chance(0.3);
+        }
+
+        const uint32_t beatTicks = static_cast<uint32_t>(cfg.tpqn * 4 / den);
+        const uint32_t stepTicks = std::max<uint32_t>(1, beatTicks / (den == 8 ? 2 : 4));   // 16분 (8분 박자는 한 박이 8분이라 둘로 나눔)
+        const int steps = num * (den == 8 ? 2 : 4);
+        const int perBeat = den == 8 ? 2 : 4;
+        const bool fillBar = chance(cfg.fill);
+
+        for (int s = 0; s < steps; ++s) {
+            int beat = s / perBeat, sub = s % perBeat;
+            bool onBeat = sub == 0;
+            int accent = onBeat ? 20 : 0;
+            auto vel = [&](int base) { return std::clamp(base + accent + static_cast<int>(uni(rng) * 30) - 15, 1, 127); };
+
+            if (s == 0 && (bar == 0 || chance(0.25)))
+                slot.push_back({PART_CYMBALS, pick({49, 57}), vel(110)});
+
+            if (fillBar && s >= steps / 2) {
+                // 필인: 뒤쪽 절반을 탐/스네어 16분으로
+                if (chance(0.85)) slot.push_back({PART_TOMS, pick({38, 41, 45, 47, 48, 50}), vel(90)});
+                if (onBeat && chance(0.5)) slot.push_back({PART_KICK, 36, vel(95)});
+                flush(tick + static_cast<uint64_t>(s) * stepTicks, stepTicks / 2);
+                continue;
+            }
+
+            // 킥: 첫 박 + 무작위, 스네어: 짝수 박(백비트) + 가끔 고스트
+            if ((onBeat && (beat % 2 == 0)) || chance(0.08)) slot.push_back({PART_KICK, 36, vel(100)});
+            if ((onBeat && beat % 2 == 1) || chance(0.05)) slot.push_back({PART_SNARE, 38, vel(onBeat ? 105 : 50)});
+            // 8분마다 하이햇(가끔 열림) 또는 라이드
+            if (sub % 2 == 0) {
+                int n = ride ? 51 : (chance(0.1) ? 46 : 42);
+                slot.push_back({PART_HATS, n, vel(80)});
+            }
+            flush(tick + static_cast<uint64_t>(s) * stepTicks, stepTicks / 2);
+        }
+        tick += static_cast<uint64_t>(steps) * stepTicks;
+        ++res.bars;
+    }
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "%s_%04d.mid", cfg.prefix.c_str(), index);
+    res.path = (std::filesystem::path(cfg.out) / name).string();
+    if (!smf.writeFile(res.path)) {
+        std::cerr << "출력 파일 생성 실패: " << res.path << "\n";
+        res.ok = false;
+        return res;
+    }
+    res.bytes = smf.buffer().size();
+
+    if (cfg.verify) {
+        MidiTrackMerger merger(smf.buffer());
+        MidiEvent ev;
+        long on = 0;
+        const auto& buf = smf.buffer();
+        while (merger.next(ev))
+            if ((ev.status & 0xF0) == 0x90 && ev.pos + 1 < buf.size() && buf[ev.pos + 1] > 0) ++on;
+        if (on != res.notes) {
+            std::cerr << res.path << ": 다시 읽은 노트 " << on << "개, 쓴 노트 " << res.notes << "개\n";
+            res.ok = false;
+        }
+    }
+    res.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    return res;
+}
+
+int main(int argc, char** argv) {
+    std::ios::sync_with_stdio(false);
+
+    GenConfig cfg;
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        if (std::strncmp(a, "--count=", 8) == 0) cfg.count = std::atoi(a + 8);
+        else if (std::strncmp(a, "--notes=", 8) == 0) cfg.notes = std::atol(a + 8);
+        else if (std::strncmp(a, "--bpm=", 6) == 0) cfg.bpm = std::atof(a + 6);
+        else if (std::strncmp(a, "--bpm-min=", 10) == 0) cfg.bpmMin = std::atof(a + 10);
+        else if (std::strncmp(a, "--bpm-max=", 10) == 0) cfg.bpmMax = std::atof(a + 10);
+        else if (std::strncmp(a, "--tempo-changes=", 16) == 0) cfg.tempoChanges = std::atoi(a + 16);
+        else if (std::strncmp(a, "--meter-changes=", 16) == 0) cfg.meterChanges = std::atoi(a + 16);
+        else if (std::strncmp(a, "--layout=", 9) == 0) cfg.layout = a + 9;
+        else if (std::strncmp(a, "--fill=", 7) == 0) cfg.fill = std::atof(a + 7);
+        else if (std::strncmp(a, "--poly=", 7) == 0) cfg.poly = std::clamp(std::atoi(a + 7), 1, 4);
+        else if (std::strncmp(a, "--tpqn=", 7) == 0) cfg.tpqn = std::atoi(a + 7);
+        else if (std::strncmp(a, "--seed=", 7) == 0) cfg.seed = std::strtoull(a + 7, nullptr, 10);
+        else if (std::strncmp(a, "--threads=", 10) == 0) cfg.threads = std::atoi(a + 10);
+        else if (std::strncmp(a, "--out=", 6) == 0) cfg.out = a + 6;
+        else if (std::strncmp(a, "--prefix=", 9) == 0) cfg.prefix = a + 9;
+        else if (std::strcmp(a, "--verify") == 0) cfg.verify = true;
+        else {
+            std::cerr << "알 수 없는 옵션: " << a << "\n";
+            return 1;
+        }
+    }
+    if (cfg.count <= 0 || cfg.notes <= 0 || cfg.bpm <= 0 || cfg.tpqn <= 0 || cfg.tpqn > 0x7FFF ||
+        (cfg.layout != "single" && cfg.layout != "drum" && cfg.layout != "split")) {
+        std::cerr << "옵션 값 오류 (count/notes/bpm/tpqn > 0, layout = single|drum|split)\n";
+        return 1;
+    }
+    // 템포는 24비트 us 로 저장되므로 너무 느린 bpm 은 넘침 (0 이면 0 나누기)
+    auto bpmOk = [](double b) { return b >= SMF_MIN_BPM && b <= SMF_MAX_BPM; };
+    if (!bpmOk(cfg.bpm) || !bpmOk(cfg.bpmMin) || !bpmOk(cfg.bpmMax) || cfg.bpmMin > cfg.bpmMax) {
+        std::cerr << "bpm 범위 오류 (" << SMF_MIN_BPM << " <= bpm, bpm-min <= bpm-max <= " << SMF_MAX_BPM << ")\n";
+        return 1;
+    }
+    std::error_code ec;
+    std::filesystem::create_directories(cfg.out, ec);
+
+    unsigned nThreads = cfg.threads ? cfg.threads : std::max(1u, std::thread::hardware_concurrency());
+    nThreads = std::min<unsigned>(nThreads, static_cast<unsigned>(cfg.count));
+    std::vector<GenFileResult> results(cfg.count);
+    std::atomic<int> next{0};
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned w = 0; w < nThreads; ++w) {
+        workers.emplace_back([&] {
+            for (int i; (i = next.fetch_add(1)) < cfg.count;) results[i] = generateFile(i, cfg);
+        });
+    }
+    for (auto& t : workers) t.join();
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::cout << std::fixed << std::setprecision(1);
+    long totalNotes = 0;
+    size_t totalBytes = 0;
+    int failed = 0;
+    for (const auto& r : results) {
+        std::cout << r.path << ": 노트 " << r.notes << "개, 마디 " << r.bars << "개, " << r.bytes << " bytes, " << r.ms
+                  << " ms" << (r.ok ? "" : "  → FAIL") << "\n";
+        totalNotes += r.notes;
+        totalBytes += r.bytes;
+        failed += !r.ok;
+    }
+    std::cout << "[전체] " << cfg.count << "개 파일, 노트 " << totalNotes << "개, " << totalBytes / 1024 << " KB, "
+              << nThreads << "스레드, " << sec * 1000.0 << " ms (" << totalNotes / std::max(sec, 1e-9) / 1e6
+              << "M 노트/s)\n";
+    return failed ? 2 : 0;
+}
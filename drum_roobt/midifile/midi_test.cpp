@@ -5,6 +5,8 @@
 #include <string>
 #include <sstream>
 
+#include "../common/note_slot.hpp"
+
 // ========================== 1단계: MIDI to midcode CSV ==========================
 bool readMidiFile(const std::string& filename, std::vector<unsigned char>& buffer) {
     std::ifstream file(filename, std::ios::binary | std::ios::ate);
@@ -94,11 +96,6 @@ void extract_midi_events(const std::string& midiFilePath, const std::string& out
 }
 
 // ========================== 2단계: midcode CSV → 병합 CSV ==========================
-struct Event {
-    double time;
-    std::vector<int> notes;
-};
-
 std::vector<std::string> splitByWhitespace(const std::string& line) {
     std::istringstream iss(line);
     std::vector<std::string> tokens;
@@ -124,7 +121,14 @@ void merge_events_and_save(const std::string& inputCsvPath, const std::string& o
         return;
     }
 
-    std::vector<Event> mergedEvents;
+    // 노트 → 손 악기/플래그 (이 파일에서는 11 이 하이햇 열림 신호, 손 악기 아님)
+    static const NoteSlotTable table = {
+        {0, 1, 2, 3, 4, 5, 6, 7, 8, 0, 0, 0, 0, 0, 0, 0},
+        {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, SLOT_BASS, SLOT_HH_OPEN, 0, 0, 0, 0},
+    };
+
+    std::vector<NoteSlot> mergedEvents;
+    mergedEvents.reserve(1024);
     std::string line;
     double currentTime = 0.0;
 
@@ -140,9 +144,9 @@ void merge_events_and_save(const std::string& inputCsvPath, const std::string& o
 
             if (mergedEvents.empty() || delta > 0) {
                 currentTime += delta;
-                mergedEvents.push_back({currentTime, {note}});
+                mergedEvents.push_back(makeNoteSlot(currentTime, note, table));
             } else {
-                mergedEvents.back().notes.push_back(note);
+                mergedEvents.back().add(note, table);
             }
         } catch (...) {
             continue;
@@ -152,24 +156,11 @@ void merge_events_and_save(const std::string& inputCsvPath, const std::string& o
     double prevTime = 0.0;
 
     for (const auto& e : mergedEvents) {
-        int inst1 = 0, inst2 = 0;
-        int bassHit = 0;
+        int inst1 = e.inst1(), inst2 = e.inst2();
+        int bassHit = (e.flags & SLOT_BASS) ? 1 : 0;
+        if (e.flags & SLOT_HH_OPEN) hihatState = 0; // Open
         int hihat = hihatState;
 
-        for (int note : e.notes) {
-            if (note >= 1 && note <= 8) {
-                if (inst1 == 0) inst1 = note;
-                else if (inst2 == 0) inst2 = note;
-            } else if (note == 10) {
-                bassHit = 1;
-            } else if (note == 11) {
-                hihatState = 0; // Open
-            } else if (note == 5) {
-                hihatState = 1; // Closed
-            }
-        }
-
-        hihat = hihatState;
         double deltaTime = e.time - prevTime;
         prevTime = e.time;
 
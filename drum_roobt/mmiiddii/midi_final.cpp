@@ -2,37 +2,27 @@
 #include <bits/stdc++.h>
 #include <filesystem>
 
-enum Hand { LEFT, RIGHT, SAME };
-
-struct Coord {
-    double x, y, z;
-};
-
-struct Event{
-    double time;
-    std::vector<int> notes;
-};
-
-struct VelocityEntry {
-    double time;
-    int instrument;
-    int velocity;
-};
-
-Coord drumXYZ[9] = {
-    {0.0, 0.0, 0.0},
-    {-0.13, 0.52, 0.61}, {0.25, 0.50, 0.62}, {0.21, 0.67, 0.87},
-    {-0.05, 0.69, 0.83}, {-0.28, 0.60, 0.88}, {0.32, 0.71, 1.06},
-    {0.47, 0.52, 0.88}, {-0.06, 0.73, 1.06}
-};
-
-std::vector<std::string> splitByWhitespace(const std::string& line) {
-    std::istringstream iss(line);
-    std::vector<std::string> tokens;
-    std::string token;
-    while (iss >> token) tokens.push_back(token);
-    return tokens;
-}
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "../common/drum_kit.hpp"
+#include "../common/hand_assign.hpp"
+#include "../common/midi_merge.hpp"
+#include "../common/note_slot.hpp"
+#include "../common/text_reader.hpp"
+#include "../common/stage_cache.hpp"
+#include "../common/latency_table.hpp"
+#include "../common/hand_table.hpp"
+#include "../common/quantize.hpp"
+#include "../common/trace.hpp"
+#include "../common/incremental_score.hpp"
+#include "../common/setlist_score.hpp"
+
+// 데몬 워커에서는 끔 (템포 변경 출력과 확인용 대기를 건너뜀)
+thread_local bool pipelineVerbose = true;
 
 void handleMetaEvent(const std::vector<unsigned char>& data, size_t& pos, int &bpm) {
     unsigned char metaType = data[pos++];
@@ -48,19 +38,16 @@ void handleMetaEvent(const std::vector<unsigned char>& data, size_t& pos, int &b
                     ((data[pos + 1] & 0xFF) << 8) |
                     (data[pos + 2] & 0xFF);
         bpm = 60000000 / tempo;
-        std::cout << "  - Tempo Change: " << bpm << " BPM\n";
-        usleep(500000);
+        if (pipelineVerbose) {
+            std::cout << "  - Tempo Change: " << bpm << " BPM\n";
+            usleep(500000);
+        }
     } else if (metaType == 0x2F) {
         // std::cout << "  - End of Track reached\n";
     }
     pos = startPos + length;
 }
 
-void handleChannel10(const std::vector<unsigned char>& data, size_t& pos, unsigned char eventType) {
-    unsigned char control = data[pos++];
-    if (eventType == 0xB9) pos++;
-}
-
 bool readMidiFile(const std::string& filename, std::vector<unsigned char>& buffer) {
     std::ifstream file(filename, std::ios::binary | std::ios::ate);
     if (!file) {
@@ -77,23 +64,7 @@ bool readMidiFile(const std::string& filename, std::vector<unsigned char>& buffe
     return true;
 }
 
-size_t readTime(const std::vector<unsigned char>& data, size_t& pos) {
-    size_t value = 0;
-    while (pos < data.size()) {
-        unsigned char byte = data[pos];
-        value = (value << 7) | (byte & 0x7F);
-        pos++;
-        if ((byte & 0x80) == 0) break;
-    }
-    return value;
-}
-
-void save_to_csv(const std::string& outputCsvPath, double &note_on_time, int drumNote) {
-    std::ofstream file(outputCsvPath, std::ios::app);
-    if (!file) {
-        std::cerr << "Failed to open CSV file: " << outputCsvPath << std::endl;
-        return;
-    }
+void save_to_csv(std::ostream& file, double &note_on_time, int drumNote) {
     int mappedDrumNote;
     switch (drumNote) {
         case 38: mappedDrumNote = 1; break;
@@ -109,11 +80,10 @@ void save_to_csv(const std::string& outputCsvPath, double &note_on_time, int dru
         default: mappedDrumNote = 0; break;
     }
     file << note_on_time << "\t " << mappedDrumNote << "\n";
-    file.close();
     note_on_time = 0;
 }
 
-void handleNoteOn(const std::vector<unsigned char>& data, size_t& pos, double &note_on_time, int tpqn, int bpm, const std::string& midiFilePath) {
+void handleNoteOn(const std::vector<unsigned char>& data, size_t& pos, double &note_on_time, int tpqn, int bpm, std::ostream& csv) {
     if (pos + 2 > data.size()) return;
     unsigned char drumNote = data[pos++];
     unsigned char velocity = data[pos++];
@@ -134,36 +104,13 @@ void handleNoteOn(const std::vector<unsigned char>& data, size_t& pos, double &n
     if (velocity > 0) {
         note_on_time = ((note_on_time * 60000) / (bpm * tpqn)) / 1000;
         // std::cout << std::fixed << std::setprecision(1) << note_on_time << "s\t" << "Hit Drum: " << drumName << " -> " << (int)drumNote << "\n";
-        save_to_csv(midiFilePath, note_on_time, drumNote);
-    }
-}
-
-void analyzeMidiEvent(const std::vector<unsigned char>& data, size_t& pos, unsigned char& runningStatus, double &note_on_time, int &tpqn, int &bpm, const std::string& midiFilePath) {
-    if (pos >= data.size()) return;
-    unsigned char eventType = data[pos];
-    if (eventType == 0xFF || eventType == 0xB9 || eventType == 0xC9 || eventType == 0x99 || eventType == 0x89|| eventType == 0xA9) {
-        runningStatus = eventType;
-        pos++;
-    } else {
-        eventType = runningStatus;
-    }
-    if (eventType == 0xFF) {
-        handleMetaEvent(data, pos, bpm);
-    } else if (eventType == 0xB9 || eventType == 0xC9) {
-        handleChannel10(data, pos, eventType);
-    } else if (eventType == 0x99) {
-        handleNoteOn(data, pos, note_on_time, tpqn, bpm, midiFilePath);
-    } else if (eventType == 0x89 || eventType == 0xA9) {
-        pos += 2;
-    }else {
-        std::cout << "unknown midiEvent - analyzeMidiEvent\n";
-        pos++;
+        save_to_csv(csv, note_on_time, drumNote);
     }
 }
 
 void roundDurationsToStep(const std::string& inputFilename, const std::string& outputFilename)
 {
-    std::ifstream inputFile(inputFilename);
+    TextReader inputFile(inputFilename);
     std::ofstream outputFile(outputFilename);
 
     if (!inputFile.is_open()) {
@@ -176,15 +123,14 @@ void roundDurationsToStep(const std::string& inputFilename, const std::string& o
         return;
     }
 
-    std::string line;
+    std::string_view line, f[2];
     const double step = 0.05;
 
-    while (std::getline(inputFile, line)) {
-        std::istringstream iss(line);
+    while (inputFile.nextLine(line)) {
         double duration;
         int note;
 
-        if (!(iss >> duration >> note)) {
+        if (splitFields(line, f, 2) < 2 || !toDouble(f[0], duration) || !toInt(f[1], note)) {
             std::cerr << "roundDurationsToStep 잘못된 형식: " << line << std::endl;
             continue;
         }
@@ -196,14 +142,13 @@ void roundDurationsToStep(const std::string& inputFilename, const std::string& o
                    << roundedDuration << "\t" << note << std::endl;
     }
 
-    inputFile.close();
     outputFile.close();
 
 }
 
 void roundDurationsToStepSet100(int bpm, const std::string& inputFilename, const std::string& outputFilename)
 {
-    std::ifstream inputFile(inputFilename);
+    TextReader inputFile(inputFilename);
     std::ofstream outputFile(outputFilename);
 
     if (!inputFile.is_open()) {
@@ -216,18 +161,17 @@ void roundDurationsToStepSet100(int bpm, const std::string& inputFilename, const
         return;
     }
 
-    std::string line;
+    std::string_view line, f[2];
     const double step = 0.05;
     int targetBPM = 100;
     const double scale = static_cast<double>(bpm) / static_cast<double>(targetBPM);
 
 
-    while (std::getline(inputFile, line)) {
-        std::istringstream iss(line);
+    while (inputFile.nextLine(line)) {
         double duration;
         int note;
 
-        if (!(iss >> duration >> note)) {
+        if (splitFields(line, f, 2) < 2 || !toDouble(f[0], duration) || !toInt(f[1], note)) {
             std::cerr << "roundDurationsToStep 잘못된 형식: " << line << std::endl;
             continue;
         }
@@ -242,59 +186,12 @@ void roundDurationsToStepSet100(int bpm, const std::string& inputFilename, const
                    << roundedDuration << "\t" << note << std::endl;
     }
 
-    inputFile.close();
     outputFile.close();
 
 }
 
-double dist(const Coord& a, const Coord& b) {
-    return std::sqrt(
-        (a.x - b.x)*(a.x - b.x) +
-        (a.y - b.y)*(a.y - b.y) +
-        (a.z - b.z)*(a.z - b.z)
-    );
-}
-
-Hand getPreferredHandByDistance(int instCurrent, int prevRightNote, int prevLeftNote, double prevRightHit, double prevLeftHit) {
-
-    Coord curr = drumXYZ[instCurrent];
-    Coord right = drumXYZ[prevRightNote];
-    Coord left = drumXYZ[prevLeftNote];
-
-    double dMax = 0.754;
-    double dRight = dist(curr, right);
-    double dLeft = dist(curr, left);
-    // 시간의 max값 0.6으로 고정
-    double real_tRight = std::min(prevRightHit, 0.6);
-    double real_tLeft  = std::min(prevLeftHit, 0.6);
-    double normRight = std::min(dRight / dMax, 1.0)*2;
-    double normLeft = std::min(dLeft / dMax, 1.0)*2;
-
-    double rScore = (real_tRight / 0.6) * (2 - normRight);
-    double lScore = (real_tLeft  / 0.6) * (2 - normLeft);
-
-    // 디버깅용 프린트문
-    std::cout << "\n[Hand 선택 판단]\n";
-    std::cout << " - instCurrent: " << instCurrent << "\n";
-    std::cout << " - prevRightNote: " << prevRightNote << ", prevLeftNote: " << prevLeftNote << "\n";
-    std::cout << " - 거리: right = " << dRight << ", left = " << dLeft << "\n";
-    std::cout << " - 시간누적: right = " << prevRightHit << ", left = " << prevLeftHit << "\n";
-    std::cout << " - 사용시간: right = " << real_tRight << ", left = " << real_tLeft << "\n";
-    std::cout << " - 정규화 거리: right = " << normRight << ", left = " << normLeft << "\n";
-    std::cout << " - 점수: rScore = " << rScore << ", lScore = " << lScore << "\n";
-
-    if (std::abs(rScore - lScore) < 1e-6) {
-        std::cout << " → 결과: SAME (유사한 점수)\n";
-        return SAME;
-    }
-
-    Hand chosen = (lScore <= rScore) ? RIGHT : LEFT;
-    std::cout << " → 선택된 손: " << (chosen == RIGHT ? "RIGHT" : "LEFT") << "\n";
-    return chosen;
-}
-
 void convertMcToC(const std::string& inputFilename, const std::string& outputFilename) {
-    std::ifstream input(inputFilename);
+    TextReader input(inputFilename);
     if (!input.is_open()) {
         std::cerr << " 입력 파일 열기 실패: " << inputFilename << "\n";
         return;
@@ -305,50 +202,39 @@ void convertMcToC(const std::string& inputFilename, const std::string& outputFil
         return;
     }
 
-    std::vector<Event> mergedEvents;  
-    std::string line;
+    // 노트 → 손 악기/플래그 (11 닫힌 하이햇은 손으로 5번을 치고 하이햇 상태를 닫힘으로)
+    static const NoteSlotTable table = {
+        {0, 1, 2, 3, 4, 5, 6, 7, 8, 0, 0, 5, 0, 0, 0, 0},
+        {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, SLOT_BASS, SLOT_HH_CLOSED, 0, 0, 0, 0},
+    };
+
+    std::vector<NoteSlot> mergedEvents;
+    mergedEvents.reserve(1024);
+    std::string_view line, f[2];
     double currentTime = 0.0;
     int hihatState = 1;
 
-    while (std::getline(input, line)) {
-        auto tokens = splitByWhitespace(line);
-        if (tokens.size() != 2) continue;
-        try {
-            double delta = std::stod(tokens[0]);
-            int rawNote = std::stoi(tokens[1]);
-            int mapped = rawNote;
-            if (mapped < 1 || mapped > 11) continue;
-            if (mergedEvents.empty() || delta > 0) {
-                currentTime += delta;
-                mergedEvents.push_back({currentTime, {mapped}});
-            } else {
-                mergedEvents.back().notes.push_back(mapped);
-            }
-        } catch (...) { continue; }
+    while (input.nextLine(line)) {
+        if (splitFields(line, f, 2) != 2) continue;
+        double delta;
+        int rawNote;
+        if (!toDouble(f[0], delta) || !toInt(f[1], rawNote)) continue;
+        int mapped = rawNote;
+        if (mapped < 1 || mapped > 11) continue;
+        if (mergedEvents.empty() || delta > 0) {
+            currentTime += delta;
+            mergedEvents.push_back(makeNoteSlot(currentTime, mapped, table));
+        } else {
+            mergedEvents.back().add(mapped, table);
+        }
     }
 
     double prevTime = 0.0;
     for (const auto& e : mergedEvents) {
-        int inst1 = 0, inst2 = 0;
-        int bassHit = 0;
+        int inst1 = e.inst1(), inst2 = e.inst2();
+        int bassHit = (e.flags & SLOT_BASS) ? 1 : 0;
+        if (e.flags & SLOT_HH_CLOSED) hihatState = 1;
         int hihat = hihatState;
-        for (int note : e.notes) {
-            if (note >= 1 && note <= 8) {
-                if (inst1 == 0) inst1 = note;
-                else if (inst2 == 0) inst2 = note;
-            } else if (note == 10) {
-                bassHit = 1;
-            } else if (note == 11) {
-                if (inst1 == 0) inst1 = 5;
-                else if (inst2 == 0) inst2 = 5;
-                hihatState = 1;
-            } else if (note == 5) {
-                hihatState = 0;
-                if (inst1 == 0) inst1 = 5;
-                else if (inst2 == 0) inst2 = 5;
-            }
-        }
-        hihat = hihatState;
         double deltaTime = e.time - prevTime;
         prevTime = e.time;
         output << std::fixed << std::setprecision(3)
@@ -364,122 +250,9 @@ void convertMcToC(const std::string& inputFilename, const std::string& outputFil
     // std::cout << "변환 완료! 저장 위치 → " << outputFilename << "\n";
 }
 
-std::pair<int, int> assignHandsByPosition(int inst1, int inst2) {
-    auto getSection = [](int inst) {
-        if (inst == 5) return 1;
-        if (inst == 1 || inst == 4 || inst == 8) return 2;
-        if (inst == 2 || inst == 3 || inst == 6) return 3;
-        if (inst == 7) return 4;
-        return 0; // unknown
-    };
-
-    auto getSectionOrder = [](int inst) {
-        // 낮을수록 왼쪽
-        if (inst == 8) return 1;
-        if (inst == 1) return 2;
-        if (inst == 4) return 3;
-        if (inst == 3) return 1;
-        if (inst == 2) return 2;
-        if (inst == 6) return 3;
-        return 0;
-    };
-
-    int sec1 = getSection(inst1);
-    int sec2 = getSection(inst2);
-
-    std::cout << "[섹션 손 분배 판단]\n";
-    std::cout << " - inst1: " << inst1 << " (섹션 " << sec1 << "), inst2: " << inst2 << " (섹션 " << sec2 << ")\n";
-
-    if (sec1 < sec2) {
-        std::cout << " → 서로 다른 섹션: inst1이 더 왼쪽 → 왼손 = " << inst1 << ", 오른손 = " << inst2 << "\n";
-        return {inst1, inst2};
-    } else if (sec2 < sec1) {
-        std::cout << " → 서로 다른 섹션: inst2가 더 왼쪽 → 왼손 = " << inst2 << ", 오른손 = " << inst1 << "\n";
-        return {inst2, inst1};
-    } else {
-        int order1 = getSectionOrder(inst1);
-        int order2 = getSectionOrder(inst2);
-        std::cout << " → 같은 섹션 내 비교: order1 = " << order1 << ", order2 = " << order2 << "\n";
-        if (order1 < order2) {
-            std::cout << "   → inst1이 더 왼쪽 → 왼손 = " << inst1 << ", 오른손 = " << inst2 << "\n";
-            return {inst1, inst2};
-        } else {
-            std::cout << "   → inst2가 더 왼쪽 → 왼손 = " << inst2 << ", 오른손 = " << inst1 << "\n";
-            return {inst2, inst1};
-        }
-    }
-}
-
-static int zoneOf(int inst) {
-    if (inst == 0) return 0;          // 비어있음
-    if (inst == 5) return 1;          // 하이햇
-    if (inst == 8 || inst == 4 || inst == 1) return 2; // 크래시(8), 하이탐(4), 스네어(1)
-    if (inst == 2 || inst == 3 || inst == 6) return 3; // 플로어(2), 미드탐(3), 라이드벨(6)
-    if (inst == 7) return 4;          // 라이드(7)
-    return 3; // 정의 밖은 기본적으로 중앙-우측 계열로 가정
-}
-
-static bool isCrossed(int rightInst, int leftInst) {
-    if (rightInst == 0 || leftInst == 0) return false;          // 한 손 비어있으면 꼬임 아님
-    if (rightInst == 5 && leftInst == 1) return false;          // 예외 허용(오른손 하이햇, 왼손 스네어)
-    int zr = zoneOf(rightInst);
-    int zl = zoneOf(leftInst);
-    return (zl > zr);
-}
-
-// 손 크로스 방지 함수
-void checkCross(int& rightHand, int& leftHand,
-                int prevRightNote, int prevLeftNote) {
-    std::cout << "    [CrossCheck] In RH=" << rightHand << " LH=" << leftHand
-              << " | lastR=" << prevRightNote << " lastL=" << prevLeftNote << "\n";
-
-    // 1) 양손 동시타 → 현재 프레임 내에서 교차 검사
-    if (rightHand && leftHand) {
-        int zr = zoneOf(rightHand), zl = zoneOf(leftHand);
-        std::cout << "    [Both] zone(LH)=" << zl << ", zone(RH)=" << zr << "\n";
-        if (isCrossed(rightHand, leftHand)) {
-            std::cout << "    [Both→Swap] LH(" << leftHand << ',' << zl
-                      << ") > RH(" << rightHand << ',' << zr << ") → Swap\n";
-            std::swap(rightHand, leftHand);
-            std::cout << "    [Both→After] RH=" << rightHand
-                      << " LH=" << leftHand << "\n";
-        }
-        return;
-    }
-
-    // 2) 단일타: RH만 있음 → 이전 왼손과 비교
-    if (rightHand && !leftHand) {
-        if (prevLeftNote && isCrossed(rightHand, prevLeftNote)) {
-            int zr = zoneOf(rightHand), zl = zoneOf(prevLeftNote);
-            std::cout << "    [Single RH] RH(" << rightHand << ',' << zr
-                      << ") vs lastL(" << prevLeftNote << ',' << zl << ") → LH 재배정\n";
-            leftHand = rightHand;
-            rightHand = 0;
-            std::cout << "    [Single RH→After] RH=" << rightHand
-                      << " LH=" << leftHand << "\n";
-        }
-        return;
-    }
-
-    // 3) 단일타: LH만 있음 → 이전 오른손과 비교
-    if (leftHand && !rightHand) {
-        if (prevRightNote && isCrossed(prevRightNote, leftHand)) {
-            int zr = zoneOf(prevRightNote), zl = zoneOf(leftHand);
-            std::cout << "    [Single LH] lastR(" << prevRightNote << ',' << zr
-                      << ") vs LH(" << leftHand << ',' << zl << ") → RH 재배정\n";
-            rightHand = leftHand;
-            leftHand = 0;
-            std::cout << "    [Single LH→After] RH=" << rightHand
-                      << " LH=" << leftHand << "\n";
-        }
-        return;
-    }
-
-    std::cout << "    [None] RH=0, LH=0 → skip\n";
-}
-
-void assignHandsToEvents(const std::string& inputFilename, const std::string& outputFilename) {
-    std::ifstream input(inputFilename);
+void assignHandsToEvents(const std::string& inputFilename, const std::string& outputFilename,
+                         const HandDecisionTable* table = nullptr) {
+    TextReader input(inputFilename);
     if (!input.is_open()) {
         std::cerr << "입력 파일 열기 실패: " << inputFilename << "\n";
         return;
@@ -490,207 +263,27 @@ void assignHandsToEvents(const std::string& inputFilename, const std::string& ou
         return;
     }
 
-    struct FullEvent {
-        double time;
-        int inst1 = 0, inst2 = 0, bassHit = 0, hihat = 1;
-        int rightHand = 0, leftHand = 0;
-    };
-
-    std::string line;
+    std::string_view line, f[7];
     std::vector<FullEvent> events;
-    //직전 라인에 할당된 악기 0 포함
-    int prevRight = 1, prevLeft = 1;
-    //실제 마지막으로 친 악기
-    int prevRightNote = 1, prevLeftNote = 1;
-    double prevRightHit = 0, prevLeftHit = 0;
+    events.reserve(1024);
 
-    while (std::getline(input, line)) {
-        auto tokens = splitByWhitespace(line);
-        if (tokens.size() != 7) continue;
+    while (input.nextLine(line)) {
+        if (splitFields(line, f, 7) != 7) continue;
 
         FullEvent e;
-        e.time = std::stod(tokens[0]);
-        e.inst1 = std::stoi(tokens[1]);
-        e.inst2 = std::stoi(tokens[2]);
-        e.bassHit = std::stoi(tokens[5]);
-        e.hihat = std::stoi(tokens[6]);
-
-        int inst1 = e.inst1, inst2 = e.inst2;
-        prevRightHit += e.time;
-        prevLeftHit += e.time;
-
-        std::cout << "[Time: " << e.time << "] inst1: " << inst1 << ", inst2: " << inst2
-                  << " | PrevR: " << prevRight << ", PrevL: " << prevLeft
-                  << " | RHit: " << prevRightHit << ", LHit: " << prevLeftHit << "\n";
-        
-        // //step 1 크러시가 있는지 확인 크러쉬가 있다면 
-        // if (inst1 == 8 || inst2 == 8) {
-        //     std::cout << "→ 크러시 처리 진입\n";
-        //     if(prevLeft == 2 || prevLeft == 3 || prevLeft == 6) {
-        //         e.rightHand = 7;
-        //         e.leftHand = (inst1 == 8) ? inst2 : inst1;
-        //     } else {
-        //         if (inst1 == 2 || inst1 == 3 || inst1 == 6 || inst2 == 2 || inst2 == 3 || inst2 == 6) {
-        //             e.rightHand = 7;
-        //             e.leftHand = (inst1 == 8) ? inst2 : inst1;
-        //         } else {
-        //             e.rightHand = 8;
-        //             e.leftHand = (inst1 == 8) ? inst2 : inst1;
-        //         }
-        //     }
-        // }
-        // //step 1-1 크러시가 있는지 확인 크러쉬가 있다면 
-        if(inst1 == 7 || inst1 == 8 || inst2 == 7 || inst2 == 8)
-        {
-            std::cout << "→ 크러시 처리 진입 1-1\n";
-            //양손연주라면
-            if (inst1 != 0 && inst2 != 0)
-                {
-                    // 두 손 모두 크래시를 치는 경우 → 규칙적으로 inst1=7(오른 크래시), inst2=8(왼 크래시)로 고정
-                    bool bothCrash = ((inst1 == 7 || inst1 == 8) && (inst2 == 7 || inst2 == 8));
-                    if (bothCrash) {
-                        e.rightHand = 7; 
-                        e.leftHand  = 8;
-                    }
-                    else {
-                        // 두 손이 동시에 치지만 "둘 다 크래시가 아님" → 기존 위치 기반 손 배분 사용
-                        auto [left, right] = assignHandsByPosition(inst1, inst2);
-                        e.leftHand  = left;
-                        e.rightHand = right;
-                    }
-                }
-                //한손 연주 라면
-                else
-                {
-                    // 마지막으로 왼손으로 친게 3,2,7,6 중에 하나면 오른손으로 오른쪽 크러시 치기
-                    if (prevLeftNote == 3 || prevLeftNote == 2 || prevLeftNote == 7 || prevLeftNote == 6) {
-                        e.leftHand  = 0;
-                        e.rightHand = 7;
-                    } 
-                    //아니라면 왼쪽 크러시를 사용할 예정
-                    else {
-                        if (prevRightNote == 3 || prevRightNote == 2 || prevRightNote == 7 || prevRightNote == 6)
-                        {
-                            e.rightHand = 0;
-                            e.leftHand  = 8;
-                        }
-                        else
-                        {
-                            e.rightHand = 8;
-                            e.leftHand  = 0;
-                        }
-
-                    }
-                    // //이건 전에 친 악/기 섹션 비고 하는거 위에 방법을 쓰던 밑에 섹션비교방법을쓰던 하나만쓰기
-                    // auto [left, right] = assignHandsByPosition(prevRightNote, prevLeftNote);
-                    // // leftInstOfPair가 prevLeftNote라면 '왼손 위치가 더 왼쪽'이라는 뜻
-                    // bool chooseLeft = (left == prevLeftNote);
-
-
-                    // // 실제 출력 반영: 어느 슬롯이 비어있든 상관없이 8을 선택 손에 할당
-                    // if (chooseLeft) {
-                    //     e.leftHand  = 8;
-                    //     e.rightHand = 0;
-                    // } else {
-                    //     e.rightHand = 8;
-                    //     e.leftHand  = 0;
-                    // }
-                }
-        }
-        // step 2 양손 연주인지 한손인지 구분 
-        else if (inst1 != 0 && inst2 != 0) {
-            std::cout << "→ 양손 처리 진입\n";
-            // 1번 S와 5번 H-H 을 같이 치는 경우 오른손으로 H-H 왼손으로 S 치도록 설정
-            if ((inst1 == 5 && inst2 == 1) || (inst1 == 1 && inst2 == 5)) 
-            {
-                e.leftHand = (inst1 == 5) ? inst2 : inst1;
-                e.rightHand = (inst1 == 5) ? inst1 : inst2;
-            }
-            // 위의 경우를 제외한 모든 경우 악기 위치 기반으로 손 분배 
-            else 
-            {
-                auto [left, right] = assignHandsByPosition(inst1,inst2);
-                e.leftHand = left;
-                e.rightHand = right;
-            }
-        }
-        // step 3 한손 연주시 처리 
-        else if (inst1 != 0) {
-            std::cout << "→ 한손 처리 진입\n";
-            // 이전에 쳤던 악기와 같은 악기가 감지된다면 짧은 시간에 타격해야 할 시 같은 손 유지 시간차이가 크다면 거리 기반 판단
-            if (inst1 == prevRight || inst1 == prevLeft) {
-                std::cout << "    - 이전 손과 같은 악기 감지\n";
-                if (e.time <= 0.1) {
-                    std::cout << "    - 시간차 0.1 이하 → 같은 손 유지\n";
-                    if(inst1 == prevRight)
-                    {
-                        e.rightHand = inst1;
-                        e.leftHand = 0;
-                    }
-                    else
-                    {
-                        e.rightHand = 0;
-                        e.leftHand = inst1;
-                    }
-                } else {
-                    std::cout << "    - 시간차 큼 → 거리 기반 판단\n";
-                    Hand preferred = getPreferredHandByDistance(inst1, prevRightNote, prevLeftNote, prevRightHit, prevLeftHit);
-                    if (preferred == RIGHT) {
-                        std::cout << "    → RIGHT 선택\n";
-                        e.rightHand = inst1;
-                        e.leftHand = 0;
-                    } else if (preferred == LEFT) {
-                        std::cout << "    → LEFT 선택\n";
-                        e.leftHand = inst1;
-                        e.rightHand = 0;
-                    }    
-                    else {
-                        std::cout << "    → 점수 같고 시간 널널 오른손 우선권 선택\n";
-                        // 여기는 한손 연주이면서 전에 쳤던 악기를 치는 것이지만 시간과 거리에 대한 점수도 모두 동일함 일단 오른손에 우선권을 주겠다.
-                        e.rightHand = inst1;
-                        e.leftHand = 0;
-                    }
-                }
-            } else {
-                std::cout << "    - 이전 손과 다른 악기 → 거리 기반 판단\n";
-                Hand preferred = getPreferredHandByDistance(inst1, prevRightNote, prevLeftNote, prevRightHit, prevLeftHit);
-                    if (preferred == RIGHT) {
-                        std::cout << "    → RIGHT 선택\n";
-                        e.rightHand = inst1;
-                    } else if (preferred == LEFT) {
-                        std::cout << "    → LEFT 선택\n";
-                        e.leftHand = inst1;
-                    } 
-                    //악기 위치 거리 기반으로 손 분배 이때 전에 친악기를 inst2로 사용해서 구함  
-                    else {
-                        std::cout << "    → SAME 판단 → 섹션 기반 분배\n";
-                        
-                        int inst2 = (prevRightNote != 0) ? prevRightNote : prevLeftNote;
-                        auto [left, right] = assignHandsByPosition(inst1, inst2);
-                        if(left  == inst1)
-                            e.leftHand  = (left  == inst1) ? inst1 : 0;
-                        else
-                            e.rightHand = (right == inst1) ? inst1 : 0;
-                        
-                        
-                        std::cout << "      - inst1: " << inst1 << ", inst2: " << inst2
-                                    << " → 왼손 = " << e.leftHand << ", 오른손 = " << e.rightHand << "\n";
-                    }
-            }
-        }
-
-        std::cout << "→ 결과: RH = " << e.rightHand << ", LH = " << e.leftHand << "\n\n";
-
-        checkCross(e.rightHand, e.leftHand, prevRightNote, prevLeftNote);
-
-        prevRight = e.rightHand;
-        prevLeft = e.leftHand;
-        if (e.rightHand != 0) { prevRightNote = e.rightHand; prevRightHit = 0; }
-        if (e.leftHand != 0) { prevLeftNote = e.leftHand; prevLeftHit = 0; }
-
+        if (!toDouble(f[0], e.time) || !toInt(f[1], e.inst1) || !toInt(f[2], e.inst2) ||
+            !toInt(f[5], e.bassHit) || !toInt(f[6], e.hihat)) continue;
         events.push_back(e);
     }
 
+    // 결정표가 있으면 표로 배정 (hand_table 로 분기 코드와 같은 결과임을 검증한 표)
+    // 없으면 긴 곡은 구간 병렬 배정 (짧은 곡은 내부에서 직렬 + 디버깅 출력)
+    HandState state;
+    if (table && table->ready())
+        assignHandsTable(events, state, *table);
+    else
+        assignHandsParallel(events, state);
+
     for (const auto& e : events) {
         int rightFlag = 0;
         int leftFlag = 0;
@@ -707,6 +300,14 @@ void assignHandsToEvents(const std::string& inputFilename, const std::string& ou
     }
 }
 
+// "시간 R L Rpow Lpow bass hihat" 한 줄 파싱
+bool parseDrumRow(std::string_view line, double& time, int& r, int& l, int& rp, int& lp, int& bass, int& hihat) {
+    std::string_view f[7];
+    if (splitFields(line, f, 7) < 7) return false;
+    return toDouble(f[0], time) && toInt(f[1], r) && toInt(f[2], l) &&
+           toInt(f[3], rp) && toInt(f[4], lp) && toInt(f[5], bass) && toInt(f[6], hihat);
+}
+
 void convertToMeasureFile(const std::string& inputFilename, const std::string& outputFilename) {
     struct DrumEvent {
         double time;
@@ -718,7 +319,7 @@ void convertToMeasureFile(const std::string& inputFilename, const std::string& o
         int hihatOpen;
     };
 
-    std::ifstream input(inputFilename);
+    TextReader input(inputFilename);
     if (!input.is_open()) {
         std::cerr << "입력 파일 열기 실패: " << inputFilename << "\n";
         return;
@@ -729,14 +330,13 @@ void convertToMeasureFile(const std::string& inputFilename, const std::string& o
         return;
     }
 
-    std::string line;
+    std::string_view line;
     std::vector<DrumEvent> result;
 
-    while (std::getline(input, line)) {
-        std::stringstream ss(line);
+    while (input.nextLine(line)) {
         DrumEvent ev;
-        ss >> ev.time >> ev.rightInstrument >> ev.leftInstrument
-           >> ev.rightPower >> ev.leftPower >> ev.isBass >> ev.hihatOpen;
+        if (!parseDrumRow(line, ev.time, ev.rightInstrument, ev.leftInstrument,
+                          ev.rightPower, ev.leftPower, ev.isBass, ev.hihatOpen)) continue;
 
         int count = static_cast<int>(ev.time / 0.6);
         double leftover = ev.time - count * 0.6;
@@ -794,7 +394,7 @@ void newconvertToMeasureFile(const std::string& inputFilename, const std::string
     constexpr double MEASURE = 2.4;   // 1마디(= 0.6 * 4)
     constexpr double EPS = 1e-9;
 
-    std::ifstream input(inputFilename);
+    TextReader input(inputFilename);
     if (!input.is_open()) {
         std::cerr << "입력 파일 열기 실패: " << inputFilename << "\n";
         return;
@@ -806,19 +406,14 @@ void newconvertToMeasureFile(const std::string& inputFilename, const std::string
     }
 
     std::vector<DrumEvent> chunks;
-    std::string line;
-    while (std::getline(input, line)) {
+    std::string_view line;
+    while (input.nextLine(line)) {
         if (line.empty()) continue;
 
         DrumEvent ev{};
-        {
-            std::stringstream ss(line);
-            if (!(ss >> ev.time
-                     >> ev.rightInstrument >> ev.leftInstrument
-                     >> ev.rightPower >> ev.leftPower
-                     >> ev.isBass >> ev.hihatOpen)) {
-                continue; // 파싱 실패 라인 스킵
-            }
+        if (!parseDrumRow(line, ev.time, ev.rightInstrument, ev.leftInstrument,
+                          ev.rightPower, ev.leftPower, ev.isBass, ev.hihatOpen)) {
+            continue; // 파싱 실패 라인 스킵
         }
         if (ev.time <= 0) continue;
 
@@ -894,40 +489,46 @@ void newconvertToMeasureFile(const std::string& inputFilename, const std::string
 }
 
 void addGroove(int bpm, const std::string& inputFile, const std::string& outputFile) {
-    std::ifstream inFile(inputFile);
+    TextReader inFile(inputFile);
     std::ofstream outFile(outputFile);
 
-    std::vector<std::vector<double>> values;
+    // 모든 행을 한 배열에 이어서 저장 (rowStart[i] ~ rowStart[i+1] 가 i번째 행)
+    std::vector<double> flat;
+    std::vector<size_t> rowStart{0};
     std::vector<double> originalTimes;
 
-        std::string line;
+    std::string_view line, f[16];
     // 1. 파일 읽기 및 파싱
-    while (std::getline(inFile, line)) {
-        std::istringstream ss(line);
-        std::vector<double> row;
-        double num;
-        while (ss >> num) {
-            row.push_back(num);
+    while (inFile.nextLine(line)) {
+        int n = std::min(splitFields(line, f, 16), 16);
+        size_t before = flat.size();
+        for (int i = 0; i < n; ++i) {
+            double num;
+            if (!toDouble(f[i], num)) break;
+            flat.push_back(num);
         }
-        values.push_back(row);
-        originalTimes.push_back(row[0]);  // 시간만 따로 저장
+        if (flat.size() == before) continue;  // 숫자가 없는 줄은 건너뜀
+        rowStart.push_back(flat.size());
+        originalTimes.push_back(flat[before]);  // 시간만 따로 저장
     }
+    size_t rowCount = originalTimes.size();
+    auto row = [&](size_t i) { return flat.data() + rowStart[i]; };
 
     // 2. 누적합 기준 계산
     double threshold = (60.0 / bpm) * 2;
     double accTime = 0.0;
 
     // 3. 시간 조정 플래그 처리
-    for (size_t i = 0; i < values.size(); ++i) {
+    for (size_t i = 0; i < rowCount; ++i) {
         accTime += originalTimes[i];  // 항상 원본 기준 누적합 계산
 
         if (accTime >= threshold) {
             // 1. 현재 줄 시간값 -0.05
-            values[i][0] -= 0.05;
+            row(i)[0] -= 0.05;
 
             // 2. 다음 줄 존재하면 +0.05
-            if (i + 1 < values.size()) {
-                values[i + 1][0] += 0.05;
+            if (i + 1 < rowCount) {
+                row(i + 1)[0] += 0.05;
             }
 
             // 누적합 초기화
@@ -936,22 +537,22 @@ void addGroove(int bpm, const std::string& inputFile, const std::string& outputF
     }
 
     // 4. 결과 출력
-    for (const auto& row : values) {
+    for (size_t r = 0; r < rowCount; ++r) {
+        const double* v = row(r);
+        size_t n = rowStart[r + 1] - rowStart[r];
 
-        outFile << std::fixed << std::setprecision(3) << row[0];
+        outFile << std::fixed << std::setprecision(3) << v[0];
     
 
         outFile.unsetf(std::ios::fixed);
         outFile << std::setprecision(6);
     
-        for (size_t i = 1; i < row.size(); ++i) {
-            outFile << "\t" << row[i];
+        for (size_t i = 1; i < n; ++i) {
+            outFile << "\t" << v[i];
         }
         outFile << "\n";
     }
 
-    
-    inFile.close();
     outFile.close();
 }
 
@@ -969,32 +570,16 @@ void MakeVelocitySummary(int bpm, const std::string& velocityFile,const std::str
     //windowSize는 한 마디의 시간
     double windowSize = (60/(double)bpm)*4;
 
-    std::cout << windowSize << std::endl;
+    if (pipelineVerbose) std::cout << windowSize << std::endl;
 
-    std::ifstream in(velocityFile);
+    // 시간/악기/세기 세 열을 열 단위 배열로 한 번에 읽음 (헤더/형식 불량 줄은 건너뜀)
+    ColumnTable cols;
+    loadColumns(velocityFile, 3, cols);
+    const size_t rowCount = cols.rows();
 
-    std::vector<VelocityEntry> rawData;
-    double t; int inst, vel;
     double maxTime = 0.0;
-
-    std::string line;
-    while (std::getline(in, line)) {
-        if (line.empty()) continue;
-
-        std::stringstream ss(line);
-        std::string token;
-
-        if (!std::getline(ss, token, ',')) continue;
-        t = std::stod(token);
-        if (!std::getline(ss, token, ',')) continue;
-        inst = std::stoi(token);
-        if (!std::getline(ss, token, ',')) continue;
-        vel = std::stoi(token);
-
-        rawData.push_back({t, inst, vel});
-        if (t > maxTime) maxTime = t;
-    }
-    in.close();
+    for (size_t i = 0; i < rowCount; ++i)
+        if (cols[0][i] > maxTime) maxTime = cols[0][i];
 
     const int numWindows = static_cast<int>(std::ceil((maxTime + 0.001) / windowSize));
 
@@ -1005,15 +590,18 @@ void MakeVelocitySummary(int bpm, const std::string& velocityFile,const std::str
     std::vector<int>    cntCym(numWindows, 0);
 
     // 시간 구간별 누적
-    for (const auto& e : rawData) {
-        int bin = static_cast<int>(e.time / windowSize);
+    for (size_t i = 0; i < rowCount; ++i) {
+        int bin = static_cast<int>(cols[0][i] / windowSize);
         if (bin < 0 || bin >= numWindows) continue;
 
-        if (e.instrument >= 1 && e.instrument <= 4) {
-            sumDrum[bin] += e.velocity;
+        // 악기/세기는 정수 열 (stoi 처럼 소수점 아래는 버림)
+        int instrument = static_cast<int>(cols[1][i]);
+        int velocity = static_cast<int>(cols[2][i]);
+        if (instrument >= 1 && instrument <= 4) {
+            sumDrum[bin] += velocity;
             cntDrum[bin]++;
-        } else if (e.instrument >= 5 && e.instrument <= 8) {
-            sumCym[bin] += e.velocity;
+        } else if (instrument >= 5 && instrument <= 8) {
+            sumCym[bin] += velocity;
             cntCym[bin]++;
         }
     }
@@ -1044,90 +632,877 @@ void MakeVelocitySummary(int bpm, const std::string& velocityFile,const std::str
     }
     out.close();
 
-    std::cout << "[완료] 드럼/심벌 평균 벨로시티 저장: " << outputFile << "\n";
+    if (pipelineVerbose) std::cout << "[완료] 드럼/심벌 평균 벨로시티 저장: " << outputFile << "\n";
 }
 
 
 
 
-int main() {
-
-    std::string filename;
-    std::cout << "읽을 MIDI 파일 이름을 입력하세요 (예: input0.mid): ";
-    std::cin >> filename;
-
-    size_t pos;
-    unsigned char runningStatus;
-    int initial_setting_flag = 0;
-    double note_on_time = 0;
+// MIDI → 드럼 타격 시간 CSV (output1). 트랙의 템포로 bpm 도 같이 구함
+bool extractDrumHits(const std::filesystem::path& midiPath, const std::string& outputCsv, int &bpm) {
+    TRACE_ZONE("midi_decode");
     std::vector<unsigned char> midiData;
-
-    std::filesystem::path basePath = "/home/taehwang/basic-algo-lecture-master/drum_roobt/mmiiddii/";
-
-    std::filesystem::path magentaPath = basePath / filename;
-    
-    std::string fileStem = filename.substr(0, filename.find_last_of('.'));  // ex: "input0"
-    std::filesystem::path outputDir = basePath / "output" / fileStem;
-    std::filesystem::create_directories(outputDir);
-    
-    std::filesystem::path outputPath1 = outputDir / "output1_drum_hits_time.csv"; 
-    std::filesystem::path outputPath2 = outputDir / "output2_mc.csv";   
-    std::filesystem::path outputPath3 = outputDir / "output3_mc2c.csv";    
-    std::filesystem::path outputPath4 = outputDir / "output4_hand_assign.csv";
-    std::filesystem::path outputPath5 = outputDir / "output5_add_groove.csv";
-    std::filesystem::path outputPath6 = outputDir / ("output6_final_" + fileStem + ".txt");
-    
-    std::filesystem::path VelfileOrigin = basePath / "VelfileOrigin.csv";
-    std::filesystem::path Velfile       = basePath / "Velfile.txt";
-    
-
-    if (!readMidiFile(magentaPath, midiData)) {
+    if (!readMidiFile(midiPath, midiData)) {
         std::cout << "mid file error\n";
-        return 1;
+        return false;
+    }
+
+    // 타격마다 파일을 다시 열지 않고 한 번 열어 둔 스트림에 이어씀
+    std::ofstream csv(outputCsv, std::ios::trunc);
+    if (!csv) {
+        std::cerr << "Failed to open CSV file: " << outputCsv << std::endl;
+        return false;
     }
 
-    pos = 14;
-    int tpqn = (midiData[12] << 8) | midiData[13];
-    int bpm;
-    while (pos + 8 <= midiData.size()) {
-        if (!(midiData[pos] == 'M' && midiData[pos+1] == 'T' && midiData[pos+2] == 'r' && midiData[pos+3] == 'k')) break;
-        size_t trackLength = (midiData[pos+4] << 24) |
-                             (midiData[pos+5] << 16) |
-                             (midiData[pos+6] << 8) |
-                             midiData[pos+7];
-        pos += 8;
-        size_t trackEnd = pos + trackLength;
-
-        note_on_time = 0;
-        while (pos < trackEnd) {
-            size_t delta = readTime(midiData, pos);
-            note_on_time += delta;
-            analyzeMidiEvent(midiData, pos, runningStatus, note_on_time, tpqn, bpm, outputPath1);
+    // 트랙들을 절대 tick 순서로 합쳐서 읽음 (format 1 에서 드럼이 여러 트랙에 나뉘어 있어도 순서 유지)
+    MidiTrackMerger merger(midiData);
+    int tpqn = merger.tpqn();
+    double note_on_time = 0;   // 직전 타격 이후 누적 tick
+    uint64_t prevTick = 0;
+    MidiEvent ev;
+    long events = 0;
+    while (merger.next(ev)) {
+        ++events;
+        note_on_time += static_cast<double>(ev.tick - prevTick);
+        prevTick = ev.tick;
+        if (ev.status == 0xFF) {
+            size_t pos = ev.pos;
+            handleMetaEvent(midiData, pos, bpm);
+        } else if (ev.status == 0x99) {
+            size_t pos = ev.pos;
+            handleNoteOn(midiData, pos, note_on_time, tpqn, bpm, csv);
         }
-        pos = trackEnd;
     }
+    TRACE_COUNTER("midi_events", events);
+    return true;
+}
 
+// 단계 버전: 해당 단계의 규칙/출력 형식을 바꾸면 올려서 캐시를 무효화
+const int STAGE_VER_PARSE    = 2;  // 2: 트랙 k-way merge
+const int STAGE_VER_VELOCITY = 1;
+const int STAGE_VER_ROUND    = 1;
+const int STAGE_VER_MC2C     = 1;
+const int STAGE_VER_ASSIGN   = 1;  // 병렬 배정은 직렬과 결과가 같으므로 버전 유지
+const int STAGE_VER_GROOVE   = 1;
+const int STAGE_VER_MEASURE  = 1;
+const int STAGE_VER_LATENCY  = 2;  // 2: 세기 구간을 Velfile 에서, 0.6초 넘는 간격/마디 순서 정리
+const int STAGE_VER_QUANTIZE = 1;
+
+// 변환 한 건 (CLI 한 번 실행 / 데몬 요청 하나)
+struct PipelineJob {
+    std::filesystem::path midiPath;
+    std::filesystem::path outputDir;
+    std::string fileStem;
     int use_addGroove = 0;
+    int use_quantize = 0;       // 1 이면 round 단계 대신 절대 시각 그리드 양자화 (스윙/중복 제거)
+    QuantizeConfig quantize;
+    std::string latencyTable;   // 기구 지연 보정표 (파일이 있을 때만 _lat 악보를 추가로 만듦)
+    std::string velocityFile;   // 벨로시티 요약(Velfile.txt), 지연 보정의 세기 구간용 (비어 있으면 구간 0)
+    std::string handTable;      // 손 배정 결정표 (파일이 있고 키트/규칙 버전이 맞을 때만 사용)
+};
 
+// parse 단계 메타(bpm). 비었거나 잘렸거나 숫자가 아니면 false (캐시 miss 로 처리)
+bool parseBpmMeta(const std::string& meta, int& bpm) {
+    int v = 0;
+    const char* e = meta.data() + meta.size();
+    auto res = std::from_chars(meta.data(), e, v);
+    if (res.ec != std::errc() || res.ptr != e || v <= 0) return false;
+    bpm = v;
+    return true;
+}
 
+// MIDI → output6 까지 단계 실행. velocity(bpm) 는 벨로시티 요약 단계 (CLI 는 매번, 데몬/셋리스트는 건너뜀)
+bool runPipeline(const PipelineJob& job, StageCache& cache, const std::function<void(int)>& velocity,
+                 std::string* finalPath = nullptr) {
+    TRACE_ZONE("pipeline");
+    std::string outputPath1 = job.outputDir / "output1_drum_hits_time.csv";
+    std::string outputPath2 = job.outputDir / "output2_mc.csv";
+    std::string outputPath3 = job.outputDir / "output3_mc2c.csv";
+    std::string outputPath4 = job.outputDir / "output4_hand_assign.csv";
+    std::string outputPath5 = job.outputDir / "output5_add_groove.csv";
+    std::string outputPath6 = job.outputDir / ("output6_final_" + job.fileStem + ".txt");
+    if (finalPath) *finalPath = outputPath6;
+
+    int bpm = 120; // 템포 이벤트가 없으면 MIDI 기본값
+    bool midiOk = true;
+    std::string meta;
+    cache.runStage("parse", STAGE_VER_PARSE, "", {job.midiPath}, {outputPath1},
+                   [&] { midiOk = extractDrumHits(job.midiPath, outputPath1, bpm); },
+                   &meta, [&] { return std::to_string(bpm); },
+                   [](const std::string& m) { int b; return parseBpmMeta(m, b); });
+    if (!midiOk) return false;
+    if (!parseBpmMeta(meta, bpm)) {
+        std::cerr << "bpm 메타 오류: " << job.midiPath << "\n";
+        return false;
+    }
 
-    MakeVelocitySummary(bpm,VelfileOrigin,Velfile);
+    const std::string bpmParam = "bpm=" + std::to_string(bpm);
+
+    velocity(bpm);
     //roundDurationsToStep(outputPath1, outputPath2); 
     
-    roundDurationsToStepSet100(bpm,outputPath1, outputPath2);
-    convertMcToC(outputPath2, outputPath3);
-    assignHandsToEvents(outputPath3, outputPath4);
-    addGroove(bpm, outputPath4, outputPath5);
-
-    if(use_addGroove)
+    if (job.use_quantize)
     {
-        convertToMeasureFile(outputPath5, outputPath6);
+        bool quantizeOk = true;
+        cache.runStage("quantize", STAGE_VER_QUANTIZE, bpmParam + "," + job.quantize.param(), {outputPath1}, {outputPath2},
+                       [&] { quantizeOk = quantizeToGrid(bpm, job.quantize, outputPath1, outputPath2) >= 0; });
+        if (!quantizeOk) return false;
     }
     else
     {
-        newconvertToMeasureFile(outputPath4, outputPath6);
+        cache.runStage("round", STAGE_VER_ROUND, bpmParam + ",step=0.05,target=100", {outputPath1}, {outputPath2},
+                       [&] { roundDurationsToStepSet100(bpm,outputPath1, outputPath2); });
+    }
+    cache.runStage("mc2c", STAGE_VER_MC2C, "", {outputPath2}, {outputPath3},
+                   [&] { convertMcToC(outputPath2, outputPath3); });
+    // 결정표는 분기 코드와 결과가 같으므로 캐시 키에 넣지 않음
+    cache.runStage("assign", STAGE_VER_ASSIGN, "", {outputPath3}, {outputPath4}, [&] {
+        HandDecisionTable table;
+        bool useTable = !job.handTable.empty() && table.load(job.handTable);
+        assignHandsToEvents(outputPath3, outputPath4, useTable ? &table : nullptr);
+    });
+    cache.runStage("groove", STAGE_VER_GROOVE, bpmParam, {outputPath4}, {outputPath5},
+                   [&] { addGroove(bpm, outputPath4, outputPath5); });
+
+    if(job.use_addGroove)
+    {
+        cache.runStage("measure", STAGE_VER_MEASURE, "groove=1", {outputPath5}, {outputPath6},
+                       [&] { convertToMeasureFile(outputPath5, outputPath6); });
+    }
+    else
+    {
+        cache.runStage("measure_new", STAGE_VER_MEASURE, "groove=0", {outputPath4}, {outputPath6},
+                       [&] { newconvertToMeasureFile(outputPath4, outputPath6); });
+    }
+
+    // 악보 내보내기: 악기별 지연만큼 명령을 앞당긴 악보 (타격 시각은 원래 악보와 같음)
+    if (!job.latencyTable.empty() && std::filesystem::exists(job.latencyTable)) {
+        std::string outputPath6lat = job.outputDir / ("output6_final_" + job.fileStem + "_lat.txt");
+        std::vector<std::string> inputs = {outputPath6, job.latencyTable};
+        bool useVel = !job.velocityFile.empty() && std::filesystem::exists(job.velocityFile);
+        if (useVel) inputs.push_back(job.velocityFile);
+        cache.runStage("latency", STAGE_VER_LATENCY, useVel ? "vel=1" : "vel=0", inputs, {outputPath6lat},
+                       [&] {
+                           LatencyTable table;
+                           table.load(job.latencyTable);
+                           VelocityLevels vel;
+                           applyLatencyTable(outputPath6, outputPath6lat, table,
+                                             useVel && vel.load(job.velocityFile) ? &vel : nullptr);
+                       });
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// 데몬 모드: Unix 도메인 소켓으로 변환 요청을 받아 워커 풀에서 처리
+//  - 프로세스가 계속 살아 있으므로 단계 캐시가 데워진 상태로 유지
+//    (지연 보정표를 쓰지 않으므로 벨로시티 요약은 만들지 않음)
+//  - 요청:  "DRQ1" | 파라미터 길이(u32) | MIDI 길이(u32) | 파라미터("name=...\ngroove=0\n") | MIDI 바이트
+//           (양자화: "quantize=1\ndivision=4\nswing=0.2\nstrength=1\n")
+//  - 응답:  "DRS1" | 상태(u32, 0 성공) | 길이(u32) | 악보(output6 내용) 또는 오류 메시지
+//  - 통계:  "DST1" → 같은 응답 형식으로 지연 시간 백분위 문자열
+//  - 한 연결에서 요청을 여러 번 보낼 수 있음 (UI 는 연결을 유지한 채 재요청)
+//  - 스케줄은 요청 단위: 접속 스레드가 모든 연결을 poll 해서 다 읽힌 요청만 (fd, 요청) 으로 큐에 넣고
+//    워커는 하나 처리해 답을 보낸 뒤 연결을 돌려줌 → 연결 수가 워커 수보다 많아도 모두 차례로 응답 받음
+//    (연결마다 처리 중인 요청은 하나뿐이라 답 순서는 요청 순서와 같음)
+// 정수는 같은 호스트 안에서만 쓰므로 호스트 바이트 순서 그대로 보냄
+// ---------------------------------------------------------------------------
+
+const char* DAEMON_SOCKET = "/tmp/drum_daemon.sock";
+const uint32_t DAEMON_MAX_MIDI = 64u << 20;
+
+bool readFull(int fd, void* buf, size_t n) {
+    char* p = static_cast<char*>(buf);
+    while (n > 0) {
+        ssize_t r = ::recv(fd, p, n, 0);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return false;
+        p += r;
+        n -= static_cast<size_t>(r);
+    }
+    return true;
+}
+
+bool writeFull(int fd, const void* buf, size_t n) {
+    const char* p = static_cast<const char*>(buf);
+    while (n > 0) {
+        ssize_t w = ::send(fd, p, n, MSG_NOSIGNAL);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return false;
+        p += w;
+        n -= static_cast<size_t>(w);
+    }
+    return true;
+}
+
+bool sendReply(int fd, uint32_t status, const std::string& payload) {
+    std::string msg(12 + payload.size(), '\0');
+    uint32_t len = static_cast<uint32_t>(payload.size());
+    std::memcpy(&msg[0], "DRS1", 4);
+    std::memcpy(&msg[4], &status, 4);
+    std::memcpy(&msg[8], &len, 4);
+    std::memcpy(&msg[12], payload.data(), payload.size());
+    return writeFull(fd, msg.data(), msg.size());   // 헤더와 내용을 한 번에
+}
+
+// 요청별 처리 시간 [us] 모음 → 백분위
+class LatencyStats {
+public:
+    void add(double us) {
+        std::lock_guard<std::mutex> lk(mu_);
+        samples_.push_back(us);
+    }
+
+    std::string summary() {
+        std::vector<double> v;
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            v = samples_;
+        }
+        return describe(v);
+    }
+
+    static std::string describe(std::vector<double> v) {
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(1);
+        ss << "요청 " << v.size() << "건";
+        if (v.empty()) return ss.str();
+        std::sort(v.begin(), v.end());
+        auto pct = [&](double p) { return v[std::min(v.size() - 1, static_cast<size_t>(p * v.size()))]; };
+        ss << ", p50 " << pct(0.50) << "us, p90 " << pct(0.90) << "us, p99 " << pct(0.99)
+           << "us, max " << v.back() << "us";
+        return ss.str();
+    }
+
+private:
+    std::mutex mu_;
+    std::vector<double> samples_;
+};
+
+// 연결에서 다 읽힌 요청 하나 (접속 스레드가 만들어 워커에 넘김)
+struct DaemonRequest {
+    int fd = -1;
+    bool statsOnly = false;        // "DST1"
+    std::string params;
+    std::vector<unsigned char> midi;
+};
+
+class ConversionDaemon {
+public:
+    ConversionDaemon(const std::filesystem::path& basePath, const std::string& socketPath, int workers)
+        : basePath_(basePath), socketPath_(socketPath), workers_(workers) {
+        // 작업 파일은 가능하면 메모리 파일시스템에 둠
+        std::error_code ec;
+        std::filesystem::path shm = "/dev/shm";
+        jobRoot_ = (std::filesystem::is_directory(shm, ec) ? shm : basePath_) /
+                   ("drum_daemon_" + std::to_string(::getpid()));
+    }
+
+    int run() {
+        listenFd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listenFd_ < 0) {
+            std::cerr << "소켓 생성 실패: " << std::strerror(errno) << "\n";
+            return 1;
+        }
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        if (socketPath_.size() >= sizeof(addr.sun_path)) {
+            std::cerr << "소켓 경로가 너무 김: " << socketPath_ << "\n";
+            return 1;
+        }
+        std::strcpy(addr.sun_path, socketPath_.c_str());
+        ::unlink(socketPath_.c_str());
+        if (::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || ::listen(listenFd_, 64) < 0) {
+            std::cerr << "소켓 bind/listen 실패: " << socketPath_ << " (" << std::strerror(errno) << ")\n";
+            ::close(listenFd_);
+            return 1;
+        }
+        // 워커가 연결을 돌려줄 때 poll 을 깨우는 파이프 (양쪽 다 non-blocking: 비울 때/가득 찼을 때 멈추지 않게)
+        if (::pipe2(wakePipe_, O_NONBLOCK | O_CLOEXEC) < 0) {
+            std::cerr << "파이프 생성 실패: " << std::strerror(errno) << "\n";
+            ::close(listenFd_);
+            return 1;
+        }
+
+        std::vector<std::thread> pool;
+        for (int i = 0; i < workers_; ++i) pool.emplace_back([this, i] { workerLoop(i); });
+        std::cout << "[데몬] " << socketPath_ << " 대기 중 (워커 " << workers_ << "개, 작업 폴더 " << jobRoot_ << ")\n";
+
+        std::vector<pollfd> pfds;
+        while (!stopRequested()) {
+            // 처리 중(busy)인 연결은 빼고 poll → 워커가 답을 보내는 동안 다음 요청을 읽지 않음
+            pfds.clear();
+            pfds.push_back({listenFd_, POLLIN, 0});
+            pfds.push_back({wakePipe_[0], POLLIN, 0});
+            for (const auto& c : conns_)
+                if (!c.second.busy) pfds.push_back({c.first, POLLIN, 0});
+            if (::poll(pfds.data(), pfds.size(), 200) <= 0) continue;
+
+            if (pfds[1].revents & POLLIN) takeReturned();
+            if (pfds[0].revents & POLLIN) {
+                int fd = ::accept(listenFd_, nullptr, nullptr);
+                if (fd >= 0) conns_[fd] = Conn();
+            }
+            for (size_t i = 2; i < pfds.size(); ++i) {
+                if (!pfds[i].revents) continue;
+                int fd = pfds[i].fd;
+                auto it = conns_.find(fd);
+                if (it == conns_.end() || it->second.busy) continue;
+                // 끊긴 연결도 이미 다 받은 요청은 처리하고 닫음 (보내고 바로 쓰기 쪽을 닫는 클라이언트)
+                if (!readAvailable(fd, it->second)) it->second.eof = true;
+                dispatch(fd);
+                closeIfDone(fd);
+            }
+        }
+
+        // 종료: 대기 중인 요청은 버리고, 답을 보내는 중인 연결은 끊어서 워커를 깨움
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            stopping_ = true;
+            pending_.clear();
+            for (const auto& c : conns_) ::shutdown(c.first, SHUT_RDWR);
+        }
+        cv_.notify_all();
+        for (auto& t : pool) t.join();
+        for (const auto& c : conns_) ::close(c.first);
+        conns_.clear();
+        ::close(wakePipe_[0]);
+        ::close(wakePipe_[1]);
+        ::close(listenFd_);
+        ::unlink(socketPath_.c_str());
+        std::error_code ec;
+        std::filesystem::remove_all(jobRoot_, ec);
+        std::cout << "[데몬 종료] " << stats_.summary() << "\n";
+        TRACE_DUMP((basePath_ / "trace_daemon.json").string());
+        return 0;
     }
 
+    static void requestStop(int) { stopFlag() = 1; }
+
+private:
+    // 접속 스레드만 만지는 연결 상태
+    struct Conn {
+        std::vector<unsigned char> buf;   // 아직 요청 하나가 다 안 된 바이트
+        bool busy = false;                // 워커가 이 연결의 요청을 처리 중
+        bool eof = false;                 // 클라이언트가 더 보내지 않음
+    };
+
+    static volatile std::sig_atomic_t& stopFlag() {
+        static volatile std::sig_atomic_t flag = 0;
+        return flag;
+    }
+    static bool stopRequested() { return stopFlag() != 0; }
+
+    // 와 있는 만큼만 읽음 (기다리지 않음). 연결이 끊겼으면 false
+    static bool readAvailable(int fd, Conn& c) {
+        unsigned char tmp[65536];
+        while (true) {
+            ssize_t r = ::recv(fd, tmp, sizeof(tmp), MSG_DONTWAIT);
+            if (r > 0) {
+                c.buf.insert(c.buf.end(), tmp, tmp + r);
+                if (static_cast<size_t>(r) < sizeof(tmp)) return true;
+                continue;
+            }
+            if (r < 0 && errno == EINTR) continue;
+            if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+            return false;
+        }
+    }
+
+    // 버퍼에 요청 하나가 다 모였으면 잘라서 큐에 넣음 (연결마다 한 번에 하나만 처리)
+    void dispatch(int fd) {
+        Conn& c = conns_[fd];
+        if (c.busy || c.buf.size() < 4) return;
+        DaemonRequest req;
+        req.fd = fd;
+        size_t used;
+        if (std::memcmp(c.buf.data(), "DST1", 4) == 0) {
+            req.statsOnly = true;
+            used = 4;
+        } else {
+            uint32_t hdr[2];
+            if (std::memcmp(c.buf.data(), "DRQ1", 4) != 0) {
+                sendReply(fd, 1, "잘못된 요청 헤더");
+                closeConn(fd);
+                return;
+            }
+            if (c.buf.size() < 12) return;
+            std::memcpy(hdr, c.buf.data() + 4, sizeof(hdr));
+            if (hdr[0] > 4096 || hdr[1] > DAEMON_MAX_MIDI) {
+                sendReply(fd, 1, "잘못된 요청 헤더");
+                closeConn(fd);
+                return;
+            }
+            used = 12 + static_cast<size_t>(hdr[0]) + hdr[1];
+            if (c.buf.size() < used) return;
+            const unsigned char* p = c.buf.data() + 12;
+            req.params.assign(reinterpret_cast<const char*>(p), hdr[0]);
+            req.midi.assign(p + hdr[0], p + hdr[0] + hdr[1]);
+        }
+        c.buf.erase(c.buf.begin(), c.buf.begin() + used);
+        c.busy = true;
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            pending_.push_back(std::move(req));
+        }
+        cv_.notify_one();
+    }
+
+    // 워커가 돌려준 연결: 답을 못 보냈으면 닫고, 아니면 다시 poll 대상 (이미 받아 둔 다음 요청이 있으면 바로 넣음)
+    void takeReturned() {
+        char drain[64];
+        while (::read(wakePipe_[0], drain, sizeof(drain)) > 0) {}
+        std::vector<std::pair<int, bool>> back;
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            back.swap(returned_);
+        }
+        for (const auto& r : back) {
+            auto it = conns_.find(r.first);
+            if (it == conns_.end()) continue;
+            if (!r.second) {
+                closeConn(r.first);
+                continue;
+            }
+            it->second.busy = false;
+            dispatch(r.first);
+            closeIfDone(r.first);
+        }
+    }
+
+    void closeConn(int fd) {
+        ::close(fd);
+        conns_.erase(fd);
+    }
+
+    // 끊긴 연결은 처리 중인 요청이 없을 때 닫음
+    void closeIfDone(int fd) {
+        auto it = conns_.find(fd);
+        if (it != conns_.end() && it->second.eof && !it->second.busy) closeConn(fd);
+    }
+
+    // 워커: 요청 하나 처리 → 연결을 접속 스레드에 돌려줌 (연결을 붙잡고 있지 않음)
+    void workerLoop(int id) {
+        handLogEnabled = false;
+        pipelineVerbose = false;
+        TRACE_THREAD("worker " + std::to_string(id));
+
+        std::filesystem::path dir = jobRoot_ / ("w" + std::to_string(id));
+        std::error_code ec;
+        std::filesystem::create_directories(dir, ec);
+        StageCache cache(basePath_ / "cache", 256ULL << 20);
+        cache.setVerbose(false);
+
+        while (true) {
+            DaemonRequest req;
+            {
+                std::unique_lock<std::mutex> lk(mu_);
+                cv_.wait(lk, [&] { return stopping_ || !pending_.empty(); });
+                if (stopping_) return;
+                req = std::move(pending_.front());
+                pending_.pop_front();
+            }
+            bool sent = serveRequest(req, dir, cache);
+            {
+                std::lock_guard<std::mutex> lk(mu_);
+                if (stopping_) return;
+                returned_.emplace_back(req.fd, sent);
+            }
+            char one = 1;
+            ssize_t w = ::write(wakePipe_[1], &one, 1);
+            (void)w;   // 파이프가 가득 차도 poll 은 이미 깨어 있음
+        }
+    }
+
+    // 요청 하나 처리 후 답을 보냄. 보내기에 실패하면 false (연결을 닫음)
+    bool serveRequest(const DaemonRequest& req, const std::filesystem::path& dir, StageCache& cache) {
+        if (req.statsOnly) return sendReply(req.fd, 0, stats_.summary());
+
+        TRACE_ZONE("request");
+        auto t0 = std::chrono::steady_clock::now();
+        std::string score, err;
+        bool ok = convert(req.params, req.midi, dir, cache, score, err);
+        bool sent = ok ? sendReply(req.fd, 0, score) : sendReply(req.fd, 1, err);
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+        stats_.add(us);
+        return sent;
+    }
+
+    bool convert(const std::string& params, const std::vector<unsigned char>& midi,
+                 const std::filesystem::path& dir, StageCache& cache, std::string& score, std::string& err) {
+        PipelineJob job;
+        job.fileStem = "job";
+        std::istringstream ps(params);
+        std::string kv;
+        while (std::getline(ps, kv)) {
+            size_t eq = kv.find('=');
+            if (eq == std::string::npos) continue;
+            std::string k = kv.substr(0, eq), v = kv.substr(eq + 1);
+            if (k == "name" && !v.empty() && v.find('/') == std::string::npos) job.fileStem = v;
+            else if (k == "groove") job.use_addGroove = std::atoi(v.c_str());
+            else if (k == "quantize") job.use_quantize = std::atoi(v.c_str());
+            else if (k == "division" || k == "swing" || k == "strength") {
+                // atoi/atof 는 숫자가 아니면 0 을 돌려주므로 끝까지 읽혔는지 확인
+                char* end = nullptr;
+                double x = std::strtod(v.c_str(), &end);
+                if (v.empty() || *end != '\0') {
+                    err = "양자화 파라미터가 숫자가 아님: " + kv;
+                    return false;
+                }
+                if (k == "division") job.quantize.division = (x == std::floor(x) && x > 0 && x < 64) ? static_cast<int>(x) : 0;
+                else (k == "swing" ? job.quantize.swing : job.quantize.strength) = x;
+            }
+        }
+        std::string why;
+        if (job.use_quantize && !job.quantize.valid(&why)) {
+            err = "양자화 파라미터 범위 오류: " + why;
+            return false;
+        }
+        job.outputDir = dir;
+        job.midiPath = dir / "input.mid";
+        {
+            std::ofstream f(job.midiPath, std::ios::binary | std::ios::trunc);
+            f.write(reinterpret_cast<const char*>(midi.data()), midi.size());
+            if (!f) {
+                err = "작업 파일 쓰기 실패";
+                return false;
+            }
+        }
+
+        std::string finalPath;
+        // 데몬 작업은 지연 보정표를 쓰지 않으므로 벨로시티 요약도 만들지 않음
+        //  (공유 Velfile.txt 를 덮어쓰면 같은 폴더의 CLI/다른 데몬이 읽는 도중 내용이 바뀜)
+        bool ok = runPipeline(job, cache, [](int) {}, &finalPath);
+        if (!ok || !StageCache::readAll(finalPath, score)) {
+            err = "MIDI 변환 실패";
+            return false;
+        }
+        return true;
+    }
+
+    std::filesystem::path basePath_;
+    std::string socketPath_;
+    int workers_;
+    std::filesystem::path jobRoot_;
+    int listenFd_ = -1;
+    int wakePipe_[2] = {-1, -1};
+    std::map<int, Conn> conns_;               // 접속 스레드 전용
+
+    std::mutex mu_;
+    std::condition_variable cv_;
+    std::deque<DaemonRequest> pending_;
+    std::vector<std::pair<int, bool>> returned_;   // (fd, 답 보냄) 워커 → 접속 스레드
+    bool stopping_ = false;
+
+    LatencyStats stats_;
+};
+
+// ---------------------------------------------------------------------------
+// 셋리스트 모드: 여러 곡을 한 악보로 이어 붙임
+//  - 목록 파일: 한 줄에 MIDI 파일 하나 (basePath 기준 상대 경로 가능, '#' 줄과 빈 줄은 무시)
+//  - 1) 곡 변환(MIDI → output3)은 워커 스레드에서 병렬로. 같은 단계 캐시를 쓰므로 이미 변환한 곡은 바로 끝남
+//       벨로시티 요약(Velfile.txt)은 곡마다 같은 파일을 덮어쓰므로 이 모드에서는 건너뜀
+//       → 지연 보정표가 있어도 셋리스트의 _lat 악보는 모든 명령을 세기 구간 0 으로 보정
+//         (VelfileOrigin.csv 는 한 곡의 녹음이라 곡별 세기 요약을 만들 원본이 없음)
+//  - 2) 이어 붙이기는 순서대로: 곡마다 카운트인(닫힌 하이햇 = 손 악기 5, 한 박 = 0.6초) 이벤트를 앞에 붙이고
+//       앞 곡의 마지막 손 상태를 이어받아 손 배정 → 곡 사이에 손이 엇갈려 시작하는 일이 없음
+//       악보 시간은 곡마다 100 bpm 기준으로 맞춰져 있으므로 0.6초 간격이 곧 그 곡 템포의 한 박
+//  - 곡마다 새 마디에서 시작하고 그 앞에 빈 마디(--gap)를 둠 (마디 번호는 셋리스트 전체에서 이어짐)
+//  - 출력: output/setlist_<목록 이름>/setlist_final.txt (output6 형식)
+//          output/setlist_<목록 이름>/setlist.dsl (곡 색인 + score_wire 프레임, setlist_score.hpp)
+// ---------------------------------------------------------------------------
+
+struct SetlistConfig {
+    int countInBeats = 4;
+    int gapMeasures = 1;    // 곡 사이에 넣는 빈 마디 수 (다음 곡 카운트인은 항상 마디 첫 박에서 시작)
+    int workers = 1;
+};
+
+int runSetlist(const std::filesystem::path& basePath, const std::filesystem::path& listFile, const SetlistConfig& cfg) {
+    std::filesystem::path listPath = listFile.is_absolute() ? listFile : basePath / listFile;
+    std::ifstream list(listPath);
+    if (!list) {
+        std::cerr << "셋리스트 파일 열기 실패: " << listPath << "\n";
+        return 1;
+    }
+    std::vector<std::filesystem::path> songs;
+    std::string line;
+    while (std::getline(list, line)) {
+        line.erase(0, line.find_first_not_of(" \t"));
+        line.erase(line.find_last_not_of(" \t\r") + 1);
+        if (line.empty() || line[0] == '#') continue;
+        std::filesystem::path p = line;
+        songs.push_back(p.is_absolute() ? p : basePath / p);
+    }
+    if (songs.empty()) {
+        std::cerr << "셋리스트가 비어 있음: " << listPath << "\n";
+        return 1;
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<int> bpms(songs.size(), 0);
+    std::vector<char> ok(songs.size(), 0);
+    std::atomic<size_t> next{0};
+    auto worker = [&]([[maybe_unused]] int id) {   // id 는 TRACE_THREAD 에서만 씀
+        handLogEnabled = false;
+        pipelineVerbose = false;
+        TRACE_THREAD("setlist " + std::to_string(id));
+        StageCache cache(basePath / "cache", 256ULL << 20);
+        cache.setVerbose(false);
+        for (size_t i; (i = next++) < songs.size();) {
+            PipelineJob job;
+            job.midiPath = songs[i];
+            job.fileStem = songs[i].stem().string();
+            job.outputDir = basePath / "output" / job.fileStem;
+            std::error_code ec;
+            std::filesystem::create_directories(job.outputDir, ec);
+            job.latencyTable = basePath / "latency_table.txt";   // velocityFile 없음 → 세기 구간 0 (모드 설명 참고)
+            job.handTable = basePath / "hand_table.bin";
+            ok[i] = runPipeline(job, cache, [&](int bpm) { bpms[i] = bpm; });
+        }
+    };
+    int n = std::max(1, std::min<int>(cfg.workers, static_cast<int>(songs.size())));
+    std::vector<std::thread> pool;
+    for (int w = 1; w < n; ++w) pool.emplace_back(worker, w);
+    worker(0);
+    for (auto& t : pool) t.join();
+    double convertMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    for (size_t i = 0; i < songs.size(); ++i)
+        if (!ok[i]) {
+            std::cerr << "곡 변환 실패: " << songs[i] << "\n";
+            return 1;
+        }
+
+    // 카운트인 + 곡 이벤트 → 손 상태를 이어 가며 줄 만들기
+    t0 = std::chrono::steady_clock::now();
+    constexpr double BEAT = 0.6;     // 100 bpm 기준 한 박
+    constexpr double MEASURE = 2.4;
+    const double gap = cfg.gapMeasures * MEASURE;
+    std::vector<ScoreRow> all;
+    SetlistScoreWriter bin;
+    auto toWire = [](const ScoreRow& r) {
+        return WireRow{r.measure, wireDtMs(r.dt), (uint8_t)r.R, (uint8_t)r.L, (uint8_t)r.Rp, (uint8_t)r.Lp,
+                       (uint8_t)r.bass, (uint8_t)r.hihat};
+    };
+    bin.add(toWire(ScoreRow{1, BEAT, 0, 0, 0, 0, 0, 0}));   // 텍스트 악보 선두 줄
+    HandState hand;
+    int measureBase = 0, trailerMeasure = 1;
+    for (size_t i = 0; i < songs.size(); ++i) {
+        std::vector<FullEvent> events, songEvents;
+        if (!IncrementalScore::readEvents((basePath / "output" / songs[i].stem() / "output3_mc2c.csv").string(), songEvents))
+            return 1;
+        for (int k = 0; k < cfg.countInBeats; ++k) {
+            FullEvent e;
+            e.time = (k == 0 && i > 0) ? gap + BEAT : BEAT;
+            e.inst1 = 5;      // 닫힌 하이햇(노트 11)은 convertMcToC 처럼 손 악기 5 + 하이햇 닫힘
+            e.hihat = 1;
+            events.push_back(e);
+        }
+        if (!songEvents.empty() && (cfg.countInBeats > 0 || i > 0))
+            songEvents[0].time += cfg.countInBeats > 0 ? BEAT : gap;
+        events.insert(events.end(), songEvents.begin(), songEvents.end());
+
+        IncrementalScore score;
+        score.build(events, hand);
+        hand = score.finalHand();
+
+        SetlistSong entry;
+        entry.name = songs[i].stem().string();
+        entry.bpm = static_cast<uint32_t>(bpms[i]);
+        entry.countInRows = static_cast<uint32_t>(score.rowsBefore(std::min<size_t>(cfg.countInBeats, events.size())));
+        entry.firstMeasure = measureBase + 1;
+        bin.beginSong(entry);
+        for (ScoreRow r : score.rows()) {
+            r.measure += measureBase;
+            all.push_back(r);
+            bin.add(toWire(r));
+        }
+        trailerMeasure = measureBase + score.lastMeasure();
+        if (!all.empty()) measureBase = all.back().measure;
+    }
+    bin.beginTrailer();
+    bin.add(toWire(ScoreRow{trailerMeasure + 1, BEAT, 0, 0, 0, 0, 0, 0}));
+    bin.add(toWire(ScoreRow{-1, BEAT, 1, 1, 1, 1, 1, 1}));
+
+    std::filesystem::path outDir = basePath / "output" / ("setlist_" + listPath.stem().string());
+    std::filesystem::create_directories(outDir);
+    std::ofstream text(outDir / "setlist_final.txt", std::ios::trunc);
+    if (!text) {
+        std::cerr << "출력 파일 생성 실패: " << outDir / "setlist_final.txt" << "\n";
+        return 1;
+    }
+    writeScoreText(text, all, trailerMeasure);
+    text.close();
+    if (!bin.write((outDir / "setlist.dsl").string())) return 1;
+    double compileMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    // 바이너리를 다시 읽어 곡마다 따로 디코딩한 줄이 텍스트 악보의 같은 범위와 같은지 확인
+    SetlistScoreReader check;
+    bool same = check.open((outDir / "setlist.dsl").string()) && check.songs().size() == songs.size();
+    for (size_t i = 0; same && i < check.songs().size(); ++i) {
+        const SetlistSong& s = check.songs()[i];
+        size_t k = s.firstRow - 1;   // all 에는 선두 줄이 없음
+        size_t decoded = 0;
+        check.decodeSong(i, [&](const WireRow& r) {
+            same = same && k < all.size() && r == toWire(all[k]);
+            ++k;
+            ++decoded;
+        });
+        same = same && decoded == s.rowCount;
+    }
+
+    std::cout << std::fixed << std::setprecision(1);
+    for (const auto& s : bin.songs())
+        std::cout << "[곡] " << s.name << ": " << s.bpm << " bpm, 마디 " << s.firstMeasure << "~, 줄 " << s.firstRow
+                  << "~" << s.firstRow + s.rowCount - 1 << " (빈 마디/카운트인 " << s.countInRows << "줄), 시작 "
+                  << s.startMs / 1000.0 << " s\n";
+    std::cout << "[요약] " << songs.size() << "곡 → " << bin.rows() << "줄, " << trailerMeasure << "마디, 변환 "
+              << convertMs << " ms (워커 " << n << "), 이어 붙이기 " << compileMs << " ms → " << outDir.string()
+              << "/setlist_final.txt, setlist.dsl\n";
+    if (!same) {
+        std::cerr << "[확인] setlist.dsl 곡별 디코딩 결과가 텍스트 악보와 다름\n";
+        return 2;
+    }
+    return 0;
+}
+
+// 데몬에 MIDI 파일을 보내고 악보를 받음 (지연 시간 측정용으로 여러 번 반복 가능)
+int runClient(const std::string& socketPath, const std::string& midiFile, int repeat, bool askStats) {
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+    if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        std::cerr << "데몬 연결 실패: " << socketPath << "\n";
+        return 1;
+    }
+
+    auto receive = [&](uint32_t& status, std::string& payload) {
+        char hdr[12];
+        if (!readFull(fd, hdr, 12) || std::memcmp(hdr, "DRS1", 4) != 0) return false;
+        uint32_t len;
+        std::memcpy(&status, hdr + 4, 4);
+        std::memcpy(&len, hdr + 8, 4);
+        payload.resize(len);
+        return readFull(fd, payload.data(), len);
+    };
+
+    uint32_t status = 0;
+    std::string payload;
+    if (!midiFile.empty()) {
+        std::vector<unsigned char> midi;
+        if (!readMidiFile(midiFile, midi)) return 1;
+        std::string name = std::filesystem::path(midiFile).stem().string();
+        std::string params = "name=" + name + "\ngroove=0\n";
+        std::string req(12, '\0');
+        uint32_t hdr[2] = {static_cast<uint32_t>(params.size()), static_cast<uint32_t>(midi.size())};
+        std::memcpy(&req[0], "DRQ1", 4);
+        std::memcpy(&req[4], hdr, sizeof(hdr));
+        req += params;
+        req.append(reinterpret_cast<const char*>(midi.data()), midi.size());
+
+        std::vector<double> rtt;
+        rtt.reserve(repeat);
+        for (int i = 0; i < repeat; ++i) {
+            auto t0 = std::chrono::steady_clock::now();
+            if (!writeFull(fd, req.data(), req.size()) || !receive(status, payload)) {
+                std::cerr << "데몬 응답 없음\n";
+                return 1;
+            }
+            rtt.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count());
+            if (status != 0) {
+                std::cerr << "변환 실패: " << payload << "\n";
+                return 2;
+            }
+        }
+        std::cout << payload;
+        std::cerr << "[클라이언트 왕복] " << LatencyStats::describe(rtt) << "\n";
+    }
+    if (askStats) {
+        if (!writeFull(fd, "DST1", 4) || !receive(status, payload)) return 1;
+        std::cerr << "[데몬 처리 시간] " << payload << "\n";
+    }
+    ::close(fd);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    std::filesystem::path basePath = "/home/taehwang/basic-algo-lecture-master/drum_roobt/mmiiddii/";
+
+    // 인자가 있으면 데몬/클라이언트 모드
+    //   midi_final --daemon[=소켓] [--workers=N]
+    //   midi_final --client[=소켓] [--repeat=N] [--stats] [파일.mid]
+    //   midi_final --setlist=목록.txt [--countin=4] [--gap=1] [--workers=N]
+    if (argc > 1) {
+        std::string socketPath = DAEMON_SOCKET;
+        std::string midiFile;
+        bool daemon = false, client = false, askStats = false;
+        int workers = std::max(1u, std::thread::hardware_concurrency());
+        int repeat = 1;
+        std::string setlist;
+        SetlistConfig setlistCfg;
+        for (int i = 1; i < argc; ++i) {
+            std::string a = argv[i];
+            if (a.rfind("--daemon", 0) == 0 || a.rfind("--client", 0) == 0) {
+                (a[2] == 'd' ? daemon : client) = true;
+                if (a.size() > 8 && a[8] == '=') socketPath = a.substr(9);
+            }
+            else if (a.rfind("--workers=", 0) == 0) workers = std::max(1, std::atoi(a.c_str() + 10));
+            else if (a.rfind("--repeat=", 0) == 0) repeat = std::max(1, std::atoi(a.c_str() + 9));
+            else if (a == "--stats") askStats = true;
+            else if (a.rfind("--setlist=", 0) == 0) setlist = a.substr(10);
+            else if (a.rfind("--countin=", 0) == 0) setlistCfg.countInBeats = std::max(0, std::atoi(a.c_str() + 10));
+            else if (a.rfind("--gap=", 0) == 0) setlistCfg.gapMeasures = std::max(0, std::atoi(a.c_str() + 6));
+            else midiFile = a;
+        }
+        if (daemon) {
+            std::signal(SIGINT, ConversionDaemon::requestStop);
+            std::signal(SIGTERM, ConversionDaemon::requestStop);
+            std::signal(SIGPIPE, SIG_IGN);
+            ConversionDaemon d(basePath, socketPath, workers);
+            return d.run();
+        }
+        if (client) return runClient(socketPath, midiFile, repeat, askStats);
+        if (!setlist.empty()) {
+            setlistCfg.workers = workers;
+            int rc = runSetlist(basePath, setlist, setlistCfg);
+            TRACE_DUMP((basePath / "trace_setlist.json").string());
+            return rc;
+        }
+        std::cerr << "사용법: midi_final [--daemon[=소켓] [--workers=N] | --client[=소켓] [--repeat=N] [--stats] 파일.mid |\n"
+                     "                   --setlist=목록.txt [--countin=4] [--gap=1] [--workers=N]]\n";
+        return 1;
+    }
+
+    std::string filename;
+    std::cout << "읽을 MIDI 파일 이름을 입력하세요 (예: input0.mid): ";
+    std::cin >> filename;
+
+    PipelineJob job;
+    job.midiPath = basePath / filename;
+    job.fileStem = filename.substr(0, filename.find_last_of('.'));  // ex: "input0"
+    job.outputDir = basePath / "output" / job.fileStem;
+    std::filesystem::create_directories(job.outputDir);
+    job.use_addGroove = 0;
+    job.use_quantize = 0;
+    job.latencyTable = basePath / "latency_table.txt";
+    job.handTable = basePath / "hand_table.bin";
+    
+    std::string VelfileOrigin = basePath / "VelfileOrigin.csv";
+    std::string Velfile       = basePath / "Velfile.txt";
+    job.velocityFile = Velfile;
+    
+    // 단계 결과 캐시 (입력 내용 + 단계 버전 + 파라미터가 같으면 재계산하지 않음)
+    StageCache cache(basePath / "cache", 256ULL << 20);
+
+    auto velocity = [&](int bpm) {
+        cache.runStage("velocity", STAGE_VER_VELOCITY, "bpm=" + std::to_string(bpm), {VelfileOrigin}, {Velfile},
+                       [&] { MakeVelocitySummary(bpm,VelfileOrigin,Velfile); });
+    };
+    if (!runPipeline(job, cache, velocity)) return 1;
+
+    cache.printStats();
+    TRACE_DUMP((job.outputDir / "trace.json").string());
     
     return 0;
 }
@@ -0,0 +1,139 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+#include "../common/text_reader.hpp"
+#include "../common/motion_onset.hpp"
+
+// 최종 악보(output6_final_*.txt)에 손별 이동 시작 시점 표시
+//  - 출력: 원래 8열 + beginR beginL late  (begin = 타격 몇 초 전에 움직이기 시작해야 하는지, late = 1 R / 2 L / 3 양손)
+//  - late 가 있으면 직전 타격 전에 이미 움직여야 한다는 뜻 → 목록 출력 후 종료 코드 2 (score_check 와 같은 규칙)
+//
+// 빌드:   g++ -std=gnu++17 -O3 -fno-math-errno -fno-trapping-math -o motion_onset main.cpp
+// 사용법: ./motion_onset [--vmax=4.0] [--amax=30] [--lift=0.0] [--quiet] 파일...
+
+struct OnsetConfig {
+    MotionProfile prof;
+    bool quiet = false;
+};
+
+struct ScoreLines {
+    std::vector<std::string> text;   // 원래 줄 (앞 8열 그대로 다시 씀)
+    std::vector<int> measure, R, L;
+    std::vector<double> t;
+};
+
+bool loadScoreLines(const std::string& file, ScoreLines& s, std::string& endLine) {
+    TextReader in(file);
+    if (!in.is_open()) {
+        std::cerr << "입력 파일 열기 실패: " << file << "\n";
+        return false;
+    }
+    std::string_view line, f[8];
+    double t = 0.0;
+    while (in.nextLine(line)) {
+        if (splitFields(line, f, 8) < 8) continue;
+        int measure, R, L;
+        double dt;
+        if (!toInt(f[0], measure) || !toDouble(f[1], dt) || !toInt(f[2], R) || !toInt(f[3], L)) continue;
+        if (measure == -1) {
+            endLine = std::string(line);
+            break;
+        }
+        t += dt;
+        s.text.emplace_back(line);
+        s.measure.push_back(measure);
+        s.R.push_back(R);
+        s.L.push_back(L);
+        s.t.push_back(t);
+    }
+    return true;
+}
+
+// 반환값: 0 통과, 1 파일 오류, 2 늦은 이동 있음
+int annotate(const std::string& file, const OnsetConfig& cfg) {
+    ScoreLines s;
+    std::string endLine;
+    if (!loadScoreLines(file, s, endLine)) return 1;
+
+    auto t0 = std::chrono::steady_clock::now();
+    MotionPlan plan;
+    planMotion(s.t, s.R, s.L, cfg.prof, plan);
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+
+    size_t dot = file.find_last_of('.');
+    std::string out = (dot == std::string::npos ? file : file.substr(0, dot)) + "_motion.txt";
+    std::ofstream o(out);
+    if (!o.is_open()) {
+        std::cerr << "출력 파일 생성 실패: " << out << "\n";
+        return 1;
+    }
+
+    std::cout << std::fixed << std::setprecision(3);
+    o << std::fixed << std::setprecision(3);
+    int late = 0;
+    float worst = 0.0f;
+    for (size_t i = 0; i < s.text.size(); ++i) {
+        o << s.text[i] << "\t " << plan.leadR[i] << "\t " << plan.leadL[i] << "\t " << (int)plan.flags[i] << "\n";
+        if (!plan.flags[i]) continue;
+        ++late;
+        for (int h = 0; h < 2; ++h) {
+            if (!(plan.flags[i] & (h ? MOTION_LATE_L : MOTION_LATE_R))) continue;
+            float slack = h ? plan.slackL[i] : plan.slackR[i];
+            if (slack < worst) worst = slack;
+            if (!cfg.quiet)
+                std::cout << file << ": measure " << s.measure[i] << " row " << i + 1 << " " << (h ? "L" : "R")
+                          << " 이동 시작이 직전 타격보다 " << -slack << "s 빠름 (이동 " << (h ? plan.leadL[i] : plan.leadR[i])
+                          << "s, 악기 " << (h ? s.L[i] : s.R[i]) << ")\n";
+        }
+    }
+    if (!endLine.empty()) o << endLine << "\t 0.000\t 0.000\t 0\n";
+
+    std::cout << "[요약] " << file << " → " << out << "\n"
+              << "  줄 수: " << s.text.size() << ", 계산 " << us << " us\n"
+              << "  늦은 이동: " << late << "줄" << (late ? ", 최대 " + std::to_string(-worst) + "s" : std::string())
+              << (late ? "  → FAIL" : "  → OK") << "\n";
+    return late ? 2 : 0;
+}
+
+int main(int argc, char** argv) {
+    std::ios::sync_with_stdio(false);
+
+    OnsetConfig cfg;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        if (std::strncmp(a, "--vmax=", 7) == 0) cfg.prof.vmax = std::atof(a + 7);
+        else if (std::strncmp(a, "--amax=", 7) == 0) cfg.prof.amax = std::atof(a + 7);
+        else if (std::strncmp(a, "--lift=", 7) == 0) cfg.prof.lift = std::atof(a + 7);
+        else if (std::strcmp(a, "--quiet") == 0) cfg.quiet = true;
+        else files.push_back(a);
+    }
+    if (cfg.prof.vmax <= 0 || cfg.prof.amax <= 0) {
+        std::cerr << "vmax/amax 는 0보다 커야 함\n";
+        return 1;
+    }
+
+    if (files.empty()) {
+        std::string file;
+        std::cout << "악보 파일 경로: ";
+        std::cin >> file;
+        files.push_back(file);
+    }
+
+    int result = 0;
+    int failed = 0;
+    for (const auto& f : files) {
+        int r = annotate(f, cfg);
+        if (r != 0) failed++;
+        if (r > result) result = r;
+    }
+    if (files.size() > 1)
+        std::cout << "[전체] " << files.size() << "곡 중 " << failed << "곡 실패\n";
+    return result;
+}
@@ -0,0 +1,122 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+#include "../common/practice_speed.hpp"
+#include "../common/trace.hpp"
+
+// 연습 속도 악보 만들기 (output6 → 같은 형식, 속도만 바꿈)
+//  - --speed=85           곡 전체 85% 속도
+//  - --schedule=9:70,17:100  마디 번호:속도 (해당 마디부터 적용)
+//  - --live               디스패처처럼 마디 단위로 만들어 실제 시간에 맞춰 줄을 내보냄
+//                         실행 중 표준 입력으로 속도(예: 70)를 넣으면 다음 마디부터 바뀜 (--fast 면 기다리지 않음)
+//
+// 사용법: ./practice [--speed=100] [--schedule=...] [--live [--fast]] [--out=파일] output6_final_*.txt
+
+std::map<int, int> parseSchedule(const char* s) {
+    std::map<int, int> m;
+    while (*s) {
+        char* end;
+        long measure = std::strtol(s, &end, 10);
+        if (*end != ':') break;
+        long pct = std::strtol(end + 1, &end, 10);
+        m[(int)measure] = (int)pct;
+        if (*end != ',') break;
+        s = end + 1;
+    }
+    return m;
+}
+
+// 디스패처 흉내: 마디를 하나씩 만들어 줄 간격만큼 기다리며 출력
+void runLive(const TickScore& score, PracticeRenderer& renderer, bool fast) {
+    std::atomic<bool> done{false};
+    std::thread dispatcher([&] {
+        TRACE_THREAD("dispatcher");
+        std::vector<TickRow> rows;
+        int pct;
+        while (true) {
+            rows.clear();
+            {
+                TRACE_ZONE("render_measure");
+                if (!renderer.renderMeasure(rows, &pct)) break;
+            }
+            TRACE_COUNTER("speed", pct);
+            std::cout << "[마디 " << (rows.empty() ? 0 : rows.front().measure) << "] 속도 " << pct << "%\n";
+            for (const auto& r : rows) {
+                if (!fast)
+                    std::this_thread::sleep_for(std::chrono::duration<double>(r.dt * PRACTICE_TICK_SEC));
+                writeTickRow(std::cout, r);
+            }
+            std::cout.flush();
+        }
+        if (score.hasEnd) writeTickRow(std::cout, score.end);
+        std::cout << "[끝] 연주 완료 (속도 입력 종료: Ctrl+D)\n";
+        done = true;
+    });
+
+    // 표준 입력으로 속도 변경
+    int pct;
+    while (!done && std::cin >> pct) {
+        renderer.setSpeed(pct);
+        std::cout << "[속도 변경 요청] " << renderer.speed() << "% (다음 마디부터)\n";
+    }
+    dispatcher.join();
+    TRACE_DUMP("practice_trace.json");
+}
+
+int main(int argc, char** argv) {
+    int speed = 100;
+    std::map<int, int> schedule;
+    bool live = false, fast = false;
+    std::string out, file;
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        if (std::strncmp(a, "--speed=", 8) == 0) speed = std::atoi(a + 8);
+        else if (std::strncmp(a, "--schedule=", 11) == 0) schedule = parseSchedule(a + 11);
+        else if (std::strncmp(a, "--out=", 6) == 0) out = a + 6;
+        else if (std::strcmp(a, "--live") == 0) live = true;
+        else if (std::strcmp(a, "--fast") == 0) fast = true;
+        else file = a;
+    }
+    if (file.empty()) {
+        std::cout << "악보 파일 경로: ";
+        std::cin >> file;
+    }
+
+    TickScore score;
+    if (!score.load(file)) return 1;
+    PracticeRenderer renderer(score, speed);
+
+    std::cout << std::fixed << std::setprecision(3);
+    if (live) {
+        runLive(score, renderer, fast);
+        return 0;
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<TickRow> rows;
+    rows.reserve(score.rows.size() * 2);
+    for (size_t m = 0; m < score.measureCount(); ++m) {
+        auto it = schedule.find(score.rows[score.measureBegin[m]].measure);
+        if (it != schedule.end()) renderer.setSpeed(it->second);
+        renderer.renderMeasure(rows);
+    }
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+
+    if (out.empty()) {
+        size_t dot = file.find_last_of('.');
+        std::string tag = schedule.empty() ? "_s" + std::to_string(renderer.speed()) : "_sched";
+        out = (dot == std::string::npos ? file : file.substr(0, dot)) + tag + ".txt";
+    }
+    if (!writePracticeScore(score, rows, out)) return 1;
+
+    std::cout << "[완료] " << out << " (마디 " << score.measureCount() << "개, 줄 " << score.rows.size()
+              << " → " << rows.size() << ", " << us << " us)\n";
+    return 0;
+}
@@ -0,0 +1,232 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include "../common/text_reader.hpp"
+#include "../common/smf_writer.hpp"
+#include "../common/midi_merge.hpp"
+
+// 손 배정이 끝난 악보 → MIDI 파일 (들어보기 / 원본과 비교용)
+//  - 입력: output4_hand_assign.csv (dt R L Rpow Lpow bass hihat) 또는
+//          output6_final_*.txt (measure dt R L Rpow Lpow bass hihat, measure == -1 이면 종료 줄)
+//  - 악기 번호 → GM 드럼 노트 (midi_final.cpp 의 save_to_csv 매핑의 역방향)
+//  - format 1: 0번 템포/박자, 1번 오른손, 2번 왼손, 3번 발(베이스) 트랙 (모두 GM 드럼 채널 10)
+//    format 0: 한 트랙이라 손은 채널로 구분 → 오른손/발 채널 10, 왼손 채널 11
+//    (GM 재생기는 채널 11 을 드럼으로 치지 않으므로 들을 때는 DAW 에서 채널 11 도 드럼 킷으로 지정)
+//  - --verify: 만든 MIDI 를 MidiTrackMerger 로 다시 읽어서 (tick, 채널, 노트) 목록이 같은지 확인 → 다르면 종료 코드 2
+//
+// 사용법: ./score2midi [--bpm=120] [--tpqn=480] [--format=1] [--verify] [--out=파일] 악보...
+
+struct ConvertConfig {
+    double bpm = 120.0;
+    int tpqn = 480;
+    int format = 1;
+    bool verify = false;
+    std::string out;          // 비어 있으면 입력 파일명의 확장자를 .mid 로
+};
+
+const int GM_CHANNEL = 9;     // GM 드럼 채널 (10번)
+const int LEFT_CHANNEL_F0 = 10;   // format 0 에서 왼손 채널 (11번)
+
+// 악기 번호 → GM 노트 (5번 하이햇은 hihat 열 상태로 닫힘/열림 구분)
+int instToNote(int inst, int hihat) {
+    switch (inst) {
+        case 1: return 38;                    // 스네어
+        case 2: return 41;                    // 플로어 탐
+        case 3: return 45;                    // 미드 탐
+        case 4: return 47;                    // 하이 탐
+        case 5: return hihat ? 42 : 46;       // 하이햇 (닫힘 / 열림)
+        case 6: return 51;                    // 라이드 벨
+        case 7: return 57;                    // 오른쪽 크래시
+        case 8: return 49;                    // 왼쪽 크래시
+        case 10: return 36;                   // 베이스
+        default: return 0;
+    }
+}
+
+// 세기 열: 손 배정 직후에는 0/1 표시, 세기 반영 후에는 3/5/7
+int powerToVelocity(int power) {
+    if (power <= 1) return 100;
+    return std::min(127, power * 18);
+}
+
+struct ScoreRow {
+    double time;              // 곡 시작부터 누적 시간 [s]
+    int R, L, Rpow, Lpow, bass, hihat;
+};
+
+bool loadScore(const std::string& file, std::vector<ScoreRow>& rows) {
+    TextReader in(file);
+    if (!in.is_open()) {
+        std::cerr << "입력 파일 열기 실패: " << file << "\n";
+        return false;
+    }
+    std::string_view line, f[8];
+    double t = 0.0;
+    while (in.nextLine(line)) {
+        int n = splitFields(line, f, 8);
+        if (n < 7) continue;
+        int c = 0;
+        if (n >= 8) {                          // output6: 앞에 measure 열
+            int measure;
+            if (!toInt(f[0], measure)) continue;
+            if (measure == -1) break;
+            c = 1;
+        }
+        double dt;
+        ScoreRow r;
+        if (!toDouble(f[c], dt) || !toInt(f[c+1], r.R) || !toInt(f[c+2], r.L) || !toInt(f[c+3], r.Rpow) ||
+            !toInt(f[c+4], r.Lpow) || !toInt(f[c+5], r.bass) || !toInt(f[c+6], r.hihat)) continue;
+        t += dt;
+        r.time = t;
+        rows.push_back(r);
+    }
+    return true;
+}
+
+struct NoteKey {
+    uint64_t tick;
+    int channel;
+    int note;
+    bool operator<(const NoteKey& o) const {
+        if (tick != o.tick) return tick < o.tick;
+        return channel != o.channel ? channel < o.channel : note < o.note;
+    }
+    bool operator==(const NoteKey& o) const { return tick == o.tick && channel == o.channel && note == o.note; }
+};
+
+// 만든 버퍼를 다시 해석해서 노트 켜기 목록 비교. 반환값: 다른 노트 개수
+size_t verifyRoundTrip(const std::vector<unsigned char>& buf, std::vector<NoteKey> expected) {
+    MidiTrackMerger merger(buf);
+    MidiEvent ev;
+    std::vector<NoteKey> got;
+    got.reserve(expected.size());
+    while (merger.next(ev)) {
+        if ((ev.status & 0xF0) == 0x90 && ev.len == 2 && buf[ev.pos + 1] > 0)
+            got.push_back({ev.tick, ev.status & 0x0F, buf[ev.pos]});
+    }
+    std::sort(expected.begin(), expected.end());
+    std::sort(got.begin(), got.end());
+    if (got == expected) return 0;
+    size_t same = 0;
+    for (size_t i = 0, j = 0; i < expected.size() && j < got.size();) {
+        if (expected[i] == got[j]) { ++same; ++i; ++j; }
+        else if (expected[i] < got[j]) ++i;
+        else ++j;
+    }
+    return std::max(expected.size(), got.size()) - same;
+}
+
+// 반환값: 0 성공, 1 파일 오류, 2 round-trip 불일치
+int convertScore(const std::string& file, const ConvertConfig& cfg, size_t& bytesOut) {
+    std::vector<ScoreRow> rows;
+    if (!loadScore(file, rows)) return 1;
+
+    std::string out = cfg.out;
+    if (out.empty()) {
+        size_t dot = file.find_last_of('.');
+        out = (dot == std::string::npos ? file : file.substr(0, dot)) + ".mid";
+    }
+
+    SmfWriter smf(cfg.tpqn, cfg.format);
+    smf.setTempo(0, cfg.bpm);
+    smf.setTimeSignature(0, 4, 4);
+    int trR = smf.addTrack("R");
+    int trL = smf.addTrack("L");
+    int trF = smf.addTrack("Foot");
+
+    const double ticksPerSec = cfg.bpm / 60.0 * cfg.tpqn;
+    const uint32_t noteLen = std::max(1, cfg.tpqn / 8);   // 32분음표 길이로 끄기
+    std::vector<NoteKey> expected;
+    expected.reserve(rows.size() * 3);
+
+    for (size_t i = 0; i < rows.size(); ++i) {
+        const ScoreRow& r = rows[i];
+        uint64_t tick = static_cast<uint64_t>(std::llround(r.time * ticksPerSec));
+        // 다음 줄 전에 끄기 (같은 노트를 바로 다시 칠 때 겹치지 않게)
+        uint32_t dur = noteLen;
+        if (i + 1 < rows.size()) {
+            uint64_t next = static_cast<uint64_t>(std::llround(rows[i + 1].time * ticksPerSec));
+            if (next > tick) dur = static_cast<uint32_t>(std::min<uint64_t>(dur, next - tick));
+        }
+
+        auto hit = [&](int track, int channel, int inst, int power) {
+            int note = instToNote(inst, r.hihat);
+            if (note == 0) return;
+            smf.addNote(track, tick, channel, note, powerToVelocity(power), dur);
+            expected.push_back({tick, channel, note});
+        };
+        if (r.R) hit(trR, GM_CHANNEL, r.R, r.Rpow);
+        if (r.L) hit(trL, cfg.format == 0 ? LEFT_CHANNEL_F0 : GM_CHANNEL, r.L, r.Lpow);
+        if (r.bass) hit(trF, GM_CHANNEL, 10, 1);
+    }
+
+    if (!smf.writeFile(out)) {
+        std::cerr << "출력 파일 생성 실패: " << out << "\n";
+        return 1;
+    }
+    bytesOut += smf.buffer().size();
+    std::cout << file << " → " << out << " (노트 " << smf.noteCount() << "개, " << smf.buffer().size() << " bytes)\n";
+
+    if (cfg.verify) {
+        size_t diff = verifyRoundTrip(smf.buffer(), expected);
+        if (diff) {
+            std::cout << "  round-trip 불일치: " << diff << "개 노트\n";
+            return 2;
+        }
+        std::cout << "  round-trip OK\n";
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    std::ios::sync_with_stdio(false);
+
+    ConvertConfig cfg;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        if (std::strncmp(a, "--bpm=", 6) == 0) cfg.bpm = std::atof(a + 6);
+        else if (std::strncmp(a, "--tpqn=", 7) == 0) cfg.tpqn = std::atoi(a + 7);
+        else if (std::strncmp(a, "--format=", 9) == 0) cfg.format = std::atoi(a + 9);
+        else if (std::strncmp(a, "--out=", 6) == 0) cfg.out = a + 6;
+        else if (std::strcmp(a, "--verify") == 0) cfg.verify = true;
+        else files.push_back(a);
+    }
+    // bpm 은 템포 이벤트의 24비트 us 에 들어가야 함 (SMF_MIN_BPM ~ SMF_MAX_BPM)
+    if (!(cfg.bpm >= SMF_MIN_BPM && cfg.bpm <= SMF_MAX_BPM) || cfg.tpqn <= 0 || cfg.tpqn > 0x7FFF) {
+        std::cerr << "잘못된 bpm/tpqn\n";
+        return 1;
+    }
+
+    if (files.empty()) {
+        std::string file;
+        std::cout << "변환할 악보 파일 경로: ";
+        std::cin >> file;
+        files.push_back(file);
+    }
+    if (files.size() > 1 && !cfg.out.empty()) {
+        std::cerr << "--out 은 파일 하나일 때만 사용 가능\n";
+        return 1;
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    int result = 0;
+    int failed = 0;
+    size_t bytes = 0;
+    for (const auto& f : files) {
+        int r = convertScore(f, cfg, bytes);
+        if (r != 0) failed++;
+        if (r > result) result = r;
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    if (files.size() > 1)
+        std::cout << "[전체] " << files.size() << "곡 중 " << failed << "곡 실패, "
+                  << bytes << " bytes, " << ms << " ms\n";
+    return result;
+}
@@ -0,0 +1,197 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <iomanip>
+#include <cstdlib>
+#include <cstring>
+
+#include "../common/drum_kit.hpp"
+
+// 최종 악보(output6_final_*.txt) 물리적 연주 가능 여부 검사
+//  - 한 줄 형식: measure  dt  R  L  Rpow  Lpow  bass  hihat   (measure == -1 이면 종료 줄)
+//  - 한 줄씩 흘려보내면서 손마다 직전 타격만 기억 → 곡 길이에 선형 시간, 상수 메모리
+//  - 위반이 하나라도 있으면 종료 코드 2 → 일괄 변환 스크립트에서 게이트로 사용
+//
+// 사용법: ./score_check [--min-gap=0.075] [--vmax=4.0] [--allow-dual-crash] [--quiet] 파일...
+
+struct CheckConfig {
+    double minGap = 0.075;        // 같은 손 최소 재타격 간격 [s]
+    double maxSpeed = 4.0;        // 스틱 최대 이동 속도 [m/s]
+    bool allowDualCrash = false;  // 양손 동시 크래시 허용 여부
+    bool quiet = false;           // 위반 목록 없이 요약만 출력
+};
+
+struct HandTrack {
+    const char* name;
+    int lastInst = 1;             // assignHandsToEvents 와 같이 스네어 위치에서 시작
+    double lastTime = 0.0;
+    bool hasHit = false;          // 실제로 친 적이 있는지 (재타격 간격은 첫 타격 이후부터)
+    double tightestGap = 1e9;
+    int tightestMeasure = 0, tightestRow = 0;
+    int hits = 0;
+};
+
+struct SongReport {
+    int rows = 0;
+    double duration = 0.0;
+    double peakSpeed = 0.0;
+    int peakMeasure = 0, peakRow = 0;
+    const char* peakHand = "-";
+    int gapViolations = 0, speedViolations = 0, crashViolations = 0;
+
+    int violations() const { return gapViolations + speedViolations + crashViolations; }
+};
+
+static void strike(HandTrack& h, int inst, double t, int measure, int row,
+                   const CheckConfig& cfg, SongReport& rep, const std::string& file) {
+    double gap = t - h.lastTime;
+    double d = dist(drumXYZ[h.lastInst], drumXYZ[inst]);
+
+    if (h.hasHit) {
+        if (gap < h.tightestGap) {
+            h.tightestGap = gap;
+            h.tightestMeasure = measure;
+            h.tightestRow = row;
+        }
+        if (gap < cfg.minGap - 1e-9) {
+            rep.gapViolations++;
+            if (!cfg.quiet)
+                std::cout << file << ": measure " << measure << " row " << row << " " << h.name
+                          << " 재타격 간격 " << gap << "s < " << cfg.minGap << "s ("
+                          << h.lastInst << "→" << inst << ")\n";
+        }
+    }
+
+    if (d > 0.0) {
+        // 간격 0 (같은 줄 안 이동 등)은 무한 속도로 간주
+        double speed = (gap > 1e-9) ? d / gap : 1e9;
+        if (speed > rep.peakSpeed) {
+            rep.peakSpeed = speed;
+            rep.peakMeasure = measure;
+            rep.peakRow = row;
+            rep.peakHand = h.name;
+        }
+        if (speed > cfg.maxSpeed) {
+            rep.speedViolations++;
+            if (!cfg.quiet)
+                std::cout << file << ": measure " << measure << " row " << row << " " << h.name
+                          << " 이동 속도 " << speed << "m/s > " << cfg.maxSpeed << "m/s ("
+                          << h.lastInst << "→" << inst << ", " << d << "m / " << gap << "s)\n";
+        }
+    }
+
+    h.lastInst = inst;
+    h.lastTime = t;
+    h.hasHit = true;
+    h.hits++;
+}
+
+// 반환값: 0 통과, 1 파일 오류, 2 위반 있음
+int checkScore(const std::string& file, const CheckConfig& cfg) {
+    std::ifstream in(file);
+    if (!in.is_open()) {
+        std::cerr << "입력 파일 열기 실패: " << file << "\n";
+        return 1;
+    }
+
+    HandTrack right, left;
+    right.name = "R";
+    left.name = "L";
+    SongReport rep;
+
+    std::cout << std::fixed << std::setprecision(3);
+
+    std::string line;
+    double t = 0.0;
+    int row = 0;
+    while (std::getline(in, line)) {
+        ++row;
+        const char* p = line.c_str();
+        char* end;
+        long measure = std::strtol(p, &end, 10);
+        if (end == p) continue;               // 빈 줄/형식 불량 스킵
+        if (measure == -1) break;             // 종료 줄
+        p = end;
+        double dt = std::strtod(p, &end);
+        if (end == p) continue;
+        p = end;
+        int col[6];
+        int n = 0;
+        for (; n < 6; ++n) {
+            col[n] = static_cast<int>(std::strtol(p, &end, 10));
+            if (end == p) break;
+            p = end;
+        }
+        if (n < 2) continue;
+
+        t += dt;
+        rep.rows++;
+        int R = col[0], L = col[1];
+        if (R < 0 || R >= NUM_INST || L < 0 || L >= NUM_INST) {
+            std::cerr << file << ": measure " << measure << " row " << row << " 알 수 없는 악기 번호\n";
+            continue;
+        }
+
+        if (R != 0) strike(right, R, t, (int)measure, row, cfg, rep, file);
+        if (L != 0) strike(left, L, t, (int)measure, row, cfg, rep, file);
+
+        if (!cfg.allowDualCrash && isCrash(R) && isCrash(L)) {
+            rep.crashViolations++;
+            if (!cfg.quiet)
+                std::cout << file << ": measure " << measure << " row " << row
+                          << " 양손 동시 크래시 (R=" << R << ", L=" << L << ")\n";
+        }
+    }
+    rep.duration = t;
+
+    // 곡 단위 요약
+    std::cout << "[요약] " << file << "\n"
+              << "  줄 수: " << rep.rows << ", 길이: " << rep.duration << "s"
+              << ", 타격 R/L: " << right.hits << "/" << left.hits << "\n"
+              << "  최대 요구 속도: " << rep.peakSpeed << "m/s (" << rep.peakHand
+              << ", measure " << rep.peakMeasure << " row " << rep.peakRow << ")\n";
+    for (const HandTrack* h : {&right, &left}) {
+        if (h->hits > 1)
+            std::cout << "  최소 간격 " << h->name << ": " << h->tightestGap << "s (measure "
+                      << h->tightestMeasure << " row " << h->tightestRow << ")\n";
+    }
+    std::cout << "  위반: 간격 " << rep.gapViolations << ", 속도 " << rep.speedViolations
+              << ", 동시 크래시 " << rep.crashViolations
+              << (rep.violations() ? "  → FAIL" : "  → OK") << "\n";
+
+    return rep.violations() ? 2 : 0;
+}
+
+int main(int argc, char** argv) {
+    std::ios::sync_with_stdio(false);
+
+    CheckConfig cfg;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        if (std::strncmp(a, "--min-gap=", 10) == 0) cfg.minGap = std::atof(a + 10);
+        else if (std::strncmp(a, "--vmax=", 7) == 0) cfg.maxSpeed = std::atof(a + 7);
+        else if (std::strcmp(a, "--allow-dual-crash") == 0) cfg.allowDualCrash = true;
+        else if (std::strcmp(a, "--quiet") == 0) cfg.quiet = true;
+        else files.push_back(a);
+    }
+
+    if (files.empty()) {
+        std::string file;
+        std::cout << "검사할 악보 파일 경로: ";
+        std::cin >> file;
+        files.push_back(file);
+    }
+
+    int result = 0;
+    int failed = 0;
+    for (const auto& f : files) {
+        int r = checkScore(f, cfg);
+        if (r != 0) failed++;
+        if (r > result) result = r;
+    }
+    if (files.size() > 1)
+        std::cout << "[전체] " << files.size() << "곡 중 " << failed << "곡 실패\n";
+    return result;
+}
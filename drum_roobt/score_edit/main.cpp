@@ -0,0 +1,133 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <iomanip>
+#include <cstring>
+
+#include "../common/incremental_score.hpp"
+
+// 마디 단위 악보 편집 (손 배정/마디 변환을 고친 부분만 다시 계산)
+//  - 곡의 output3_mc2c.csv(또는 전에 저장한 편집 이벤트 파일)를 읽어 최종 악보를 한 번 만들어 둠
+//  - 표준 입력 명령:
+//      measure N        다음 줄부터 "end" 까지 N 마디의 새 내용 (output6 형식 8열, 첫 열 마디 번호는 무시)
+//      show N           N 마디 현재 줄 출력
+//      save [파일]      최종 악보 저장 (+ 같은 이름 .events.csv 에 편집된 이벤트 저장 → 다음에 이 파일로 불러오기)
+//      quit
+//  - --check: 편집할 때마다 처음부터 다시 계산한 결과와 줄 단위로 비교 (다르면 종료 코드 2)
+//
+// 사용법: ./score_edit [--check] [--out=output6_final_x_edit.txt] output/x/output3_mc2c.csv < 편집명령.txt
+
+bool parseScoreRow(const std::string& line, ScoreRow& r) {
+    std::string_view f[8];
+    if (splitFields(line, f, 8) < 8) return false;
+    return toInt(f[0], r.measure) && toDouble(f[1], r.dt) && toInt(f[2], r.R) && toInt(f[3], r.L) &&
+           toInt(f[4], r.Rp) && toInt(f[5], r.Lp) && toInt(f[6], r.bass) && toInt(f[7], r.hihat);
+}
+
+std::string renderText(const IncrementalScore& s) {
+    std::ostringstream o;
+    s.writeRows(o);
+    return o.str();
+}
+
+int main(int argc, char** argv) {
+    std::ios::sync_with_stdio(false);
+
+    bool check = false;
+    std::string input, out;
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        if (std::strcmp(a, "--check") == 0) check = true;
+        else if (std::strncmp(a, "--out=", 6) == 0) out = a + 6;
+        else input = a;
+    }
+    if (input.empty()) {
+        std::cout << "output3_mc2c.csv 경로: ";
+        std::getline(std::cin, input);
+    }
+    if (out.empty()) {
+        size_t slash = input.find_last_of('/');
+        std::string dir = slash == std::string::npos ? "" : input.substr(0, slash + 1);
+        std::string stem = dir.empty() ? "score" : dir.substr(0, dir.size() - 1);
+        stem = stem.substr(stem.find_last_of('/') + 1);
+        out = dir + "output6_final_" + stem + "_edit.txt";
+    }
+
+    IncrementalScore score;
+    auto t0 = std::chrono::steady_clock::now();
+    if (!score.load(input)) return 1;
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "[불러옴] " << input << ": 이벤트 " << score.events().size() << "개, 줄 " << score.rows().size()
+              << "개, 마디 " << score.lastMeasure() << "개, 전체 계산 " << us << " us\n";
+
+    int result = 0;
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        std::istringstream cmd(line);
+        std::string op;
+        cmd >> op;
+        if (op.empty() || op[0] == '#') continue;
+        if (op == "quit") break;
+
+        if (op == "show") {
+            int m = 0;
+            cmd >> m;
+            std::cout << std::setprecision(3);
+            for (const auto& r : score.rows())
+                if (r.measure == m)
+                    std::cout << r.measure << "\t " << r.dt << "\t " << r.R << "\t " << r.L << "\t " << r.Rp << "\t "
+                              << r.Lp << "\t " << r.bass << "\t " << r.hihat << "\n";
+            std::cout << std::setprecision(1);
+        } else if (op == "save") {
+            std::string path = out;
+            cmd >> path;
+            if (!score.write(path) || !score.writeEvents(path + ".events.csv")) {
+                result = std::max(result, 1);
+                continue;
+            }
+            std::cout << "[저장] " << path << " (+ .events.csv)\n";
+        } else if (op == "measure") {
+            int m = 0;
+            cmd >> m;
+            std::vector<ScoreRow> rows;
+            bool bad = false;
+            while (std::getline(std::cin, line) && line.rfind("end", 0) != 0) {
+                ScoreRow r;
+                if (parseScoreRow(line, r)) rows.push_back(r);
+                else if (!line.empty()) bad = true;
+            }
+            if (bad) std::cerr << "[경고] 형식이 맞지 않는 줄은 건너뜀\n";
+
+            IncrementalScore::EditStats st;
+            std::string err;
+            t0 = std::chrono::steady_clock::now();
+            bool ok = score.editMeasure(m, rows, &st, err);
+            us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+            if (!ok) {
+                std::cerr << "[편집 실패] 마디 " << m << ": " << err << "\n";
+                result = std::max(result, 1);
+                continue;
+            }
+            std::cout << "[편집] 마디 " << m << ": 이벤트 " << st.reassigned << "개 다시 배정, 줄 " << st.rerendered
+                      << "개 다시 만듦" << (st.converged ? "" : " (곡 끝까지)")
+                      << (st.renumbered ? ", 이벤트 " + std::to_string(st.renumbered) + "개 마디 번호만 다시" : std::string())
+                      << (st.measureShift ? ", 뒤쪽 마디 번호 " + std::to_string(st.measureShift) : std::string())
+                      << ", " << us << " us\n";
+
+            if (check) {
+                IncrementalScore full;
+                full.build(score.events());
+                bool same = renderText(full) == renderText(score);
+                std::cout << "  [확인] 처음부터 다시 계산한 결과와 " << (same ? "같음" : "다름  → FAIL") << "\n";
+                if (!same) result = 2;
+            }
+        } else {
+            std::cerr << "알 수 없는 명령: " << op << "\n";
+        }
+    }
+    return result;
+}
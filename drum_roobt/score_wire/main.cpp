@@ -0,0 +1,201 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <iomanip>
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/socket.h>
+
+#include "../common/text_reader.hpp"
+#include "../common/score_wire.hpp"
+
+// 최종 악보 → 바이너리 프레임 인코딩 / 디코딩 시험
+//  - 텍스트 대비 줄당 바이트, 인코딩/디코딩 줄당 ns 측정
+//  - loopback: socketpair(기본) 또는 pty(--pty, 시리얼과 같은 raw 터미널) 로 조각조각 보내고
+//    받는 쪽에서 스트리밍 디코딩한 줄이 원본과 같은지 확인
+//  - --corrupt=p: 보내는 바이트를 확률 p 로 뒤집어서 CRC/재동기 동작 확인 (이때는 일치 검사 대신 손실 통계)
+//
+// 사용법: ./score_wire [--rows=32] [--chunk=64] [--pty] [--corrupt=0.001] output6_final_*.txt ...
+
+struct WireConfig {
+    int rowsPerFrame = 32;
+    size_t chunk = 64;          // 한 번에 write 하는 바이트 수 (시리얼 버퍼 흉내)
+    bool pty = false;
+    double corrupt = 0.0;
+};
+
+bool loadRows(const std::string& file, std::vector<WireRow>& rows, size_t& textBytes) {
+    TextReader in(file);
+    if (!in.is_open()) {
+        std::cerr << "입력 파일 열기 실패: " << file << "\n";
+        return false;
+    }
+    textBytes += in.size();
+    std::string_view line, f[8];
+    while (in.nextLine(line)) {
+        if (splitFields(line, f, 8) < 8) continue;
+        int v[8];
+        double dt;
+        if (!toInt(f[0], v[0]) || !toDouble(f[1], dt)) continue;
+        bool ok = true;
+        for (int i = 2; i < 8 && ok; ++i) ok = toInt(f[i], v[i]) && v[i] >= 0 && v[i] < 16;
+        if (!ok) continue;
+        rows.push_back({v[0], wireDtMs(dt), (uint8_t)v[2], (uint8_t)v[3], (uint8_t)v[4], (uint8_t)v[5],
+                        (uint8_t)v[6], (uint8_t)v[7]});
+    }
+    return true;
+}
+
+// 보내는 쪽 fd, 받는 쪽 fd 한 쌍. pty 는 raw 모드로 설정
+bool openLoopback(bool pty, int& wfd, int& rfd) {
+    if (!pty) {
+        int sv[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) < 0) return false;
+        wfd = sv[0];
+        rfd = sv[1];
+        return true;
+    }
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) < 0 || unlockpt(master) < 0) return false;
+    int slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+    if (slave < 0) return false;
+    termios tty;
+    for (int fd : {master, slave}) {
+        tcgetattr(fd, &tty);
+        cfmakeraw(&tty);
+        tcsetattr(fd, TCSANOW, &tty);
+    }
+    wfd = master;
+    rfd = slave;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::ios::sync_with_stdio(false);
+
+    WireConfig cfg;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        if (std::strncmp(a, "--rows=", 7) == 0) cfg.rowsPerFrame = std::atoi(a + 7);
+        else if (std::strncmp(a, "--chunk=", 8) == 0) cfg.chunk = std::max(1, std::atoi(a + 8));
+        else if (std::strncmp(a, "--corrupt=", 10) == 0) cfg.corrupt = std::atof(a + 10);
+        else if (std::strcmp(a, "--pty") == 0) cfg.pty = true;
+        else files.push_back(a);
+    }
+    if (files.empty()) {
+        std::string file;
+        std::cout << "악보 파일 경로: ";
+        std::cin >> file;
+        files.push_back(file);
+    }
+
+    std::vector<WireRow> rows;
+    size_t textBytes = 0;
+    for (const auto& f : files)
+        if (!loadRows(f, rows, textBytes)) return 1;
+    if (rows.empty()) {
+        std::cerr << "읽은 줄이 없음\n";
+        return 1;
+    }
+
+    using clk = std::chrono::steady_clock;
+    auto nsPerRow = [&](clk::time_point t0, size_t reps) {
+        return std::chrono::duration<double, std::nano>(clk::now() - t0).count() / (double(rows.size()) * reps);
+    };
+
+    // 1) 인코딩 (측정 시간이 너무 짧지 않게 반복)
+    std::vector<uint8_t> wire;
+    size_t reps = std::max<size_t>(1, 2000000 / rows.size());
+    auto t0 = clk::now();
+    for (size_t k = 0; k < reps; ++k) {
+        wire.clear();
+        WireEncoder enc(cfg.rowsPerFrame);
+        for (const auto& r : rows) enc.add(r, wire);
+        enc.flush(wire);
+    }
+    double encNs = nsPerRow(t0, reps);
+
+    // 2) 메모리 안 디코딩
+    volatile uint64_t sink = 0;   // 디코딩 루프가 최적화로 지워지지 않게
+    t0 = clk::now();
+    for (size_t k = 0; k < reps; ++k) {
+        WireDecoder dec;
+        dec.feed(wire.data(), wire.size(), [&](const WireRow& r) { sink = sink + r.dtMs; });
+    }
+    double decNs = nsPerRow(t0, reps);
+
+    // 3) loopback 으로 조각조각 보내고 스트리밍 디코딩
+    int wfd, rfd;
+    if (!openLoopback(cfg.pty, wfd, rfd)) {
+        std::cerr << "loopback 열기 실패: " << std::strerror(errno) << "\n";
+        return 1;
+    }
+    std::vector<uint8_t> sent = wire;
+    if (cfg.corrupt > 0) {
+        std::mt19937 rng(12345);
+        std::uniform_real_distribution<double> u(0.0, 1.0);
+        for (auto& b : sent)
+            if (u(rng) < cfg.corrupt) b ^= static_cast<uint8_t>(1u << (rng() % 8));
+    }
+
+    std::thread writer([&] {
+        for (size_t off = 0; off < sent.size(); off += cfg.chunk) {
+            size_t n = std::min(cfg.chunk, sent.size() - off);
+            const uint8_t* p = sent.data() + off;
+            while (n > 0) {
+                ssize_t w = write(wfd, p, n);
+                if (w < 0) {
+                    if (errno == EINTR || errno == EAGAIN) continue;
+                    return;
+                }
+                p += w;
+                n -= static_cast<size_t>(w);
+            }
+        }
+    });
+
+    WireDecoder dec;
+    std::vector<WireRow> got;
+    got.reserve(rows.size());
+    size_t received = 0;
+    uint8_t buf[4096];
+    t0 = clk::now();
+    while (received < sent.size()) {
+        ssize_t n = read(rfd, buf, sizeof(buf));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        received += static_cast<size_t>(n);
+        dec.feed(buf, static_cast<size_t>(n), [&](const WireRow& r) { got.push_back(r); });
+    }
+    double loopUs = std::chrono::duration<double, std::micro>(clk::now() - t0).count();
+    writer.join();
+    close(wfd);
+    close(rfd);
+
+    const auto& st = dec.stats();
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "[크기] 줄 " << rows.size() << "개, 텍스트 " << double(textBytes) / rows.size()
+              << " B/줄 → 바이너리 " << double(wire.size()) / rows.size() << " B/줄 ("
+              << double(wire.size()) * 100.0 / textBytes << "%), 프레임 " << st.frames + st.lostFrames << "개\n";
+    std::cout << "[속도] 인코딩 " << encNs << " ns/줄, 디코딩 " << decNs << " ns/줄 (반복 " << reps << "회)\n";
+    std::cout << "[loopback " << (cfg.pty ? "pty" : "socketpair") << "] " << received << " bytes, "
+              << loopUs << " us, 조각 " << cfg.chunk << " bytes\n";
+
+    if (cfg.corrupt > 0) {
+        std::cout << "[손상 " << std::defaultfloat << cfg.corrupt << std::fixed << "] 복구 줄 " << got.size() << "/" << rows.size()
+                  << ", CRC 오류 " << st.crcErrors << ", 잃은 프레임 " << st.lostFrames
+                  << ", 버린 바이트 " << st.skippedBytes << "\n";
+        return 0;
+    }
+    bool same = got == rows;
+    std::cout << "[검증] " << (same ? "원본과 일치" : "불일치!") << " (" << got.size() << "/" << rows.size() << "줄)\n";
+    return same ? 0 : 2;
+}
@@ -0,0 +1,139 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <iomanip>
+#include <cstdlib>
+#include <cstring>
+
+#include "../common/sensor_log.hpp"
+
+// IMU 로그 시각 범위 조회 (wit_sensor 가 쓰는 sensor_log.bin + .idx)
+//  - 시각: "12:03:41.5" (로그 첫 날짜 기준) 또는 "2025-11-12 12:03:41.5"
+//  - --around=시각 --window=초  → [시각 - 초, 시각 + 초]
+//  - 기본 출력은 예전 CSV 와 같은 형식 (Timestamp,Type,X,Y,Z) → 기존 파이썬 스크립트에 그대로 넣을 수 있음
+//  - --envelope=N: 범위를 N 구간으로 나눈 축별 min/max (그래프용, 점 수와 상관없이 종류마다 N 줄 이하)
+//    가속도/각속도/각도는 단위가 달라 섞지 않음 → --type 이 없으면 종류(A, G, E)마다 따로 구함
+//  - --import=sensor_log.csv: 예전 CSV 를 바이너리 로그 뒤에 붙임
+//  - --info: 블록/레코드 수, 시각 범위만 출력
+//
+// 사용법: ./sensor_query [--from=..] [--to=..] [--around=.. --window=2] [--type=A|G|E] [--envelope=800]
+//                        [--out=파일] [--import=sensor_log.csv] [--info] sensor_log.bin
+
+int importCsv(const std::string& csvPath, const std::string& logPath) {
+    SensorLogWriter w;
+    if (!w.open(logPath)) return 1;
+    long bad = readSensorCsv(csvPath, [&](const SensorRecord& r) { w.append(r); });
+    if (bad < 0) return 1;
+    w.close();
+    std::cout << "[가져오기] " << csvPath << " → " << logPath << ": 레코드 " << w.records() << "개, 블록 "
+              << w.blocks() << "개" << (bad ? ", 건너뛴 줄 " + std::to_string(bad) + "개" : std::string()) << "\n";
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    std::ios::sync_with_stdio(false);
+
+    std::string logPath, from, to, around, out, importPath;
+    double window = 2.0;
+    char type = 0;
+    int bins = 0;
+    bool info = false;
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        if (std::strncmp(a, "--from=", 7) == 0) from = a + 7;
+        else if (std::strncmp(a, "--to=", 5) == 0) to = a + 5;
+        else if (std::strncmp(a, "--around=", 9) == 0) around = a + 9;
+        else if (std::strncmp(a, "--window=", 9) == 0) window = std::atof(a + 9);
+        else if (std::strncmp(a, "--type=", 7) == 0) type = a[7];
+        else if (std::strncmp(a, "--envelope=", 11) == 0) bins = std::atoi(a + 11);
+        else if (std::strncmp(a, "--out=", 6) == 0) out = a + 6;
+        else if (std::strncmp(a, "--import=", 9) == 0) importPath = a + 9;
+        else if (std::strcmp(a, "--info") == 0) info = true;
+        else logPath = a;
+    }
+    if (logPath.empty()) {
+        std::cout << "센서 로그 경로 (sensor_log.bin): ";
+        std::getline(std::cin, logPath);
+    }
+    if (!importPath.empty()) return importCsv(importPath, logPath);
+
+    auto t0 = std::chrono::steady_clock::now();
+    SensorLogReader log;
+    if (!log.open(logPath)) return 1;
+    double openUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+    if (log.index().empty()) {
+        std::cerr << "빈 로그: " << logPath << "\n";
+        return 1;
+    }
+
+    std::cerr << std::fixed << std::setprecision(1);
+    if (info) {
+        std::cout << "[로그] " << logPath << ": 블록 " << log.index().size() << "개, 레코드 " << log.records() << "개, "
+                  << formatSensorTime(log.firstTime()) << " ~ " << formatSensorTime(log.lastTime())
+                  << (log.recoveredBlocks() ? ", 색인 없는 블록 " + std::to_string(log.recoveredBlocks()) + "개 복구" : std::string())
+                  << "\n";
+        return 0;
+    }
+
+    int64_t fromUs = log.firstTime(), toUs = log.lastTime();
+    const int64_t day = log.firstTime();
+    if (!around.empty()) {
+        int64_t c;
+        if (!parseSensorTime(around, c, day)) {
+            std::cerr << "시각 형식 오류: " << around << "\n";
+            return 1;
+        }
+        fromUs = c - static_cast<int64_t>(window * 1e6);
+        toUs = c + static_cast<int64_t>(window * 1e6);
+    }
+    if ((!from.empty() && !parseSensorTime(from, fromUs, day)) || (!to.empty() && !parseSensorTime(to, toUs, day))) {
+        std::cerr << "시각 형식 오류 (예: 12:03:41.5 또는 \"2025-11-12 12:03:41.5\")\n";
+        return 1;
+    }
+    if (toUs < fromUs) {
+        std::cerr << "범위 오류: 끝이 시작보다 앞섬\n";
+        return 1;
+    }
+
+    std::ofstream file;
+    if (!out.empty()) {
+        file.open(out, std::ios::trunc);
+        if (!file) {
+            std::cerr << "출력 파일 생성 실패: " << out << "\n";
+            return 1;
+        }
+    }
+    std::ostream& o = out.empty() ? std::cout : file;
+
+    t0 = std::chrono::steady_clock::now();
+    size_t k = 0;
+    if (bins > 0) {
+        std::vector<SensorEnvelopeBin> env;
+        const std::string types = type ? std::string(1, type) : std::string("AGE");
+        o << "Timestamp,Type,N,MinX,MaxX,MinY,MaxY,MinZ,MaxZ\n";
+        for (char t : types) {
+            log.envelope(fromUs, toUs, t, bins, env);
+            for (const auto& e : env) {
+                k += e.n;
+                if (e.n == 0) continue;
+                o << formatSensorTime(e.t0) << "," << t << "," << e.n;
+                for (int a = 0; a < 3; ++a) o << "," << e.min[a] << "," << e.max[a];
+                o << "\n";
+            }
+        }
+    } else {
+        o << "Timestamp,Type,X,Y,Z\n";
+        log.forEach(fromUs, toUs, [&](const SensorRecord& r) {
+            if (type && r.type != type) return;
+            o << formatSensorTime(r.tUs) << "," << r.type << "," << r.x << "," << r.y << "," << r.z << "\n";
+            ++k;
+        });
+    }
+    double queryUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+    std::cerr << "[요약] " << formatSensorTime(fromUs) << " ~ " << formatSensorTime(toUs) << ": 레코드 " << k << "개"
+              << (bins > 0 ? " → 구간 " + std::to_string(bins) + "개" : std::string()) << ", 블록 "
+              << log.index().size() << "개 중 검색, 열기 " << openUs << " us, 조회 " << queryUs << " us\n";
+    return 0;
+}
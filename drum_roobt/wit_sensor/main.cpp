@@ -6,6 +6,12 @@
 #include <iomanip>  // 시간 형식(put_time)
 #include <sstream>  // 문자열 스트림
 #include <thread>   // sleep_for
+#include <cstring>  // strcmp
+#include <csignal>  // Ctrl+C 로 루프 종료
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <pthread.h> // 기록 스레드 시그널 마스크
 
 // --- Linux 시리얼 통신 헤더 ---
 #include <fcntl.h>   // File control definitions
@@ -13,6 +19,10 @@
 #include <unistd.h>  // UNIX standard function definitions
 #include <errno.h>   // Error number definitions
 
+#include "../common/trace.hpp"
+#include "../common/sensor_log.hpp"
+#include "../common/imu_frame.hpp"
+
 // ==========================================================
 //                 ⚠️ 사용자 설정 변수 ⚠️
 // ==========================================================
@@ -20,49 +30,25 @@
 // 1. 실제 연결된 시리얼 포트 경로로 수정하세요.
 //    (터미널에서 'ls /dev/ttyUSB*' 또는 'dmesg | grep tty'로 확인)
 const std::string SERIAL_PORT = "/dev/ttyUSB0"; 
+const int SERIAL_BAUD = 9600;   // configureSerialPort 의 B9600 과 같게 (프레임 시각 계산에 사용)
 
 // 2. 센서에 설정된 실제 측정 범위로 수정하세요. (데이터 변환에 필수)
 //    (WitMotion 프로그램으로 확인 가능, 모를 경우 기본값 사용)
 const float ACC_RANGE_G = 16.0;      // 가속도 측정 범위 (기본값 예: 16g)
 const float GYRO_RANGE_DPS = 2000.0; // 각속도 측정 범위 (기본값 예: 2000°/s)
 
-// 3. 저장할 CSV 파일 이름
+// 3. 저장할 파일 이름
+//    블록+시각 색인 바이너리 로그 (sensor_query 로 시각 범위 조회) 와 예전 CSV 를 같이 씀 (--no-csv 면 CSV 는 안 씀)
+const std::string LOG_FILENAME = "sensor_log.bin";
 const std::string CSV_FILENAME = "sensor_log.csv";
 // ==========================================================
 
+// 패킷 → 프레임 묶기, 스레드 간 전달은 common/imu_frame.hpp (WitFrameAssembler, SpscRing)
+const size_t FRAME_QUEUE = 4096;   // 100Hz 기준 40초 분량
 
-// WitMotion 프로토콜 상수
-const unsigned char HEADER = 0x55;
-const unsigned char ACC_TAG = 0x51;  // 가속도
-const unsigned char GYRO_TAG = 0x52; // 각속도
-
-// 센서 데이터 저장을 위한 구조체
-struct SensorData {
-    std::string timestamp;
-    char dataType = 0; // 'A' (Accel) 또는 'G' (Gyro)
-    float x = 0.0, y = 0.0, z = 0.0;
-};
-
-// 현재 시간을 밀리초까지 포맷팅하여 반환
-std::string getTimestamp() {
-    auto now = std::chrono::system_clock::now();
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
-    std::time_t t = std::chrono::system_clock::to_time_t(now);
-    
-    std::tm tm_buf;
-    // 스레드 안전한 localtime_r 사용
-    localtime_r(&t, &tm_buf);
-
-    std::stringstream ss;
-    ss << std::put_time(&tm_buf, "%Y-%m-%d %H:%M:%S");
-    ss << '.' << std::setw(3) << std::setfill('0') << ms.count();
-    return ss.str();
-}
-
-// 16비트 부호 있는 정수(little-endian)로 변환
-short parseShort(unsigned char low, unsigned char high) {
-    return (short)((high << 8) | low);
-}
+// Ctrl+C 를 받으면 루프를 빠져나와 파일을 닫음 (SA_RESTART 없이 등록해 read() 대기도 깨움)
+volatile std::sig_atomic_t stopRequested = 0;
+void onSignal(int) { stopRequested = 1; }
 
 // 시리얼 포트 열기 및 설정
 int configureSerialPort(const std::string& port) {
@@ -130,80 +116,145 @@ int configureSerialPort(const std::string& port) {
     return fd;
 }
 
-// 패킷 파싱 및 데이터 변환
-bool parsePacket(const std::vector<unsigned char>& packet, SensorData& data) {
-    // 1. 체크섬 검증
-    unsigned char checksum = 0;
-    for (int i = 0; i < 10; ++i) {
-        checksum += packet[i];
-    }
-    if (checksum != packet[10]) {
-        std::cerr << "경고: 체크섬 오류" << std::endl;
-        return false;
-    }
 
-    // 2. 데이터 태그 확인
-    unsigned char tag = packet[1];
-    float scale;
-
-    if (tag == ACC_TAG) {
-        data.dataType = 'A'; // 가속도
-        scale = ACC_RANGE_G / 32768.0f;
-    } else if (tag == GYRO_TAG) {
-        data.dataType = 'G'; // 각속도
-        scale = GYRO_RANGE_DPS / 32768.0f;
-    } else {
-        return false; // 우리가 찾는 데이터가 아님 (예: 0x53 각도)
+// 실시간 타격 감지: |gyro| 가 thr 를 위로 넘는 순간 (refractory 동안 다시 세지 않음)
+struct OnsetDetector {
+    float thr = 0.0f;
+    int64_t refractoryUs = 80000;
+    int64_t lastUs = -1;
+    bool above = false;
+
+    bool update(const ImuFrame& f, float& mag) {
+        if (thr <= 0.0f || !(f.mask & IMU_HAS_GYRO)) return false;
+        mag = std::sqrt(f.gyro[0] * f.gyro[0] + f.gyro[1] * f.gyro[1] + f.gyro[2] * f.gyro[2]);
+        bool was = above;
+        above = mag >= thr;
+        if (!above || was || (lastUs >= 0 && f.tUs - lastUs < refractoryUs)) return false;
+        lastUs = f.tUs;
+        return true;
     }
+};
 
-    // 3. 데이터 파싱 (X, Y, Z 축)
-    data.x = parseShort(packet[2], packet[3]) * scale;
-    data.y = parseShort(packet[4], packet[5]) * scale;
-    data.z = parseShort(packet[6], packet[7]) * scale;
-    // (packet[8], packet[9]는 온도 또는 기타 데이터일 수 있으나 여기서는 무시)
-
-    return true;
-}
-
+// 사용법: ./main [--no-csv] [--log=sensor_log.bin] [--onset=300] [--quiet]
+//   --no-csv     sensor_log.csv 를 쓰지 않음 (바이너리 로그만)
+//   --onset=thr  |gyro| 가 thr(deg/s) 를 넘으면 [타격] 출력 (0 이면 끔)
+//   --quiet      프레임마다 터미널 출력하지 않음
+int main(int argc, char** argv) {
+    bool writeCsv = true, quiet = false;
+    std::string logPath = LOG_FILENAME;
+    OnsetDetector onset;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--no-csv") == 0) writeCsv = false;
+        else if (std::strcmp(argv[i], "--csv") == 0) writeCsv = true;   // 예전 옵션 (기본값과 같음)
+        else if (std::strcmp(argv[i], "--quiet") == 0) quiet = true;
+        else if (std::strncmp(argv[i], "--log=", 6) == 0) logPath = argv[i] + 6;
+        else if (std::strncmp(argv[i], "--onset=", 8) == 0) onset.thr = std::atof(argv[i] + 8);
+    }
 
-int main() {
     int serial_fd = configureSerialPort(SERIAL_PORT);
     if (serial_fd < 0) {
         return 1;
     }
 
+    SensorLogWriter log;
+    if (!log.open(logPath)) {
+        close(serial_fd);
+        return 1;
+    }
+
     std::ofstream csvFile;
     // 파일 존재 여부 및 크기 확인
     bool file_exists = std::ifstream(CSV_FILENAME).good();
     
     // 파일 열기 (기존 내용에 이어 쓰기 모드)
-    csvFile.open(CSV_FILENAME, std::ios::out | std::ios::app);
-    if (!csvFile.is_open()) {
+    if (writeCsv) csvFile.open(CSV_FILENAME, std::ios::out | std::ios::app);
+    if (writeCsv && !csvFile.is_open()) {
         std::cerr << "오류: CSV 파일 열기 실패 (" << CSV_FILENAME << ")" << std::endl;
         close(serial_fd);
         return 1;
     }
 
-    // --- 🚨 디버깅된 헤더 작성 로직 🚨 ---
     // 파일이 새로 생성되었거나 비어있는 경우에만 헤더 작성
-    if (!file_exists || csvFile.tellp() == 0) {
+    if (writeCsv && (!file_exists || csvFile.tellp() == 0)) {
         csvFile << "Timestamp,Type,X,Y,Z\n";
         csvFile.flush(); // 즉시 파일에 쓰도록 버퍼 비우기
         std::cout << "✅ CSV 헤더 작성 완료." << std::endl;
     }
-    // ----------------------------------------
 
     std::cout << "센서 데이터 수신 및 로깅 시작... (Ctrl+C로 종료)" << std::endl;
-    std::cout << "포트: " << SERIAL_PORT << ", 파일: " << CSV_FILENAME << std::endl;
+    std::cout << "포트: " << SERIAL_PORT << ", 파일: " << logPath << (writeCsv ? ", " + CSV_FILENAME : std::string())
+              << std::endl;
+
+    struct sigaction sa {};
+    sa.sa_handler = onSignal;
+    sigaction(SIGINT, &sa, nullptr);
+    sigaction(SIGTERM, &sa, nullptr);
+
+    // 읽는 스레드(이 스레드) → 프레임 링 → 기록 스레드
+    // 기록 스레드는 시그널을 막아 두어 Ctrl+C 가 항상 read() 에서 기다리는 이 스레드를 깨우게 함
+    SpscRing<ImuFrame, FRAME_QUEUE> ring;
+    std::atomic<bool> readerDone{false};
+    long dropped = 0, strokes = 0;
+
+    sigset_t block, old;
+    sigemptyset(&block);
+    sigaddset(&block, SIGINT);
+    sigaddset(&block, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &block, &old);
+    std::thread writer([&] {
+        TRACE_THREAD("writer");
+        ImuFrame f;
+        while (true) {
+            if (!ring.pop(f)) {
+                if (readerDone.load(std::memory_order_acquire) && ring.size() == 0) break;
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+            TRACE_ZONE("frame");
+            float mag = 0.0f;
+            if (onset.update(f, mag)) {
+                ++strokes;
+                std::cout << "[타격] " << formatSensorTime(f.tUs) << " |gyro| " << mag << std::endl;
+            }
 
-    // ... (이후 시리얼 통신 및 데이터 처리 로직은 동일)
+            // 바이너리 로그 (프레임 하나 = 같은 시각의 A/G/E 레코드, 1초/4096개마다 블록 단위로 기록)
+            appendFrame(log, f);
 
-    std::vector<unsigned char> buffer;
-    unsigned char byte_buffer[1];
+            std::string timestamp = formatSensorTime(f.tUs);
+            if (writeCsv) {
+                if (f.mask & IMU_HAS_ACC)
+                    csvFile << timestamp << ",A," << f.acc[0] << "," << f.acc[1] << "," << f.acc[2] << "\n";
+                if (f.mask & IMU_HAS_GYRO)
+                    csvFile << timestamp << ",G," << f.gyro[0] << "," << f.gyro[1] << "," << f.gyro[2] << "\n";
+                csvFile.flush();
+            }
 
-    while (true) {
-        // 1. 시리얼 포트에서 1바이트 읽기
-        int n = read(serial_fd, byte_buffer, 1);
+            // (선택 사항) 터미널에도 출력
+            if (!quiet) {
+                std::cout << timestamp << " | #" << f.seq
+                          << " | A " << std::setw(8) << f.acc[0] << std::setw(9) << f.acc[1] << std::setw(9) << f.acc[2]
+                          << " | G " << std::setw(8) << f.gyro[0] << std::setw(9) << f.gyro[1] << std::setw(9) << f.gyro[2];
+                if (f.mask & IMU_HAS_ANGLE)
+                    std::cout << " | E " << std::setw(8) << f.angle[0] << std::setw(9) << f.angle[1] << std::setw(9) << f.angle[2];
+                std::cout << std::endl;
+            }
+        }
+    });
+    pthread_sigmask(SIG_SETMASK, &old, nullptr);
+
+    WitScale scale;
+    scale.acc = ACC_RANGE_G;
+    scale.gyro = GYRO_RANGE_DPS;
+    WitFrameAssembler assembler(scale);
+    assembler.setBaud(SERIAL_BAUD);   // 한 번에 읽은 여러 프레임이 같은 시각이 되지 않게 바이트 위치로 시각 보정
+    auto push = [&](const ImuFrame& f) {
+        if (!ring.push(f)) ++dropped;   // 기록 스레드가 밀리면 가장 새 프레임을 버림 (읽기는 막지 않음)
+    };
+    unsigned char readBuf[256];
+
+    while (!stopRequested) {
+        // 1. 시리얼 포트에서 와 있는 만큼 읽기 (최소 1바이트 올 때까지 대기)
+        int n = read(serial_fd, readBuf, sizeof(readBuf));
 
         if (n < 0) {
             // Error handling (N < 0)
@@ -217,45 +268,22 @@ int main() {
             continue;
         }
 
-        // 2. 패킷 시작(HEADER) 찾기
-        if (buffer.empty() && byte_buffer[0] != HEADER) {
-            continue; 
-        }
-
-        buffer.push_back(byte_buffer[0]);
-
-        // 3. 패킷 11바이트 수집
-        if (buffer.size() == 11) {
-            if (buffer[0] == HEADER) {
-                SensorData data;
-                if (parsePacket(buffer, data)) {
-                    // 4. 유효한 데이터(가속도/각속도)인 경우
-                    data.timestamp = getTimestamp();
-
-                    // CSV 파일에 쓰기
-                    csvFile << data.timestamp << ","
-                            << data.dataType << ","
-                            << data.x << ","
-                            << data.y << ","
-                            << data.z << "\n";
-                    
-                    // 데이터 버퍼 비우기 (데이터 손실 방지)
-                    csvFile.flush();
-                    
-                    // (선택 사항) 터미널에도 출력
-                    std::cout << data.timestamp << " | " << data.dataType
-                              << " | X: " << std::setw(8) << data.x
-                              << " | Y: " << std::setw(8) << data.y
-                              << " | Z: " << std::setw(8) << data.z << std::endl;
-                }
-            }
-            // 패킷 처리가 끝났으므로 버퍼 비우기
-            buffer.clear();
-        }
+        // 2. 패킷 동기/체크섬 → 같은 주기 패킷을 프레임으로 묶어 링에 넣음
+        TRACE_ZONE("feed");
+        assembler.feed(readBuf, static_cast<size_t>(n), sensorNowUs(), push);
     }
-
-    std::cout << "로깅 종료." << std::endl;
+    assembler.finish(push);
+    readerDone.store(true, std::memory_order_release);
+    writer.join();
+
+    const auto& st = assembler.stats();
+    std::cout << "로깅 종료. (패킷 " << st.packets << "개, 체크섬 오류 " << st.badChecksum << "개, 프레임 " << st.frames
+              << "개, 불완전 " << st.partial << "개, 버림 " << dropped << "개"
+              << (onset.thr > 0 ? ", 타격 " + std::to_string(strokes) + "개" : std::string()) << ")" << std::endl;
+    TRACE_DUMP("wit_sensor_trace.json");
+    log.close();
+    std::cout << "[로그] " << logPath << ": 레코드 " << log.records() << "개, 블록 " << log.blocks() << "개" << std::endl;
     csvFile.close();
     close(serial_fd);
     return 0;
-}
\ No newline at end of file
+}